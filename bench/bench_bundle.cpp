@@ -0,0 +1,138 @@
+// bench_bundle.cpp - loading many tiny programs from loose .qbin files versus one QBND bundle
+//
+// Usage: bench_bundle [files=20000] [lookups=100000]
+//
+// Compiles `files` small random circuits, writes them once as loose files in
+// a temporary directory and once as a bundle, then loads `lookups` random
+// programs by name through each (read the file, or find() in the mapped
+// bundle) and decodes their INST in place. Open + read is per lookup for
+// loose files; the bundle is opened once. Page cache is warm in both cases.
+
+#include "qbin_bundle/bundle.hpp"
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_decompiler/section_reader.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static std::string make_program(int qubits, int gates, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+    std::uniform_int_distribution<int> pick(0, qubits - 1);
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\n\n";
+    for (int g = 0; g < gates; ++g) {
+        const int a = pick(rng);
+        int b = pick(rng);
+        if (b == a) b = (a + 1) % qubits;
+        switch (g % 3) {
+        case 0: q << "h q[" << a << "];\n"; break;
+        case 1: q << "rz(" << angle(rng) << ") q[" << a << "];\n"; break;
+        default: q << "cx q[" << a << "], q[" << b << "];\n"; break;
+        }
+    }
+    return q.str();
+}
+
+static bool decode(const uint8_t* b, size_t n, size_t& instrs) {
+    qbin_decompiler::SectionReader r;
+    const std::vector<qbin_decompiler::DecodedInstr>* out = nullptr;
+    std::string err;
+    if (!r.open(b, n, err) || !r.instrs(out, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return false; }
+    instrs += out->size();
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const size_t files = argc > 1 ? size_t(std::max(1, std::atoi(argv[1]))) : 20000;
+    const size_t lookups = argc > 2 ? size_t(std::max(1, std::atoi(argv[2]))) : 100000;
+
+    fs::path dir = fs::temp_directory_path() / "qbin_bench_bundle";
+    fs::remove_all(dir);
+    fs::create_directories(dir / "loose");
+
+    // 64 distinct programs under `files` names (shared contents are stored once)
+    std::vector<std::vector<uint8_t>> programs;
+    qbin_compiler::CompileOptions copts;
+    copts.opt_level = 1;
+    for (unsigned s = 0; s < 64; ++s) programs.push_back(qbin_compiler::compile_qasm_to_qbin(make_program(6, 24, 500 + s), copts));
+
+    std::vector<std::string> names(files);
+    std::vector<qbin_bundle::BundleInput> inputs(files);
+    uint64_t loose_bytes = 0;
+    for (size_t i = 0; i < files; ++i) {
+        names[i] = "c" + std::to_string(i % 100) + "/p" + std::to_string(i) + ".qbin";
+        const auto& p = programs[i % programs.size()];
+        fs::create_directories((dir / "loose" / names[i]).parent_path());
+        std::ofstream(dir / "loose" / names[i], std::ios::binary)
+            .write(reinterpret_cast<const char*>(p.data()), std::streamsize(p.size()));
+        inputs[i] = { names[i], p.data(), p.size() };
+        loose_bytes += p.size();
+    }
+    std::vector<uint8_t> packed;
+    std::string err;
+    qbin_bundle::PackStats ps;
+    if (!qbin_bundle::pack_bundle(inputs, packed, err, &ps)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    const std::string bundle_path = (dir / "all.qbnd").string();
+    std::ofstream(bundle_path, std::ios::binary).write(reinterpret_cast<const char*>(packed.data()), std::streamsize(packed.size()));
+    std::printf("%zu programs: %llu bytes loose, %llu bytes bundled (%zu images stored)\n\n", files,
+        (unsigned long long)loose_bytes, (unsigned long long)ps.bundle_bytes, ps.unique_images);
+
+    std::mt19937 rng(7);
+    std::vector<size_t> order(lookups);
+    for (auto& k : order) k = rng() % files;
+
+    size_t instrs_loose = 0, instrs_bundle = 0;
+    {
+        auto t0 = Clock::now();
+        std::vector<uint8_t> buf;
+        for (size_t k : order) {
+            std::ifstream f(dir / "loose" / names[k], std::ios::binary);
+            buf.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+            if (!decode(buf.data(), buf.size(), instrs_loose)) return 1;
+        }
+        const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::printf("loose files   %9.0f programs/s  %7.2f us/program\n", lookups / secs, secs * 1e6 / lookups);
+    }
+    {
+        auto t0 = Clock::now();
+        qbin_bundle::Bundle b;
+        if (!b.open(bundle_path, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+        const double open_us = std::chrono::duration<double, std::micro>(Clock::now() - t0).count();
+        for (size_t k : order) {
+            qbin_bundle::BundleImage img;
+            if (!b.find(names[k], img, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+            if (!decode(img.data, img.size, instrs_bundle)) return 1;
+        }
+        const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::printf("bundle        %9.0f programs/s  %7.2f us/program  (open %.1f us)\n",
+            lookups / secs, secs * 1e6 / lookups, open_us);
+
+        // Lookup alone
+        t0 = Clock::now();
+        size_t bytes = 0;
+        for (size_t k : order) {
+            qbin_bundle::BundleImage img;
+            if (!b.find(names[k], img, err)) return 1;
+            bytes += img.size;
+        }
+        const double lsecs = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::printf("bundle find   %9.0f lookups/s   %7.3f us/lookup (%zu bytes)\n", lookups / lsecs, lsecs * 1e6 / lookups, bytes);
+    }
+    if (instrs_loose != instrs_bundle) { std::fprintf(stderr, "instruction counts differ\n"); return 1; }
+    fs::remove_all(dir);
+    return 0;
+}
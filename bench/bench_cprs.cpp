@@ -0,0 +1,190 @@
+// bench_cprs.cpp - section compression on a corpus of small circuits
+//
+// Usage: bench_cprs [files=2000] [dict_bytes=16384] [reps=5]
+//
+// Generates `files` small programs (GHZ/Bell preparation, QAOA layers and
+// random Clifford+T/rotation circuits, 3-16 qubits, 20-400 gates), compiles
+// them with each encoding below, and reports the total size of the second
+// half of the corpus (the first half trains the dictionary) and the time to
+// decode_program() one file:
+//   raw            plain INST (the default)
+//   delta          --delta-operands
+//   zstd           --compress
+//   zstd+delta     --compress --delta-operands
+//   dict           --compress --dict (shared dictionary, trained without delta)
+//   dict+delta     --compress --dict --delta-operands
+//   embedded+delta --embed-dict: the dictionary travels in every file
+// Every encoding must decompile to the same text as raw.
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_compiler/compress.hpp"
+#include "qbin_decompiler/compression.hpp"
+#include "qbin_decompiler/decompiler.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::string make_circuit(std::mt19937& rng) {
+    std::uniform_int_distribution<int> fam(0, 2), nq(3, 16);
+    const int qubits = nq(rng);
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\nbit[" << qubits << "] c;\n\n";
+    switch (fam(rng)) {
+    case 0: {   // GHZ / Bell-type preparation
+        q << "h q[0];\n";
+        for (int i = 0; i + 1 < qubits; ++i) q << "cx q[" << i << "], q[" << i + 1 << "];\n";
+        break;
+    }
+    case 1: {   // QAOA on a ring, a few layers with per-layer angles
+        std::uniform_int_distribution<int> layers(1, 6);
+        std::uniform_real_distribution<float> ang(-3.0f, 3.0f);
+        for (int i = 0; i < qubits; ++i) q << "h q[" << i << "];\n";
+        for (int l = layers(rng); l > 0; --l) {
+            const float gamma = ang(rng), beta = ang(rng);
+            for (int i = 0; i < qubits; ++i) q << "rzz(" << gamma << ") q[" << i << "], q[" << (i + 1) % qubits << "];\n";
+            for (int i = 0; i < qubits; ++i) q << "rx(" << beta << ") q[" << i << "];\n";
+        }
+        break;
+    }
+    default: {  // random gates from a small basis, angles on a pi/8 grid
+        static const char* one[] = { "h", "s", "sdg", "t", "tdg", "x", "sx" };
+        static const char* rot[] = { "rx", "ry", "rz" };
+        std::uniform_int_distribution<int> gates(20, 400), kind(0, 9), g1(0, 6), gr(0, 2), grid(-8, 7);
+        std::uniform_int_distribution<int> qd(0, qubits - 1);
+        for (int g = gates(rng); g > 0; --g) {
+            const int k = kind(rng), a = qd(rng);
+            if (k < 5) q << one[g1(rng)] << " q[" << a << "];\n";
+            else if (k < 7) q << rot[gr(rng)] << "(" << 0.392699082f * float(grid(rng)) << ") q[" << a << "];\n";
+            else {
+                int b = qd(rng);
+                if (b == a) b = (a + 1) % qubits;
+                q << "cx q[" << a << "], q[" << b << "];\n";
+            }
+        }
+        break;
+    }
+    }
+    for (int i = 0; i < qubits; ++i) q << "c[" << i << "] = measure q[" << i << "];\n";
+    return q.str();
+}
+
+struct Mode {
+    const char* name;
+    bool delta;
+    bool compress;
+    bool dict;
+    bool embed;
+};
+
+int main(int argc, char** argv) {
+    const int files = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const size_t dict_bytes = argc > 2 ? size_t(std::atoi(argv[2])) : 16384;
+    const int reps = argc > 3 ? std::atoi(argv[3]) : 5;
+    const bool zstd = qbin_compiler::enc::zstd_available() && qbin_decompiler::zstd_available();
+
+    std::mt19937 rng(1234);
+    std::vector<std::string> corpus;
+    for (int k = 0; k < files; ++k) corpus.push_back(make_circuit(rng));
+    const size_t train_n = corpus.size() / 2;
+
+    // Dictionaries from the training half, with and without delta coding
+    std::vector<uint8_t> dict_plain, dict_delta;
+    if (zstd) {
+        for (bool delta : { false, true }) {
+            std::vector<std::vector<uint8_t>> samples;
+            qbin_compiler::CompileOptions o;
+            o.delta_operands = delta;
+            for (size_t k = 0; k < train_n; ++k) {
+                const std::vector<uint8_t> f = qbin_compiler::compile_qasm_to_qbin(corpus[k], o);
+                uint8_t major, minor;
+                uint32_t toff, tsize;
+                std::vector<qbin_decompiler::SectionEntry> table;
+                std::string err;
+                qbin_decompiler::decode_header_and_table(f.data(), f.size(), major, minor, toff, tsize, table, err);
+                for (const auto& e : table) samples.emplace_back(f.begin() + e.offset, f.begin() + e.offset + e.size);
+            }
+            std::string err;
+            if (!qbin_compiler::enc::train_dictionary(samples, dict_bytes, delta ? dict_delta : dict_plain, err)) {
+                std::fprintf(stderr, "%s\n", err.c_str());
+                return 1;
+            }
+        }
+    }
+    qbin_decompiler::DictionarySet dicts;
+    std::string err;
+    if (zstd && (!dicts.add(dict_plain, err) || !dicts.add(dict_delta, err))) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return 1;
+    }
+
+    const Mode modes[] = {
+        { "raw", false, false, false, false },
+        { "delta", true, false, false, false },
+        { "zstd", false, true, false, false },
+        { "zstd+delta", true, true, false, false },
+        { "dict", false, true, true, false },
+        { "dict+delta", true, true, true, false },
+        { "embedded+delta", true, true, true, true },
+    };
+
+    std::vector<std::string> reference;
+    size_t raw_bytes = 0;
+    const size_t eval_n = corpus.size() - train_n;
+    std::printf("%d circuits: %zu train the %zu-byte dictionaries, %zu measured\n",
+        files, train_n, zstd ? dict_delta.size() : size_t(0), eval_n);
+    std::printf("%-16s %10s %10s %8s %12s\n", "encoding", "bytes", "bytes/file", "ratio", "decode us");
+    bool same = true;
+    for (const Mode& m : modes) {
+        if (m.compress && !zstd) {
+            std::printf("%-16s %10s\n", m.name, "(no zstd)");
+            continue;
+        }
+        qbin_compiler::CompileOptions o;
+        o.delta_operands = m.delta;
+        o.compress_level = m.compress ? 19 : 0;
+        o.dict = m.dict ? (m.delta ? &dict_delta : &dict_plain) : nullptr;
+        o.embed_dict = m.embed;
+        std::vector<std::vector<uint8_t>> out;
+        size_t bytes = 0;
+        for (size_t k = train_n; k < corpus.size(); ++k) {
+            out.push_back(qbin_compiler::compile_qasm_to_qbin(corpus[k], o));
+            bytes += out.back().size();
+        }
+        if (!m.compress && !m.delta) raw_bytes = bytes;
+
+        qbin_decompiler::DecodedProgram prog;
+        for (const auto& f : out) {   // warm-up
+            if (!qbin_decompiler::decode_program(f.data(), f.size(), prog, err, false, &dicts)) {
+                std::fprintf(stderr, "%s: %s\n", m.name, err.c_str());
+                return 1;
+            }
+        }
+        const auto t0 = std::chrono::steady_clock::now();
+        for (int r = 0; r < reps; ++r) {
+            for (const auto& f : out) qbin_decompiler::decode_program(f.data(), f.size(), prog, err, false, &dicts);
+        }
+        const auto t1 = std::chrono::steady_clock::now();
+        const double us = std::chrono::duration<double, std::micro>(t1 - t0).count() / (double(reps) * double(out.size()));
+
+        qbin_decompiler::DecompileOptions dopts;
+        dopts.dicts = &dicts;
+        for (size_t k = 0; k < out.size(); ++k) {
+            std::string qasm;
+            if (!qbin_decompiler::decode_qbin_to_qasm(out[k], qasm, err, dopts)) { same = false; continue; }
+            if (reference.size() < out.size()) reference.push_back(qasm);
+            else if (reference[k] != qasm) same = false;
+        }
+        std::printf("%-16s %10zu %10.1f %7.2fx %12.2f\n", m.name, bytes, double(bytes) / double(out.size()),
+            double(raw_bytes) / double(bytes), us);
+    }
+    std::printf("header + table share of raw: %.1f%%; all encodings decompile alike: %s\n",
+        100.0 * double(eval_n * 40) / double(raw_bytes), same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
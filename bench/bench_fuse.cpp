@@ -0,0 +1,128 @@
+// bench_fuse.cpp - single-qubit fusion (--fuse-1q): instruction count and
+// simulation time
+//
+// Usage: bench_fuse [qubits=20] [layers=20] [run_len=4] [reps=3]
+//
+// Builds a transpiled-style circuit: every layer puts a run of `run_len`
+// random single-qubit gates (H, S, T, SX, RX, RY, RZ) on each qubit, then a
+// CX brickwork, and finally measures all qubits. Compiles it with -O1 and
+// with -O1 --fuse-1q, and reports instructions, file size, and the time
+// qbin-run's executor needs to decode and simulate each file. Also checks
+// that both files prepare the same state (up to global phase); their counts
+// may differ in a few shots, since the fused amplitudes differ in the last
+// float bits.
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_decompiler/reader.hpp"
+#include "qbin_runner/executor.hpp"
+#include "qbin_runner/statevector.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::string make_circuit(int qubits, int layers, int run_len) {
+    static const char* const kFixed[] = { "h", "s", "t", "sx" };
+    static const char* const kRot[] = { "rx", "ry", "rz" };
+    std::mt19937 rng(11);
+    std::uniform_int_distribution<int> pick(0, 6);
+    std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\nbit[" << qubits << "] c;\n\n";
+    for (int l = 0; l < layers; ++l) {
+        for (int i = 0; i < qubits; ++i) {
+            for (int k = 0; k < run_len; ++k) {
+                const int g = pick(rng);
+                if (g < 4) q << kFixed[g] << " q[" << i << "];\n";
+                else q << kRot[g - 4] << "(" << angle(rng) << ") q[" << i << "];\n";
+            }
+        }
+        for (int i = l % 2; i + 1 < qubits; i += 2) q << "cx q[" << i << "], q[" << i + 1 << "];\n";
+    }
+    for (int i = 0; i < qubits; ++i) q << "c[" << i << "] = measure q[" << i << "];\n";
+    return q.str();
+}
+
+struct Result {
+    size_t instrs = 0;
+    size_t bytes = 0;
+    double ms = 0.0;
+    qbin_runner::StateVector state;     // before the measurements
+};
+
+static bool measure(const std::string& qasm, bool fuse, int reps, Result& r) {
+    qbin_compiler::CompileOptions o;
+    o.opt_level = 1;
+    o.fuse_1q = fuse;
+    qbin_compiler::CompileStats st;
+    const std::vector<uint8_t> file = qbin_compiler::compile_qasm_to_qbin(qasm, o, &st);
+    r.instrs = st.instrs_out;
+    r.bytes = file.size();
+
+    qbin_runner::RunOptions ro;
+    ro.seed = 7;
+    std::string err;
+    double best = 0.0;
+    for (int k = 0; k < reps; ++k) {
+        auto t0 = std::chrono::steady_clock::now();
+        qbin_decompiler::DecodedProgram prog;
+        qbin_runner::RunResult out;
+        if (!qbin_decompiler::decode_program(file.data(), file.size(), prog, err) ||
+            !qbin_runner::run_program(prog, ro, out, err)) {
+            std::fprintf(stderr, "run failed: %s\n", err.c_str());
+            return false;
+        }
+        const double ms = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - t0).count();
+        if (k == 0 || ms < best) best = ms;
+    }
+    r.ms = best;
+
+    qbin_decompiler::DecodedProgram prog;
+    if (!qbin_decompiler::decode_program(file.data(), file.size(), prog, err) ||
+        !r.state.init(unsigned(prog.qubits.count), err)) {
+        std::fprintf(stderr, "%s\n", err.c_str());
+        return false;
+    }
+    for (const auto& di : prog.instrs) {
+        if (di.opcode == 0x30) continue;    // MEASURE
+        if (!qbin_runner::apply_gate(r.state, di, err)) {
+            std::fprintf(stderr, "%s\n", err.c_str());
+            return false;
+        }
+    }
+    return true;
+}
+
+int main(int argc, char** argv) {
+    const int qubits = argc > 1 ? std::atoi(argv[1]) : 20;
+    const int layers = argc > 2 ? std::atoi(argv[2]) : 20;
+    const int run_len = argc > 3 ? std::atoi(argv[3]) : 4;
+    const int reps = argc > 4 ? std::atoi(argv[4]) : 3;
+
+    const std::string qasm = make_circuit(qubits, layers, run_len);
+    Result plain, fused;
+    if (!measure(qasm, false, reps, plain) || !measure(qasm, true, reps, fused)) return 1;
+
+    std::printf("%d qubits, %d layers, runs of %d single-qubit gates\n", qubits, layers, run_len);
+    std::printf("%-14s %10s %10s %12s\n", "", "instrs", "bytes", "decode+run ms");
+    std::printf("%-14s %10zu %10zu %12.2f\n", "-O1", plain.instrs, plain.bytes, plain.ms);
+    std::printf("%-14s %10zu %10zu %12.2f\n", "-O1 --fuse-1q", fused.instrs, fused.bytes, fused.ms);
+    std::printf("instructions: %.2fx fewer, simulation: %.2fx faster\n",
+        double(plain.instrs) / double(fused.instrs), plain.ms / fused.ms);
+
+    std::complex<double> overlap = 0.0;
+    for (size_t i = 0; i < plain.state.size(); ++i) overlap += std::conj(plain.state.data()[i]) * fused.state.data()[i];
+    std::printf("state fidelity: %.9f\n", std::norm(overlap));
+    if (std::fabs(std::norm(overlap) - 1.0) > 1e-4) {
+        std::fprintf(stderr, "the fused program prepares a different state\n");
+        return 1;
+    }
+    return 0;
+}
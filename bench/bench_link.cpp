@@ -0,0 +1,119 @@
+// bench_link.cpp - qbin-link versus decompile + concatenate + recompile
+//
+// Usage: bench_link [layers=2000] [qubits=16] [reps=5]
+//
+// Compiles three parts (state prep, body, readout) of `layers` rotation/CX
+// layers each and joins them three ways:
+//   text:    decompile each part, concatenate the statements, compile again
+//   link:    link_qbin without offsets (records copied with memcpy)
+//   shifted: link_qbin with qubit/bit offsets on the later parts (records
+//            walked and renumbered)
+// A plain memcpy of the input files is printed as the lower bound. The linked
+// outputs must decompile to the same text as the text path (offsets aside).
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_decompiler/decompiler.hpp"
+#include "qbin_linker/linker.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::string make_part(int qubits, int layers, unsigned seed, bool measure) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\nbit[" << qubits << "] c;\n\n";
+    for (int l = 0; l < layers; ++l) {
+        for (int i = 0; i < qubits; ++i) q << "ry(" << dist(rng) << ") q[" << i << "];\n";
+        for (int i = 0; i + 1 < qubits; ++i) q << "cx q[" << i << "], q[" << i + 1 << "];\n";
+    }
+    if (measure) {
+        for (int i = 0; i < qubits; ++i) q << "c[" << i << "] = measure q[" << i << "];\n";
+    }
+    return q.str();
+}
+
+// Statements of a decompiled program (everything after the first blank line).
+static std::string body_of(const std::string& qasm) {
+    const size_t p = qasm.find("\n\n");
+    return p == std::string::npos ? std::string() : qasm.substr(p + 2);
+}
+
+template <class Fn>
+static double time_ms(int reps, Fn&& fn) {
+    fn();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / reps;
+}
+
+int main(int argc, char** argv) {
+    const int layers = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int qubits = argc > 2 ? std::atoi(argv[2]) : 16;
+    const int reps = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    std::vector<std::vector<uint8_t>> parts;
+    for (unsigned k = 0; k < 3; ++k) {
+        parts.push_back(qbin_compiler::compile_qasm_to_qbin_min(make_part(qubits, layers, 11u + k, k == 2), false));
+    }
+    size_t in_bytes = 0;
+    for (const auto& p : parts) in_bytes += p.size();
+
+    std::string err;
+    std::vector<uint8_t> text_out, link_out, shifted_out;
+    const double ms_text = time_ms(reps, [&] {
+        std::string joined = "OPENQASM 3.0;\nqubit[" + std::to_string(qubits) + "] q;\nbit[" +
+            std::to_string(qubits) + "] c;\n\n";
+        for (const auto& p : parts) {
+            std::string qasm;
+            if (!qbin_decompiler::decode_qbin_to_qasm(p, qasm, err)) { std::fprintf(stderr, "%s\n", err.c_str()); std::exit(1); }
+            joined += body_of(qasm);
+        }
+        text_out = qbin_compiler::compile_qasm_to_qbin_min(joined, false);
+    });
+
+    std::vector<qbin_linker::LinkInput> plain(3), shifted(3);
+    for (size_t k = 0; k < 3; ++k) {
+        plain[k].data = shifted[k].data = parts[k].data();
+        plain[k].size = shifted[k].size = parts[k].size();
+        shifted[k].qubit_offset = shifted[k].bit_offset = uint32_t(k * qubits);
+    }
+    qbin_linker::LinkStats ls;
+    const double ms_link = time_ms(reps, [&] {
+        if (!qbin_linker::link_qbin(plain, {}, link_out, err, &ls)) { std::fprintf(stderr, "%s\n", err.c_str()); std::exit(1); }
+    });
+    const double ms_shifted = time_ms(reps, [&] {
+        if (!qbin_linker::link_qbin(shifted, {}, shifted_out, err)) { std::fprintf(stderr, "%s\n", err.c_str()); std::exit(1); }
+    });
+
+    std::vector<uint8_t> copy(in_bytes);
+    const double ms_memcpy = time_ms(reps, [&] {
+        size_t off = 0;
+        for (const auto& p : parts) { std::memcpy(copy.data() + off, p.data(), p.size()); off += p.size(); }
+    });
+
+    std::string a, b, c;
+    qbin_decompiler::decode_qbin_to_qasm(text_out, a, err);
+    qbin_decompiler::decode_qbin_to_qasm(link_out, b, err);
+    qbin_decompiler::decode_qbin_to_qasm(shifted_out, c, err);
+    const bool same = a == b && !c.empty();
+
+    std::printf("3 parts x %d layers x %d qubits: %llu instructions, %zu input bytes\n",
+        layers, qubits, static_cast<unsigned long long>(ls.instrs), in_bytes);
+    std::printf("%-30s %10s %10s\n", "method", "ms", "vs link");
+    std::printf("%-30s %10.3f %9.1fx\n", "decompile+concat+compile", ms_text, ms_text / ms_link);
+    std::printf("%-30s %10.3f %9.1fx\n", "link (memcpy path)", ms_link, 1.0);
+    std::printf("%-30s %10.3f %9.1fx\n", "link (offsets, renumbered)", ms_shifted, ms_shifted / ms_link);
+    std::printf("%-30s %10.3f %9.1fx\n", "memcpy of the inputs", ms_memcpy, ms_memcpy / ms_link);
+    std::printf("output bytes: text %zu, link %zu, shifted %zu; link == text: %s\n",
+        text_out.size(), link_out.size(), shifted_out.size(), same ? "yes" : "NO");
+    return same ? 0 : 1;
+}
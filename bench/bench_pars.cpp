@@ -0,0 +1,91 @@
+// bench_pars.cpp - size and decode time of literal vs PARS-interned angles
+//
+// Usage: bench_pars [qubits=16] [layers=200] [distinct_angles=8] [reps=20]
+//
+// Generates a hardware-efficient ansatz (RY/RZ on every qubit + CX ladder per
+// layer) whose rotation angles are drawn from a small pool, compiles it with
+// and without --intern-angles and times decode_inst_section() on both files.
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::string make_ansatz(int qubits, int layers, int distinct) {
+    std::mt19937 rng(1234);
+    std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+    std::vector<float> pool;
+    for (int i = 0; i < distinct; ++i) pool.push_back(dist(rng));
+    std::uniform_int_distribution<int> pick(0, distinct - 1);
+
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\nbit[" << qubits << "] c;\n\n";
+    for (int l = 0; l < layers; ++l) {
+        for (int i = 0; i < qubits; ++i) {
+            q << "ry(" << pool[pick(rng)] << ") q[" << i << "];\n";
+            q << "rz(" << pool[pick(rng)] << ") q[" << i << "];\n";
+        }
+        for (int i = 0; i + 1 < qubits; ++i) q << "cx q[" << i << "], q[" << i + 1 << "];\n";
+    }
+    for (int i = 0; i < qubits; ++i) q << "c[" << i << "] = measure q[" << i << "];\n";
+    return q.str();
+}
+
+// Average nanoseconds per decoded instruction (table + PARS + INST).
+static double time_decode(const std::vector<uint8_t>& f, int reps, size_t& n_instrs) {
+    using namespace qbin_decompiler;
+    std::vector<SectionEntry> table;
+    std::vector<DecodedParam> params;
+    std::vector<DecodedInstr> instrs;
+    std::string err;
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) {
+        uint8_t major, minor;
+        uint32_t toff, tsize;
+        if (!decode_header_and_table(f.data(), f.size(), major, minor, toff, tsize, table, err)) break;
+        const SectionEntry* pars = find_section(table, section_id("PARS"));
+        if (pars && !decode_pars_section(f.data(), f.size(), pars->offset, pars->size, params, err)) break;
+        const SectionEntry* inst = find_section(table, section_id("INST"));
+        if (!inst || !decode_inst_section(f.data(), f.size(), inst->offset, inst->size,
+            pars ? &params : nullptr, instrs, err)) break;
+    }
+    auto t1 = std::chrono::steady_clock::now();
+    if (!err.empty()) { std::fprintf(stderr, "decode error: %s\n", err.c_str()); std::exit(1); }
+    n_instrs = instrs.size();
+    double ns = std::chrono::duration<double, std::nano>(t1 - t0).count();
+    return ns / (double(reps) * double(instrs.size()));
+}
+
+int main(int argc, char** argv) {
+    int qubits = argc > 1 ? std::atoi(argv[1]) : 16;
+    int layers = argc > 2 ? std::atoi(argv[2]) : 200;
+    int distinct = argc > 3 ? std::atoi(argv[3]) : 8;
+    int reps = argc > 4 ? std::atoi(argv[4]) : 20;
+
+    std::string qasm = make_ansatz(qubits, layers, distinct);
+
+    qbin_compiler::CompileOptions lit;
+    qbin_compiler::CompileOptions pars;
+    pars.intern_angles = true;
+    std::vector<uint8_t> f_lit = qbin_compiler::compile_qasm_to_qbin(qasm, lit);
+    std::vector<uint8_t> f_pars = qbin_compiler::compile_qasm_to_qbin(qasm, pars);
+
+    size_t n = 0;
+    double ns_lit = time_decode(f_lit, reps, n);
+    double ns_pars = time_decode(f_pars, reps, n);
+
+    std::printf("ansatz: %d qubits, %d layers, %d distinct angles, %zu instructions\n",
+        qubits, layers, distinct, n);
+    std::printf("  QASM text          %10zu bytes\n", qasm.size());
+    std::printf("  QBIN f32 literals  %10zu bytes   decode %6.2f ns/instr\n", f_lit.size(), ns_lit);
+    std::printf("  QBIN PARS refs     %10zu bytes   decode %6.2f ns/instr\n", f_pars.size(), ns_pars);
+    std::printf("  size ratio         %10.3f\n", double(f_pars.size()) / double(f_lit.size()));
+    return 0;
+}
@@ -0,0 +1,118 @@
+// bench_program_cache.cpp - repeated decode of hot files with and without ProgramCache
+//
+// Usage: bench_program_cache [files=200] [requests=20000] [threads=4] [budget_mb=64]
+//
+// Writes `files` programs of different sizes to a temporary directory, then
+// `threads` workers issue `requests` random lookups in total, once decoding
+// every request from disk (get-file-and-decode) and once through a shared
+// ProgramCache. Checks that each file was decoded exactly once when the
+// budget is large enough.
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_decompiler/program_cache.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static std::string make_program(int qubits, int layers, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\n\n";
+    for (int l = 0; l < layers; ++l) {
+        for (int i = 0; i < qubits; ++i) q << "ry(" << dist(rng) << ") q[" << i << "];\n";
+        for (int i = 0; i + 1 < qubits; ++i) q << "cx q[" << i << "], q[" << i + 1 << "];\n";
+    }
+    return q.str();
+}
+
+static bool decode_file(const std::string& path, qbin_decompiler::DecodedProgram& out, std::string& err) {
+    std::ifstream ifs(path, std::ios::binary);
+    if (!ifs) { err = "Cannot open " + path; return false; }
+    std::vector<uint8_t> buf((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+    return qbin_decompiler::decode_program(buf.data(), buf.size(), out, err);
+}
+
+// Runs `requests` lookups over `threads` workers; returns seconds.
+template <class Fn>
+static double run(int threads, int requests, size_t files, Fn&& fn) {
+    std::atomic<int> next{ 0 };
+    std::atomic<size_t> instrs{ 0 };
+    auto t0 = std::chrono::steady_clock::now();
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            std::mt19937 rng(77u + unsigned(t));
+            std::uniform_int_distribution<size_t> pick(0, files - 1);
+            size_t local = 0;
+            while (next.fetch_add(1) < requests) local += fn(pick(rng));
+            instrs += local;
+        });
+    }
+    for (auto& th : pool) th.join();
+    auto t1 = std::chrono::steady_clock::now();
+    if (instrs == 0) { std::fprintf(stderr, "no instructions decoded\n"); std::exit(1); }
+    return std::chrono::duration<double>(t1 - t0).count();
+}
+
+int main(int argc, char** argv) {
+    size_t files = argc > 1 ? size_t(std::atoi(argv[1])) : 200;
+    int requests = argc > 2 ? std::atoi(argv[2]) : 20000;
+    int threads = argc > 3 ? std::atoi(argv[3]) : 4;
+    size_t budget = (argc > 4 ? size_t(std::atoi(argv[4])) : 64) << 20;
+    if (files == 0) files = 1;
+
+    fs::path dir = fs::temp_directory_path() / "qbin_bench_program_cache";
+    fs::create_directories(dir);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < files; ++i) {
+        std::string qasm = make_program(8, 5 + int(i % 40), unsigned(i));
+        std::vector<uint8_t> blob = qbin_compiler::compile_qasm_to_qbin(qasm, qbin_compiler::CompileOptions{});
+        paths.push_back((dir / ("p" + std::to_string(i) + ".qbin")).string());
+        std::ofstream(paths.back(), std::ios::binary).write(reinterpret_cast<const char*>(blob.data()), std::streamsize(blob.size()));
+    }
+
+    double t_plain = run(threads, requests, files, [&](size_t i) {
+        qbin_decompiler::DecodedProgram p;
+        std::string err;
+        if (!decode_file(paths[i], p, err)) { std::fprintf(stderr, "%s\n", err.c_str()); std::exit(1); }
+        return p.instrs.size();
+    });
+
+    qbin_decompiler::ProgramCache cache(budget);
+    double t_cached = run(threads, requests, files, [&](size_t i) {
+        std::string err;
+        qbin_decompiler::ProgramCache::Handle h = cache.get_file(paths[i], err);
+        if (!h) { std::fprintf(stderr, "%s\n", err.c_str()); std::exit(1); }
+        return h->instrs.size();
+    });
+
+    qbin_decompiler::ProgramCacheStats st = cache.stats();
+    std::printf("files %zu, requests %d, threads %d, budget %zu MiB\n", files, requests, threads, budget >> 20);
+    std::printf("  decode every request: %8.2f us/request\n", 1e6 * t_plain / requests);
+    std::printf("  ProgramCache:         %8.2f us/request  (%.1fx)\n", 1e6 * t_cached / requests, t_plain / t_cached);
+    std::printf("  hits %llu, misses %llu, evictions %llu, entries %llu, %llu KiB\n",
+        (unsigned long long)st.hits, (unsigned long long)st.misses, (unsigned long long)st.evictions,
+        (unsigned long long)st.entries, (unsigned long long)(st.bytes >> 10));
+
+    fs::remove_all(dir);
+    // With room for every program, each file must have been decoded once
+    if (st.evictions == 0 && st.misses > files) {
+        std::fprintf(stderr, "FAIL: %llu decodes for %zu files\n", (unsigned long long)st.misses, files);
+        return 1;
+    }
+    return 0;
+}
@@ -0,0 +1,73 @@
+// bench_runner.cpp - state-vector gate kernel throughput at 20-28 qubits
+//
+// Usage: bench_runner [min_qubits=20] [max_qubits=26] [reps=5]
+//
+// For each register size, times single-qubit (low/high target), controlled
+// (CX) and generic two-qubit (RXX) kernels with the scalar and the AVX2
+// implementation, and reports milliseconds per gate and the effective memory
+// bandwidth (each gate reads and writes the whole vector once). 28 qubits
+// needs 4 GiB for the state.
+
+#include "qbin_runner/statevector.hpp"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+
+using namespace qbin_runner;
+
+template <class Fn>
+static double time_ms(int reps, Fn&& fn) {
+    fn(); // warm-up (page faults on first touch)
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double, std::milli>(t1 - t0).count() / reps;
+}
+
+int main(int argc, char** argv) {
+    unsigned lo = argc > 1 ? unsigned(std::atoi(argv[1])) : 20;
+    unsigned hi = argc > 2 ? unsigned(std::atoi(argv[2])) : 26;
+    int reps = argc > 3 ? std::atoi(argv[3]) : 5;
+
+    const double c = std::cos(0.3), s = std::sin(0.3);
+    const Mat2 ry = { c, -s, s, c };
+    const Mat2 x = { 0.0, 1.0, 1.0, 0.0 };
+    Mat4 rxx;
+    for (int i = 0; i < 4; ++i)
+        for (int j = 0; j < 4; ++j) rxx.m[i][j] = 0.0;
+    for (int i = 0; i < 4; ++i) { rxx.m[i][i] = c; rxx.m[i][3 - i] = amp_t(0.0, -s); }
+
+    std::printf("AVX2 kernels: %s\n", have_avx2() ? "yes" : "no (scalar only)");
+    std::printf("%6s %-14s %10s %10s %9s %10s\n", "qubits", "gate", "scalar ms", "avx2 ms", "speedup", "avx2 GB/s");
+    for (unsigned n = lo; n <= hi; ++n) {
+        StateVector sv;
+        std::string err;
+        if (!sv.init(n, err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+        const double bytes = 2.0 * double(sv.size()) * sizeof(amp_t);
+        struct Case { const char* name; int kind; unsigned a, b; };
+        const Case cases[] = {
+            { "ry q[0]",      0, 0, 0 },
+            { "ry q[n-1]",    0, n - 1, 0 },
+            { "cx q[1],q[5]", 1, 1, 5 },
+            { "cx q[0],q[n-1]", 1, 0, n - 1 },
+            { "rxx q[2],q[9]", 2, 2, 9 },
+        };
+        for (const Case& k : cases) {
+            auto apply = [&] {
+                if (k.kind == 0) sv.apply_1q(k.a, ry);
+                else if (k.kind == 1) sv.apply_c1q(k.a, k.b, x);
+                else sv.apply_2q(k.a, k.b, rxx);
+            };
+            sv.set_simd(false);
+            const double ms_scalar = time_ms(reps, apply);
+            sv.set_simd(true);
+            const double ms_simd = sv.simd() ? time_ms(reps, apply) : ms_scalar;
+            std::printf("%6u %-14s %10.2f %10.2f %8.2fx %10.2f\n", n, k.name, ms_scalar, ms_simd,
+                ms_scalar / ms_simd, bytes / (ms_simd * 1e6));
+        }
+    }
+    return 0;
+}
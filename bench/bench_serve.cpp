@@ -0,0 +1,155 @@
+// bench_serve.cpp - small compile requests through qbin-serve versus in-process and per-process
+//
+// Usage: bench_serve [clients=4] [requests=2000] [workers=0] [batch_window_us=0] [qbin-compile path]
+//
+// Starts a Server in-process on a temporary socket. `clients` threads each
+// hold one connection and send `requests` compile requests of small random
+// circuits in total, waiting for each reply (request/response latency is
+// what a build tool issuing one file at a time sees). Reports throughput and
+// client-side p50/p99 next to calling compile_qasm_to_qbin() directly, and,
+// given a qbin-compile binary, next to starting one process per file.
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_server/client.hpp"
+#include "qbin_server/histogram.hpp"
+#include "qbin_server/server.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using Clock = std::chrono::steady_clock;
+
+static std::string make_program(int qubits, int gates, unsigned seed) {
+    std::mt19937 rng(seed);
+    std::uniform_real_distribution<float> angle(-3.0f, 3.0f);
+    std::uniform_int_distribution<int> pick(0, qubits - 1);
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\n\n";
+    for (int g = 0; g < gates; ++g) {
+        const int a = pick(rng);
+        int b = pick(rng);
+        if (b == a) b = (a + 1) % qubits;
+        switch (g % 3) {
+        case 0: q << "h q[" << a << "];\n"; break;
+        case 1: q << "rz(" << angle(rng) << ") q[" << a << "];\n"; break;
+        default: q << "cx q[" << a << "], q[" << b << "];\n"; break;
+        }
+    }
+    return q.str();
+}
+
+static uint64_t ns_since(Clock::time_point t0) {
+    return uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - t0).count());
+}
+
+static void report(const char* name, double secs, int requests, const qbin_server::LatencyHistogram& h) {
+    std::printf("%-12s %9.0f req/s   p50 %8.1f us   p99 %8.1f us\n", name, requests / secs,
+        h.percentile(0.50) / 1e3, h.percentile(0.99) / 1e3);
+}
+
+int main(int argc, char** argv) {
+    const int clients = argc > 1 ? std::max(1, std::atoi(argv[1])) : 4;
+    const int requests = argc > 2 ? std::max(1, std::atoi(argv[2])) : 2000;
+    const unsigned workers = argc > 3 ? unsigned(std::atoi(argv[3])) : 0;
+    const long window = argc > 4 ? std::atol(argv[4]) : 0;
+    const std::string compiler = argc > 5 ? argv[5] : "";
+
+    std::vector<std::string> programs;
+    for (unsigned s = 0; s < 64; ++s) programs.push_back(make_program(8, 40, 1000 + s));
+
+    fs::path dir = fs::temp_directory_path() / "qbin_bench_serve";
+    fs::create_directories(dir);
+
+    // In-process baseline, one thread (what each request costs without I/O)
+    qbin_compiler::CompileOptions copts;
+    copts.opt_level = 1;
+    {
+        qbin_server::LatencyHistogram h;
+        size_t bytes = 0;
+        auto t0 = Clock::now();
+        for (int i = 0; i < requests; ++i) {
+            auto t = Clock::now();
+            bytes += qbin_compiler::compile_qasm_to_qbin(programs[size_t(i) % programs.size()], copts).size();
+            h.record(ns_since(t));
+        }
+        const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (bytes == 0) { std::fprintf(stderr, "empty output\n"); return 1; }
+        report("in-process", secs, requests, h);
+    }
+
+    // Server
+    qbin_server::ServerOptions sopts;
+    sopts.socket_path = (dir / "s").string();
+    sopts.workers = workers;
+    sopts.batch_window = std::chrono::microseconds(window);
+    qbin_server::Server server(sopts);
+    std::string err;
+    if (!server.start(err)) { std::fprintf(stderr, "%s\n", err.c_str()); return 1; }
+    std::thread io([&] { server.run(); });
+    {
+        std::atomic<int> next{ 0 };
+        std::atomic<bool> failed{ false };
+        std::vector<qbin_server::LatencyHistogram> hs{ size_t(clients) };
+        auto t0 = Clock::now();
+        std::vector<std::thread> pool;
+        for (int c = 0; c < clients; ++c) {
+            pool.emplace_back([&, c] {
+                qbin_server::Client cl;
+                std::string e;
+                if (!cl.connect(sopts.socket_path, e)) { std::fprintf(stderr, "%s\n", e.c_str()); failed = true; return; }
+                qbin_server::RequestHeader h;
+                h.opt_level = 1;
+                std::vector<uint8_t> out;
+                for (int i; (i = next.fetch_add(1)) < requests;) {
+                    auto t = Clock::now();
+                    if (!cl.compile(programs[size_t(i) % programs.size()], h, out, e)) {
+                        std::fprintf(stderr, "%s\n", e.c_str());
+                        failed = true;
+                        return;
+                    }
+                    hs[size_t(c)].record(ns_since(t));
+                }
+            });
+        }
+        for (auto& t : pool) t.join();
+        const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        if (failed) return 1;
+        for (int c = 1; c < clients; ++c) hs[0].merge(hs[size_t(c)]);
+        report("qbin-serve", secs, requests, hs[0]);
+    }
+    server.stop();
+    io.join();
+    std::printf("\n%s", server.stats_report().c_str());
+
+    // One process per file, as a build system invoking qbin-compile would
+    if (!compiler.empty()) {
+        const int n = std::min(requests, 200);
+        const std::string in = (dir / "in.qasm").string(), out = (dir / "out.qbin").string();
+        qbin_server::LatencyHistogram h;
+        auto t0 = Clock::now();
+        for (int i = 0; i < n; ++i) {
+            std::ofstream(in, std::ios::binary) << programs[size_t(i) % programs.size()];
+            const std::string cmd = "\"" + compiler + "\" \"" + in + "\" -o \"" + out + "\" -O1 --no-cache";
+            auto t = Clock::now();
+            if (std::system(cmd.c_str()) != 0) { std::fprintf(stderr, "qbin-compile failed\n"); return 1; }
+            h.record(ns_since(t));
+        }
+        const double secs = std::chrono::duration<double>(Clock::now() - t0).count();
+        std::printf("\n");
+        report("spawn", secs, n, h);
+    }
+    fs::remove_all(dir);
+    return 0;
+}
@@ -0,0 +1,93 @@
+// bench_writer.cpp - Writer (typed builder) versus generate-QASM-text + compile
+//
+// Usage: bench_writer [layers=2000] [qubits=32] [reps=5]
+//
+// Emits the same hardware-efficient ansatz (ry/rz layer, CX ladder, final
+// measurements and one classically controlled X per qubit pair) twice: by
+// printing OpenQASM and compiling it, and through qbin_compiler::Writer.
+// Reports gates per second for both and checks the files are identical.
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_compiler/writer.hpp"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <sstream>
+#include <string>
+#include <vector>
+
+static std::vector<float> make_angles(size_t n) {
+    std::mt19937 rng(5);
+    std::uniform_real_distribution<float> dist(-3.0f, 3.0f);
+    std::vector<float> v(n);
+    for (auto& x : v) x = dist(rng);
+    return v;
+}
+
+static std::vector<uint8_t> via_text(int qubits, int layers, const std::vector<float>& th) {
+    std::ostringstream q;
+    q.precision(9);
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\nbit[" << qubits << "] c;\n\n";
+    size_t k = 0;
+    for (int l = 0; l < layers; ++l) {
+        for (int i = 0; i < qubits; ++i) {
+            q << "ry(" << th[k++] << ") q[" << i << "];\n";
+            q << "rz(" << th[k++] << ") q[" << i << "];\n";
+        }
+        for (int i = 0; i + 1 < qubits; ++i) q << "cx q[" << i << "], q[" << i + 1 << "];\n";
+    }
+    for (int i = 0; i < qubits; ++i) q << "c[" << i << "] = measure q[" << i << "];\n";
+    for (int i = 0; i + 1 < qubits; i += 2) q << "if (c[" << i << "] == 1) { x q[" << i + 1 << "]; }\n";
+    return qbin_compiler::compile_qasm_to_qbin_min(q.str(), false);
+}
+
+static std::vector<uint8_t> via_writer(qbin_compiler::Writer& w, int qubits, int layers, const std::vector<float>& th) {
+    size_t k = 0;
+    for (int l = 0; l < layers; ++l) {
+        for (int i = 0; i < qubits; ++i) {
+            w.ry(th[k], uint32_t(i)).rz(th[k + 1], uint32_t(i));
+            k += 2;
+        }
+        for (int i = 0; i + 1 < qubits; ++i) w.cx(uint32_t(i), uint32_t(i + 1));
+    }
+    for (int i = 0; i < qubits; ++i) w.measure(uint32_t(i), uint32_t(i));
+    for (int i = 0; i + 1 < qubits; i += 2) {
+        w.if_eq(uint32_t(i), true, [i](qbin_compiler::Writer& b) { b.x(uint32_t(i + 1)); });
+    }
+    return w.finish();
+}
+
+template <class Fn>
+static double time_s(int reps, Fn&& fn) {
+    fn();
+    auto t0 = std::chrono::steady_clock::now();
+    for (int r = 0; r < reps; ++r) fn();
+    auto t1 = std::chrono::steady_clock::now();
+    return std::chrono::duration<double>(t1 - t0).count() / reps;
+}
+
+int main(int argc, char** argv) {
+    const int layers = argc > 1 ? std::atoi(argv[1]) : 2000;
+    const int qubits = argc > 2 ? std::atoi(argv[2]) : 32;
+    const int reps = argc > 3 ? std::atoi(argv[3]) : 5;
+    const std::vector<float> th = make_angles(size_t(layers) * size_t(qubits) * 2);
+    const double gates = double(layers) * (3.0 * qubits - 1) + qubits + qubits / 2;
+
+    std::vector<uint8_t> a, b;
+    const double s_text = time_s(reps, [&] { a = via_text(qubits, layers, th); });
+    const double s_writer = time_s(reps, [&] {
+        qbin_compiler::Writer w(static_cast<size_t>(gates));
+        b = via_writer(w, qubits, layers, th);
+    });
+    const double s_grow = time_s(reps, [&] { qbin_compiler::Writer w; b = via_writer(w, qubits, layers, th); });
+
+    std::printf("%d layers x %d qubits: %.0f gates, %zu bytes\n", layers, qubits, gates, a.size());
+    std::printf("%-28s %10s %14s %9s\n", "method", "ms", "Mgates/s", "speedup");
+    std::printf("%-28s %10.2f %14.2f %8.1fx\n", "QASM text + compile", s_text * 1e3, gates / s_text * 1e-6, 1.0);
+    std::printf("%-28s %10.2f %14.2f %8.1fx\n", "Writer (growing buffer)", s_grow * 1e3, gates / s_grow * 1e-6, s_text / s_grow);
+    std::printf("%-28s %10.2f %14.2f %8.1fx\n", "Writer (reserved)", s_writer * 1e3, gates / s_writer * 1e-6, s_text / s_writer);
+    std::printf("identical output: %s\n", a == b ? "yes" : "NO");
+    return a == b ? 0 : 1;
+}
@@ -0,0 +1,90 @@
+#ifndef QBIN_QBIN_H
+#define QBIN_QBIN_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+/* ASCII-only header.
+ * C ABI over the compiler and decoder, for language bindings (the ctypes
+ * module in bindings/python/qbin.py uses nothing else).
+ *
+ *  - Every call returns 0 on success and nonzero on failure, and always
+ *    hands back a result in *out (NULL only if memory ran out): the output
+ *    on success, the message (qbin_result_error) on failure. Free it with
+ *    qbin_result_free.
+ *  - Inputs are borrowed for the duration of the call and never copied.
+ *    Outputs live in the result until it is freed; callers can expose them
+ *    in place (Python memoryview, NumPy arrays).
+ *  - Calls share no state and may run concurrently from several threads.
+ *  - No C++ exception crosses this interface.
+ */
+
+#if defined(_WIN32)
+#  if defined(QBIN_C_BUILD)
+#    define QBIN_API __declspec(dllexport)
+#  else
+#    define QBIN_API __declspec(dllimport)
+#  endif
+#else
+#  define QBIN_API __attribute__((visibility("default")))
+#endif
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct qbin_result qbin_result;
+
+/* Mirrors qbin_compiler::CompileOptions (without dictionaries). */
+typedef struct qbin_compile_options {
+    int opt_level;        /* 0, 1 or 2 */
+    int intern_angles;
+    int dedup_gates;
+    int delta_operands;
+    int compress_level;   /* 0 = off, 1..22 = zstd level */
+    int debug_info;
+    int fuse_1q;
+} qbin_compile_options;
+
+/* Decoded instruction stream, one array per field, `count` entries each.
+ * angle, angle1 and angle2 are the angle_0..angle_2 slots (theta, phi,
+ * lambda of U/CU). Absent operands are -1 (a, b, c, aux) or NaN (angles).
+ * CALLG records are replaced by their gate bodies. */
+typedef struct qbin_instr_arrays {
+    size_t count;
+    const uint8_t* opcode;
+    const int32_t* a;
+    const int32_t* b;
+    const int32_t* c;
+    const float* angle;
+    const int64_t* aux;
+    const float* angle1;
+    const float* angle2;
+} qbin_instr_arrays;
+
+QBIN_API const char* qbin_version(void);
+
+/* QASM text -> QBIN bytes (qbin_result_data). With opts == NULL the output
+ * is that of compile_qasm_to_qbin_min(). */
+QBIN_API int qbin_compile(const char* qasm, size_t len, const qbin_compile_options* opts, qbin_result** out);
+
+/* QBIN bytes -> QASM text (qbin_result_data, not NUL-counted in *len),
+ * the same text qbin-decompile writes. */
+QBIN_API int qbin_decompile(const uint8_t* data, size_t len, int gate_defs, qbin_result** out);
+
+/* QBIN bytes -> instruction arrays (qbin_result_instrs). */
+QBIN_API int qbin_decode(const uint8_t* data, size_t len, qbin_result** out);
+
+/* Output bytes of qbin_compile/qbin_decompile; NULL for other results. */
+QBIN_API const uint8_t* qbin_result_data(const qbin_result* r, size_t* len);
+/* Arrays of qbin_decode; nonzero if `r` holds none. */
+QBIN_API int qbin_result_instrs(const qbin_result* r, qbin_instr_arrays* out);
+/* Message of a failed call, or "" */
+QBIN_API const char* qbin_result_error(const qbin_result* r);
+QBIN_API void qbin_result_free(qbin_result* r);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* QBIN_QBIN_H */
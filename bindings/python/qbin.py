@@ -0,0 +1,251 @@
+"""ctypes bindings for the QBIN compiler and decoder (libqbin, bindings/include/qbin/qbin.h).
+
+    import qbin
+    blob = qbin.compile("OPENQASM 3.0;\\nqubit[2] q;\\nh q[0];\\ncx q[0], q[1];\\n")
+    text = qbin.decompile(blob)
+    prog = qbin.decode(blob)          # prog.opcode, .a, .b, .c, .angle, .angle1, .angle2, .aux
+
+- Inputs: `bytes` and any C-contiguous buffer (bytearray, memoryview, mmap,
+  NumPy arrays, the outputs below) are passed to the library in place
+  through the buffer protocol; compile() also takes `str` (UTF-8 encoded
+  first).
+- Outputs stay in library memory: compile() returns a read-only memoryview,
+  decode() one memoryview per column (formats B, i, i, i, f, f, f, q), usable
+  with numpy.asarray() without a copy. They keep the library result alive.
+- Every call goes through ctypes.CDLL, which releases the GIL while the
+  library works, so compiles and decodes in several Python threads run in
+  parallel.
+
+The library is found through $QBIN_LIBRARY, next to this file or one
+directory up (installed as lib/python/qbin.py), in the build tree
+(build/bindings/) or on the system library path.
+"""
+
+import ctypes
+import ctypes.util
+import glob
+import os
+
+__all__ = ["QbinError", "compile", "decompile", "decode", "version"]
+
+
+class QbinError(Exception):
+  pass
+
+
+class _CompileOptions(ctypes.Structure):
+  _fields_ = [("opt_level", ctypes.c_int), ("intern_angles", ctypes.c_int), ("dedup_gates", ctypes.c_int),
+              ("delta_operands", ctypes.c_int), ("compress_level", ctypes.c_int), ("debug_info", ctypes.c_int),
+              ("fuse_1q", ctypes.c_int)]
+
+
+class _InstrArrays(ctypes.Structure):
+  _fields_ = [("count", ctypes.c_size_t),
+              ("opcode", ctypes.POINTER(ctypes.c_uint8)),
+              ("a", ctypes.POINTER(ctypes.c_int32)),
+              ("b", ctypes.POINTER(ctypes.c_int32)),
+              ("c", ctypes.POINTER(ctypes.c_int32)),
+              ("angle", ctypes.POINTER(ctypes.c_float)),
+              ("aux", ctypes.POINTER(ctypes.c_int64)),
+              ("angle1", ctypes.POINTER(ctypes.c_float)),
+              ("angle2", ctypes.POINTER(ctypes.c_float))]
+
+
+def _candidates():
+  env = os.environ.get("QBIN_LIBRARY")
+  if env:
+    yield env
+  here = os.path.dirname(os.path.abspath(__file__))
+  names = ("libqbin.so", "libqbin.dylib", "qbin.dll")
+  for d in (here, os.path.dirname(here), os.path.join(here, "..", "..", "build", "bindings")):
+    for n in names:
+      yield os.path.join(d, n)
+    for p in sorted(glob.glob(os.path.join(d, "*", "qbin.dll"))):
+      yield p
+  found = ctypes.util.find_library("qbin")
+  if found:
+    yield found
+
+
+def _load():
+  errors = []
+  for path in _candidates():
+    if os.path.sep in path and not os.path.exists(path):
+      continue
+    try:
+      lib = ctypes.CDLL(path)
+    except OSError as e:
+      errors.append("{}: {}".format(path, e))
+      continue
+    break
+  else:
+    raise ImportError("libqbin not found (set QBIN_LIBRARY){}".format(
+      "".join("\n  " + e for e in errors)))
+
+  res = ctypes.c_void_p
+  lib.qbin_version.argtypes = []
+  lib.qbin_version.restype = ctypes.c_char_p
+  lib.qbin_compile.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.POINTER(_CompileOptions), ctypes.POINTER(res)]
+  lib.qbin_compile.restype = ctypes.c_int
+  lib.qbin_decompile.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.c_int, ctypes.POINTER(res)]
+  lib.qbin_decompile.restype = ctypes.c_int
+  lib.qbin_decode.argtypes = [ctypes.c_void_p, ctypes.c_size_t, ctypes.POINTER(res)]
+  lib.qbin_decode.restype = ctypes.c_int
+  lib.qbin_result_data.argtypes = [res, ctypes.POINTER(ctypes.c_size_t)]
+  lib.qbin_result_data.restype = ctypes.c_void_p
+  lib.qbin_result_instrs.argtypes = [res, ctypes.POINTER(_InstrArrays)]
+  lib.qbin_result_instrs.restype = ctypes.c_int
+  lib.qbin_result_error.argtypes = [res]
+  lib.qbin_result_error.restype = ctypes.c_char_p
+  lib.qbin_result_free.argtypes = [res]
+  lib.qbin_result_free.restype = None
+  return lib
+
+
+_lib = _load()
+
+
+class _Result(object):
+  """Owns one qbin_result; views handed out keep it alive."""
+
+  def __init__(self, handle):
+    self.handle = handle
+
+  def __del__(self):
+    if self.handle:
+      _lib.qbin_result_free(self.handle)
+      self.handle = None
+
+  def view(self, ctype, ptr, count, fmt):
+    arr = (ctype * count).from_address(ptr) if count else (ctype * 0)()
+    arr._owner = self
+    return memoryview(arr).cast("B").cast(fmt)
+
+
+def _call(fn, *args):
+  handle = ctypes.c_void_p()
+  rc = fn(*(args + (ctypes.byref(handle),)))
+  if not handle:
+    raise MemoryError("qbin: out of memory")
+  r = _Result(handle)
+  if rc != 0:
+    raise QbinError(_lib.qbin_result_error(r.handle).decode("utf-8", "replace"))
+  return r
+
+
+class _PyBuffer(ctypes.Structure):
+  _fields_ = [("buf", ctypes.c_void_p), ("obj", ctypes.c_void_p), ("len", ctypes.c_ssize_t),
+              ("itemsize", ctypes.c_ssize_t), ("readonly", ctypes.c_int), ("ndim", ctypes.c_int),
+              ("format", ctypes.c_char_p), ("shape", ctypes.c_void_p), ("strides", ctypes.c_void_p),
+              ("suboffsets", ctypes.c_void_p), ("internal", ctypes.c_void_p)]
+
+
+try:
+  _get_buffer = ctypes.pythonapi.PyObject_GetBuffer
+  _get_buffer.argtypes = [ctypes.py_object, ctypes.POINTER(_PyBuffer), ctypes.c_int]
+  _get_buffer.restype = ctypes.c_int
+  _release_buffer = ctypes.pythonapi.PyBuffer_Release
+  _release_buffer.argtypes = [ctypes.POINTER(_PyBuffer)]
+  _release_buffer.restype = None
+except AttributeError:      # no CPython C API (e.g. PyPy): buffers are copied
+  _get_buffer = None
+
+
+class _Borrow(object):
+  """with _Borrow(data) as (ptr, n): the bytes of `data` (str, bytes or any
+  C-contiguous buffer) in place, held until the block ends."""
+
+  def __init__(self, data):
+    if isinstance(data, str):
+      data = data.encode("utf-8")
+    self.data = data
+    self.view = None
+
+  def __enter__(self):
+    d = self.data
+    if isinstance(d, bytes):
+      return ctypes.cast(ctypes.c_char_p(d), ctypes.c_void_p), len(d)
+    if _get_buffer is None:
+      self.data = d = bytes(memoryview(d).cast("B"))
+      return ctypes.cast(ctypes.c_char_p(d), ctypes.c_void_p), len(d)
+    self.view = _PyBuffer()
+    _get_buffer(d, ctypes.byref(self.view), 0)    # PyBUF_SIMPLE: contiguous bytes
+    return ctypes.c_void_p(self.view.buf), self.view.len
+
+  def __exit__(self, *exc):
+    if self.view is not None:
+      _release_buffer(ctypes.byref(self.view))
+      self.view = None
+    self.data = None
+    return False
+
+
+def version():
+  return _lib.qbin_version().decode("ascii")
+
+
+def compile(qasm, opt_level=None, intern_angles=False, dedup_gates=False, delta_operands=False,
+            compress_level=0, debug_info=False, fuse_1q=False):
+  """Compiles QASM (str or bytes-like) to a read-only memoryview of QBIN bytes.
+
+  With no options the output equals compile_qasm_to_qbin_min(); otherwise
+  it matches qbin-compile with the same flags."""
+  opts = None
+  if opt_level is not None or intern_angles or dedup_gates or delta_operands or compress_level or debug_info \
+      or fuse_1q:
+    opts = ctypes.byref(_CompileOptions(opt_level or 0, int(intern_angles), int(dedup_gates),
+                                        int(delta_operands), int(compress_level), int(debug_info),
+                                        int(fuse_1q)))
+  with _Borrow(qasm) as (ptr, n):
+    r = _call(_lib.qbin_compile, ptr, n, opts)
+  size = ctypes.c_size_t()
+  data = _lib.qbin_result_data(r.handle, ctypes.byref(size))
+  return r.view(ctypes.c_uint8, data, size.value, "B").toreadonly()
+
+
+def decompile(qbin, gate_defs=False):
+  """QBIN bytes-like -> QASM text, as written by qbin-decompile."""
+  with _Borrow(qbin) as (ptr, n):
+    r = _call(_lib.qbin_decompile, ptr, n, int(gate_defs))
+  size = ctypes.c_size_t()
+  data = _lib.qbin_result_data(r.handle, ctypes.byref(size))
+  return ctypes.string_at(data, size.value).decode("utf-8")
+
+
+class Program(object):
+  """Decoded instruction stream (CALLG inlined), one memoryview per column.
+
+  angle, angle1 and angle2 are theta, phi and lambda of U/CU (angle alone
+  for the other rotations). Absent operands are -1 (a, b, c, aux) or NaN
+  (angles)."""
+
+  __slots__ = ("opcode", "a", "b", "c", "angle", "angle1", "angle2", "aux")
+
+  def __len__(self):
+    return len(self.opcode)
+
+  def __iter__(self):
+    for i in range(len(self.opcode)):
+      yield (self.opcode[i], self.a[i], self.b[i], self.c[i], self.angle[i], self.angle1[i], self.angle2[i],
+             self.aux[i])
+
+
+def decode(qbin):
+  """QBIN bytes-like -> Program."""
+  with _Borrow(qbin) as (ptr, n):
+    r = _call(_lib.qbin_decode, ptr, n)
+  arrays = _InstrArrays()
+  if _lib.qbin_result_instrs(r.handle, ctypes.byref(arrays)) != 0:
+    raise QbinError("qbin: decode returned no instructions")
+  n = arrays.count
+  p = Program()
+  addr = lambda ptr: ctypes.cast(ptr, ctypes.c_void_p).value
+  p.opcode = r.view(ctypes.c_uint8, addr(arrays.opcode), n, "B").toreadonly()
+  p.a = r.view(ctypes.c_int32, addr(arrays.a), n, "i").toreadonly()
+  p.b = r.view(ctypes.c_int32, addr(arrays.b), n, "i").toreadonly()
+  p.c = r.view(ctypes.c_int32, addr(arrays.c), n, "i").toreadonly()
+  p.angle = r.view(ctypes.c_float, addr(arrays.angle), n, "f").toreadonly()
+  p.angle1 = r.view(ctypes.c_float, addr(arrays.angle1), n, "f").toreadonly()
+  p.angle2 = r.view(ctypes.c_float, addr(arrays.angle2), n, "f").toreadonly()
+  p.aux = r.view(ctypes.c_int64, addr(arrays.aux), n, "q").toreadonly()
+  return p
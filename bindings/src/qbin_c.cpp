@@ -0,0 +1,169 @@
+// qbin_c.cpp - C ABI over qbin_compiler / qbin_decompiler (see qbin/qbin.h)
+
+#include "qbin/qbin.h"
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_decompiler/decompiler.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <cmath>
+#include <exception>
+#include <limits>
+#include <new>
+#include <string>
+#include <vector>
+
+struct qbin_result {
+    std::vector<uint8_t> bytes;     // compile output
+    std::string text;               // decompile output
+    bool has_bytes = false, has_text = false, has_instrs = false;
+    std::string err;
+
+    // decode output, one column per field
+    std::vector<uint8_t> opcode;
+    std::vector<int32_t> a, b, c;
+    std::vector<float> angle, angle1, angle2;
+    std::vector<int64_t> aux;
+};
+
+// Runs `fn` into a fresh result; exceptions become error results.
+template <class Fn>
+static int run(qbin_result** out, Fn&& fn) {
+    if (!out) return 1;
+    *out = new (std::nothrow) qbin_result();
+    if (!*out) return 1;
+    qbin_result& r = **out;
+    try {
+        if (fn(r)) return 0;
+        if (r.err.empty()) r.err = "unknown error";
+    }
+    catch (const std::exception& e) {
+        r.err = e.what();
+    }
+    catch (...) {
+        r.err = "unknown exception";
+    }
+    r.has_bytes = r.has_text = r.has_instrs = false;
+    return 1;
+}
+
+static bool columns_from(const std::vector<qbin_decompiler::DecodedInstr>& instrs, qbin_result& r) {
+    const size_t n = instrs.size();
+    r.opcode.resize(n);
+    r.a.resize(n);
+    r.b.resize(n);
+    r.c.resize(n);
+    r.angle.resize(n);
+    r.angle1.resize(n);
+    r.angle2.resize(n);
+    r.aux.resize(n);
+    const float nan = std::numeric_limits<float>::quiet_NaN();
+    for (size_t i = 0; i < n; ++i) {
+        const auto& in = instrs[i];
+        r.opcode[i] = in.opcode;
+        r.a[i] = in.a;
+        r.b[i] = in.b;
+        r.c[i] = in.c;
+        r.angle[i] = in.has_angle0 ? in.angle0 : nan;
+        r.angle1[i] = in.has_angle1 ? in.angle1 : nan;
+        r.angle2[i] = in.has_angle2 ? in.angle2 : nan;
+        r.aux[i] = in.has_aux ? int64_t(in.aux) : -1;
+    }
+    r.has_instrs = true;
+    return true;
+}
+
+extern "C" {
+
+const char* qbin_version(void) {
+    return qbin_compiler::compiler_version();
+}
+
+int qbin_compile(const char* qasm, size_t len, const qbin_compile_options* opts, qbin_result** out) {
+    return run(out, [&](qbin_result& r) {
+        if (!qasm && len) { r.err = "null input"; return false; }
+        const std::string text(qasm ? qasm : "", len);
+        if (!opts) {
+            r.bytes = qbin_compiler::compile_qasm_to_qbin_min(text, false);
+        }
+        else {
+            if (opts->opt_level < 0 || opts->opt_level > 2) { r.err = "opt_level must be 0, 1 or 2"; return false; }
+            if (opts->compress_level < 0 || opts->compress_level > 22) { r.err = "compress_level must be 0..22"; return false; }
+            qbin_compiler::CompileOptions o;
+            o.opt_level = opts->opt_level;
+            o.intern_angles = opts->intern_angles != 0;
+            o.dedup_gates = opts->dedup_gates != 0;
+            o.delta_operands = opts->delta_operands != 0;
+            o.compress_level = opts->compress_level;
+            o.debug_info = opts->debug_info != 0;
+            o.fuse_1q = opts->fuse_1q != 0;
+            r.bytes = qbin_compiler::compile_qasm_to_qbin(text, o);
+        }
+        r.has_bytes = true;
+        return true;
+    });
+}
+
+int qbin_decompile(const uint8_t* data, size_t len, int gate_defs, qbin_result** out) {
+    return run(out, [&](qbin_result& r) {
+        if (!data && len) { r.err = "null input"; return false; }
+        qbin_decompiler::DecompileOptions o;
+        o.gate_defs = gate_defs != 0;
+        if (!qbin_decompiler::decode_qbin_to_qasm(data, len, r.text, r.err, o)) return false;
+        // Same trailing-newline normalization as qbin-decompile
+        while (!r.text.empty() && r.text.back() == '\n') r.text.pop_back();
+        r.text.append("\n\n");
+        r.has_text = true;
+        return true;
+    });
+}
+
+int qbin_decode(const uint8_t* data, size_t len, qbin_result** out) {
+    return run(out, [&](qbin_result& r) {
+        if (!data && len) { r.err = "null input"; return false; }
+        qbin_decompiler::DecodedProgram prog;
+        if (!qbin_decompiler::decode_program(data, len, prog, r.err)) return false;
+        if (prog.gates.empty()) return columns_from(prog.instrs, r);
+        std::vector<qbin_decompiler::DecodedInstr> flat;
+        if (!qbin_decompiler::inline_gate_calls(prog.instrs, prog.gates, flat, r.err)) return false;
+        return columns_from(flat, r);
+    });
+}
+
+const uint8_t* qbin_result_data(const qbin_result* r, size_t* len) {
+    if (len) *len = 0;
+    if (!r) return nullptr;
+    if (r->has_bytes) {
+        if (len) *len = r->bytes.size();
+        return r->bytes.data();
+    }
+    if (r->has_text) {
+        if (len) *len = r->text.size();
+        return reinterpret_cast<const uint8_t*>(r->text.data());
+    }
+    return nullptr;
+}
+
+int qbin_result_instrs(const qbin_result* r, qbin_instr_arrays* out) {
+    if (!r || !out || !r->has_instrs) return 1;
+    out->count = r->opcode.size();
+    out->opcode = r->opcode.data();
+    out->a = r->a.data();
+    out->b = r->b.data();
+    out->c = r->c.data();
+    out->angle = r->angle.data();
+    out->aux = r->aux.data();
+    out->angle1 = r->angle1.data();
+    out->angle2 = r->angle2.data();
+    return 0;
+}
+
+const char* qbin_result_error(const qbin_result* r) {
+    return r ? r->err.c_str() : "out of memory";
+}
+
+void qbin_result_free(qbin_result* r) {
+    delete r;
+}
+
+} // extern "C"
@@ -0,0 +1,121 @@
+#ifndef QBIN_BUNDLE_BUNDLE_HPP
+#define QBIN_BUNDLE_BUNDLE_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <string_view>
+#include <vector>
+
+// ASCII-only header.
+// QBND bundles: many QBIN images in one file behind a hashed directory, so
+// that a reader pays one open() and one mmap() for the whole set instead of
+// open/stat/read per program (layout in spec appendix A).
+//
+//   header (32 bytes)  "QBND", version, entry count, bucket bits, names size, CRC32C
+//   bucket index       (2^bits + 1) x u32, first directory entry of each bucket
+//   directory          entry_count x 32 bytes, sorted by name hash
+//   names              u16 length + bytes per name
+//   images             concatenated QBIN files, each 8-byte aligned
+//
+// Lookup hashes the name (XXH3-64), takes its top `bits` bits as the bucket
+// and compares the few entries of that bucket, so it is O(1) on average and
+// touches only the pages it reads. Images are returned as views into the
+// mapping and can be handed to SectionReader::open / decode_program as is.
+
+namespace qbin_bundle {
+
+    constexpr uint8_t kBundleMajor = 1;
+    constexpr uint8_t kBundleMinor = 0;
+    constexpr size_t kBundleHeaderSize = 32;
+    constexpr size_t kBundleEntrySize = 32;
+    constexpr uint32_t kMaxBucketBits = 30;
+    constexpr size_t kMaxNameLength = 0xFFFF;
+
+    // Hash of an image name as stored in the directory.
+    uint64_t name_hash(std::string_view name);
+
+    // Names are relative '/'-separated paths without empty, "." or ".."
+    // components (so unpacking cannot escape the output directory).
+    bool valid_name(std::string_view name);
+
+    // ---- Packing ----
+
+    struct BundleInput {
+        std::string name;
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+    };
+
+    struct PackStats {
+        size_t images = 0;
+        size_t unique_images = 0;      // images stored (equal contents are stored once)
+        uint64_t image_bytes = 0;      // sum of input sizes
+        uint64_t bundle_bytes = 0;
+    };
+
+    // Packs `inputs` into `out`. Every input must start with a well-formed
+    // QBIN header and section table; names must be valid and distinct. The
+    // output depends only on the set of (name, bytes) pairs and their order.
+    bool pack_bundle(const std::vector<BundleInput>& inputs, std::vector<uint8_t>& out,
+        std::string& err, PackStats* stats = nullptr);
+
+    // ---- Reading ----
+
+    // One directory entry; `name` and `data` point into the bundle.
+    struct BundleImage {
+        std::string_view name;
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        uint64_t content_hash = 0;     // XXH3-64 of the image bytes
+    };
+
+    // Read-only view of a bundle. open() checks the header, its CRC and the
+    // region sizes only; directory entries are bounds-checked when they are
+    // read. All accessors are const and may be called from several threads.
+    class Bundle {
+    public:
+        Bundle() = default;
+        ~Bundle();
+        Bundle(Bundle&& o) noexcept;
+        Bundle& operator=(Bundle&& o) noexcept;
+        Bundle(const Bundle&) = delete;
+        Bundle& operator=(const Bundle&) = delete;
+
+        // Maps the file read-only (reads it into memory where mmap is not
+        // available). Views stay valid until close() or destruction.
+        bool open(const std::string& path, std::string& err);
+        // Borrows `b`, which must outlive the bundle.
+        bool open(const uint8_t* b, size_t n, std::string& err);
+        void close();
+
+        size_t size() const { return count_; }
+        const uint8_t* data() const { return b_; }
+        size_t bytes() const { return n_; }
+
+        // Entry `i` in directory (name hash) order.
+        bool entry(size_t i, BundleImage& out, std::string& err) const;
+
+        // Image named `name`; false with "not found: <name>" if there is none.
+        bool find(std::string_view name, BundleImage& out, std::string& err) const;
+
+        // Recomputes the content hash of `img`.
+        static bool verify(const BundleImage& img);
+
+    private:
+        bool open_view(std::string& err);
+        uint32_t bucket_start(size_t b) const;
+
+        const uint8_t* b_ = nullptr;
+        size_t n_ = 0;
+        void* map_ = nullptr;               // owned mapping, if open(path) used mmap
+        size_t map_size_ = 0;
+        std::vector<uint8_t> owned_;        // owned copy otherwise
+        uint32_t count_ = 0;
+        uint32_t bits_ = 0;
+        size_t dir_off_ = 0, names_off_ = 0, names_size_ = 0, images_off_ = 0;
+    };
+
+} // namespace qbin_bundle
+
+#endif // QBIN_BUNDLE_BUNDLE_HPP
@@ -0,0 +1,206 @@
+#include "qbin_bundle/bundle.hpp"
+
+#include "qbin_compiler/encoder.hpp"
+#include "qbin_compiler/hash.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <utility>
+
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace qbin_bundle {
+
+    static inline uint32_t rd_u32le(const uint8_t* p) {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    static inline uint64_t rd_u64le(const uint8_t* p) {
+        return uint64_t(rd_u32le(p)) | (uint64_t(rd_u32le(p + 4)) << 32);
+    }
+
+    static inline uint64_t align8(uint64_t v) { return (v + 7) & ~uint64_t(7); }
+
+    uint64_t name_hash(std::string_view name) {
+        return qbin_compiler::xxh3_64(name.data(), name.size());
+    }
+
+    bool valid_name(std::string_view name) {
+        if (name.empty() || name.size() > kMaxNameLength || name.front() == '/') return false;
+        size_t start = 0;
+        while (start <= name.size()) {
+            size_t end = name.find('/', start);
+            if (end == std::string_view::npos) end = name.size();
+            const std::string_view part = name.substr(start, end - start);
+            if (part.empty() || part == "." || part == "..") return false;
+            if (part.find('\\') != std::string_view::npos || part.find('\0') != std::string_view::npos) return false;
+            start = end + 1;
+        }
+        return true;
+    }
+
+    Bundle::~Bundle() { close(); }
+
+    Bundle::Bundle(Bundle&& o) noexcept { *this = std::move(o); }
+
+    Bundle& Bundle::operator=(Bundle&& o) noexcept {
+        if (this == &o) return *this;
+        close();
+        b_ = o.b_;
+        n_ = o.n_;
+        map_ = o.map_;
+        map_size_ = o.map_size_;
+        owned_ = std::move(o.owned_);
+        count_ = o.count_;
+        bits_ = o.bits_;
+        dir_off_ = o.dir_off_;
+        names_off_ = o.names_off_;
+        names_size_ = o.names_size_;
+        images_off_ = o.images_off_;
+        o.map_ = nullptr;
+        o.map_size_ = 0;
+        o.close();
+        return *this;
+    }
+
+    void Bundle::close() {
+#if !defined(_WIN32)
+        if (map_) munmap(map_, map_size_);
+#endif
+        map_ = nullptr;
+        map_size_ = 0;
+        owned_.clear();
+        owned_.shrink_to_fit();
+        b_ = nullptr;
+        n_ = 0;
+        count_ = 0;
+        bits_ = 0;
+        dir_off_ = names_off_ = names_size_ = images_off_ = 0;
+    }
+
+    bool Bundle::open(const std::string& path, std::string& err) {
+        close();
+#if !defined(_WIN32)
+        const int fd = ::open(path.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) { err = "cannot open " + path + ": " + std::strerror(errno); return false; }
+        struct stat st;
+        if (fstat(fd, &st) != 0) {
+            err = "cannot stat " + path + ": " + std::strerror(errno);
+            ::close(fd);
+            return false;
+        }
+        if (st.st_size < off_t(kBundleHeaderSize)) {
+            ::close(fd);
+            err = "file too small for bundle header";
+            return false;
+        }
+        void* m = mmap(nullptr, size_t(st.st_size), PROT_READ, MAP_PRIVATE, fd, 0);
+        ::close(fd);
+        if (m == MAP_FAILED) { err = "cannot map " + path + ": " + std::strerror(errno); return false; }
+        // Lookups touch a few directory and image pages each; no read-ahead
+        madvise(m, size_t(st.st_size), MADV_RANDOM);
+        map_ = m;
+        map_size_ = size_t(st.st_size);
+        b_ = static_cast<const uint8_t*>(m);
+        n_ = map_size_;
+#else
+        std::ifstream f(path, std::ios::binary);
+        if (!f) { err = "cannot open " + path; return false; }
+        owned_.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+        b_ = owned_.data();
+        n_ = owned_.size();
+#endif
+        if (!open_view(err)) { close(); return false; }
+        return true;
+    }
+
+    bool Bundle::open(const uint8_t* b, size_t n, std::string& err) {
+        close();
+        b_ = b;
+        n_ = n;
+        if (!open_view(err)) { close(); return false; }
+        return true;
+    }
+
+    bool Bundle::open_view(std::string& err) {
+        if (!b_ || n_ < kBundleHeaderSize) { err = "file too small for bundle header"; return false; }
+        if (std::memcmp(b_, "QBND", 4) != 0) { err = "bad bundle magic"; return false; }
+        if (b_[4] != kBundleMajor) { err = "unsupported bundle version " + std::to_string(b_[4]); return false; }
+        if (qbin_compiler::enc::crc32c(b_, 0x1C) != rd_u32le(b_ + 0x1C)) { err = "bundle header CRC mismatch"; return false; }
+        const uint32_t count = rd_u32le(b_ + 0x08);
+        const uint32_t bits = rd_u32le(b_ + 0x0C);
+        const uint32_t names_size = rd_u32le(b_ + 0x10);
+        const uint32_t images_off = rd_u32le(b_ + 0x14);
+        if (bits > kMaxBucketBits) { err = "bucket bits out of range"; return false; }
+        const uint64_t index_size = ((uint64_t(1) << bits) + 1) * 4;
+        const uint64_t dir_off = align8(kBundleHeaderSize + index_size);
+        const uint64_t names_off = dir_off + uint64_t(count) * kBundleEntrySize;
+        const uint64_t names_end = names_off + names_size;
+        if (names_end > n_) { err = "bundle directory out of bounds"; return false; }
+        if (images_off < names_end || images_off > n_ || images_off % 8 != 0) { err = "bad images offset"; return false; }
+        if (rd_u32le(b_ + kBundleHeaderSize + (index_size - 4)) != count) { err = "bucket index does not cover the directory"; return false; }
+        count_ = count;
+        bits_ = bits;
+        dir_off_ = size_t(dir_off);
+        names_off_ = size_t(names_off);
+        names_size_ = names_size;
+        images_off_ = images_off;
+        return true;
+    }
+
+    uint32_t Bundle::bucket_start(size_t b) const {
+        return rd_u32le(b_ + kBundleHeaderSize + b * 4);
+    }
+
+    bool Bundle::entry(size_t i, BundleImage& out, std::string& err) const {
+        if (i >= count_) { err = "entry " + std::to_string(i) + " out of range"; return false; }
+        const uint8_t* e = b_ + dir_off_ + i * kBundleEntrySize;
+        const uint64_t off = rd_u64le(e + 16);
+        const uint32_t size = rd_u32le(e + 24);
+        const uint32_t name_off = rd_u32le(e + 28);
+        if (uint64_t(name_off) + 2 > names_size_) { err = "entry " + std::to_string(i) + ": name out of bounds"; return false; }
+        const uint8_t* np = b_ + names_off_ + name_off;
+        const size_t name_len = size_t(np[0]) | (size_t(np[1]) << 8);
+        if (uint64_t(name_off) + 2 + name_len > names_size_) { err = "entry " + std::to_string(i) + ": name out of bounds"; return false; }
+        if (off < images_off_ || off % 8 != 0 || off > n_ || size > n_ - off) {
+            err = "entry " + std::to_string(i) + ": image out of bounds";
+            return false;
+        }
+        out.name = std::string_view(reinterpret_cast<const char*>(np + 2), name_len);
+        out.data = b_ + off;
+        out.size = size;
+        out.content_hash = rd_u64le(e + 8);
+        return true;
+    }
+
+    bool Bundle::find(std::string_view name, BundleImage& out, std::string& err) const {
+        if (!b_) { err = "bundle is not open"; return false; }
+        const uint64_t h = name_hash(name);
+        const size_t b = bits_ ? size_t(h >> (64 - bits_)) : 0;
+        const uint32_t lo = bucket_start(b), hi = bucket_start(b + 1);
+        if (lo > hi || hi > count_) { err = "corrupt bucket index"; return false; }
+        for (uint32_t i = lo; i < hi; ++i) {
+            const uint64_t eh = rd_u64le(b_ + dir_off_ + size_t(i) * kBundleEntrySize);
+            if (eh < h) continue;
+            if (eh > h) break;
+            if (!entry(i, out, err)) return false;
+            if (out.name == name) return true;
+        }
+        out = BundleImage();
+        err = "not found: " + std::string(name);
+        return false;
+    }
+
+    bool Bundle::verify(const BundleImage& img) {
+        return qbin_compiler::xxh3_64(img.data, img.size) == img.content_hash;
+    }
+
+} // namespace qbin_bundle
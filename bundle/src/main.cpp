@@ -0,0 +1,228 @@
+// main.cpp - qbin-bundle: pack QBIN files into a QBND bundle, and read them back
+
+#include "qbin_bundle/bundle.hpp"
+#include "qbin_decompiler/compression.hpp"
+#include "qbin_decompiler/section_reader.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static void print_usage(const char* argv0) {
+    std::cerr
+        << "Usage:\n"
+        << "  " << argv0 << " pack -o <out.qbnd> <file.qbin|dir>... [--verbose]\n"
+        << "  " << argv0 << " unpack <in.qbnd> -o <dir>\n"
+        << "  " << argv0 << " list <in.qbnd>\n"
+        << "  " << argv0 << " get <in.qbnd> <name> [-o <out.qbin>]\n"
+        << "  " << argv0 << " verify <in.qbnd> [--dict <file>]...\n"
+        << "\n"
+        << "pack stores each file under its file name, and every *.qbin file below a\n"
+        << "directory under its path relative to that directory. Equal images are\n"
+        << "stored once. verify checks every content hash and decodes every image\n"
+        << "in place.\n";
+}
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool write_file(const std::string& path, const void* data, size_t n) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    f.write(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+    return bool(f);
+}
+
+static bool open_bundle(const std::string& path, qbin_bundle::Bundle& b) {
+    std::string err;
+    if (b.open(path, err)) return true;
+    std::cerr << path << ": " << err << "\n";
+    return false;
+}
+
+static int cmd_pack(int argc, char** argv) {
+    std::string out_path;
+    bool verbose = false;
+    std::vector<std::string> args;
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-o" && i + 1 < argc) out_path = argv[++i];
+        else if (a == "--verbose" || a == "-v") verbose = true;
+        else if (!a.empty() && a[0] == '-') { std::cerr << "Unknown option: " << a << "\n"; return 1; }
+        else args.push_back(a);
+    }
+    if (out_path.empty() || args.empty()) { print_usage(argv[0]); return 1; }
+
+    // (name, path); directory walks are sorted so that the bundle does not
+    // depend on directory iteration order
+    std::vector<std::pair<std::string, std::string>> files;
+    for (const auto& in : args) {
+        std::error_code ec;
+        if (fs::is_directory(in, ec)) {
+            std::vector<std::pair<std::string, std::string>> found;
+            for (auto it = fs::recursive_directory_iterator(in, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (it->is_regular_file(ec) && it->path().extension() == ".qbin") {
+                    found.emplace_back(it->path().lexically_relative(in).generic_string(), it->path().string());
+                }
+            }
+            if (ec) { std::cerr << "Cannot walk " << in << ": " << ec.message() << "\n"; return 1; }
+            std::sort(found.begin(), found.end());
+            files.insert(files.end(), found.begin(), found.end());
+        }
+        else {
+            files.emplace_back(fs::path(in).filename().generic_string(), in);
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> data(files.size());
+    std::vector<qbin_bundle::BundleInput> inputs(files.size());
+    for (size_t i = 0; i < files.size(); ++i) {
+        if (!read_file(files[i].second, data[i])) { std::cerr << "Cannot open input: " << files[i].second << "\n"; return 1; }
+        inputs[i].name = files[i].first;
+        inputs[i].data = data[i].data();
+        inputs[i].size = data[i].size();
+    }
+
+    std::vector<uint8_t> out;
+    std::string err;
+    qbin_bundle::PackStats stats;
+    if (!qbin_bundle::pack_bundle(inputs, out, err, &stats)) { std::cerr << "Error: " << err << "\n"; return 1; }
+    if (!write_file(out_path, out.data(), out.size())) { std::cerr << "Write failed: " << out_path << "\n"; return 1; }
+    if (verbose) {
+        std::fprintf(stderr, "images:  %zu (%zu stored)\n", stats.images, stats.unique_images);
+        std::fprintf(stderr, "bytes:   %llu in, %llu bundle\n",
+            (unsigned long long)stats.image_bytes, (unsigned long long)stats.bundle_bytes);
+    }
+    return 0;
+}
+
+static int cmd_unpack(int argc, char** argv) {
+    std::string in_path, out_dir;
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-o" && i + 1 < argc) out_dir = argv[++i];
+        else if (in_path.empty() && !a.empty() && a[0] != '-') in_path = a;
+        else { std::cerr << "Unknown arg: " << a << "\n"; return 1; }
+    }
+    if (in_path.empty() || out_dir.empty()) { print_usage(argv[0]); return 1; }
+    qbin_bundle::Bundle b;
+    if (!open_bundle(in_path, b)) return 1;
+    for (size_t i = 0; i < b.size(); ++i) {
+        qbin_bundle::BundleImage img;
+        std::string err;
+        if (!b.entry(i, img, err)) { std::cerr << in_path << ": " << err << "\n"; return 1; }
+        // Names come from the file; never write outside out_dir
+        if (!qbin_bundle::valid_name(img.name)) { std::cerr << in_path << ": entry " << i << ": invalid name\n"; return 1; }
+        const fs::path dst = fs::path(out_dir) / fs::path(std::string(img.name));
+        std::error_code ec;
+        fs::create_directories(dst.parent_path(), ec);
+        if (!write_file(dst.string(), img.data, img.size)) { std::cerr << "Write failed: " << dst.string() << "\n"; return 1; }
+    }
+    return 0;
+}
+
+static int cmd_list(int argc, char** argv) {
+    if (argc != 3) { print_usage(argv[0]); return 1; }
+    qbin_bundle::Bundle b;
+    if (!open_bundle(argv[2], b)) return 1;
+    std::vector<qbin_bundle::BundleImage> imgs(b.size());
+    for (size_t i = 0; i < b.size(); ++i) {
+        std::string err;
+        if (!b.entry(i, imgs[i], err)) { std::cerr << argv[2] << ": " << err << "\n"; return 1; }
+    }
+    std::sort(imgs.begin(), imgs.end(), [](const auto& x, const auto& y) { return x.name < y.name; });
+    for (const auto& img : imgs) {
+        std::printf("%10zu  %016llx  %.*s\n", img.size, (unsigned long long)img.content_hash,
+            int(img.name.size()), img.name.data());
+    }
+    return 0;
+}
+
+static int cmd_get(int argc, char** argv) {
+    std::string in_path, name, out_path;
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-o" && i + 1 < argc) out_path = argv[++i];
+        else if (in_path.empty()) in_path = a;
+        else if (name.empty()) name = a;
+        else { std::cerr << "Unknown arg: " << a << "\n"; return 1; }
+    }
+    if (in_path.empty() || name.empty()) { print_usage(argv[0]); return 1; }
+    qbin_bundle::Bundle b;
+    if (!open_bundle(in_path, b)) return 1;
+    qbin_bundle::BundleImage img;
+    std::string err;
+    if (!b.find(name, img, err)) { std::cerr << in_path << ": " << err << "\n"; return 1; }
+    if (out_path.empty()) {
+        std::cout.write(reinterpret_cast<const char*>(img.data), static_cast<std::streamsize>(img.size));
+        return std::cout ? 0 : 1;
+    }
+    if (!write_file(out_path, img.data, img.size)) { std::cerr << "Write failed: " << out_path << "\n"; return 1; }
+    return 0;
+}
+
+static int cmd_verify(int argc, char** argv) {
+    std::string in_path, err;
+    qbin_decompiler::DictionarySet dicts;
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "--dict" && i + 1 < argc) {
+            if (!dicts.add_file(argv[++i], err)) { std::cerr << err << "\n"; return 1; }
+        }
+        else if (in_path.empty() && !a.empty() && a[0] != '-') in_path = a;
+        else { std::cerr << "Unknown arg: " << a << "\n"; return 1; }
+    }
+    if (in_path.empty()) { print_usage(argv[0]); return 1; }
+    qbin_bundle::Bundle b;
+    if (!open_bundle(in_path, b)) return 1;
+    size_t bad = 0;
+    for (size_t i = 0; i < b.size(); ++i) {
+        qbin_bundle::BundleImage img;
+        if (!b.entry(i, img, err)) { std::cerr << in_path << ": " << err << "\n"; ++bad; continue; }
+        const std::string name(img.name);
+        qbin_bundle::BundleImage found;
+        if (!b.find(img.name, found, err) || found.data != img.data) {
+            std::cerr << name << ": not reachable through the bucket index\n";
+            ++bad;
+            continue;
+        }
+        if (!qbin_bundle::Bundle::verify(img)) { std::cerr << name << ": content hash mismatch\n"; ++bad; continue; }
+        // Decoded straight from the mapping
+        qbin_decompiler::SectionReader r;
+        const std::vector<qbin_decompiler::DecodedInstr>* instrs = nullptr;
+        if (!r.open(img.data, img.size, err, false, dicts.size() ? &dicts : nullptr) || !r.instrs(instrs, err)) {
+            std::cerr << name << ": " << err << "\n";
+            ++bad;
+        }
+    }
+    if (bad) { std::cerr << bad << " of " << b.size() << " images failed\n"; return 1; }
+    std::printf("%zu images OK\n", b.size());
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { print_usage(argv[0]); return 1; }
+    const std::string cmd = argv[1];
+    if (cmd == "pack") return cmd_pack(argc, argv);
+    if (cmd == "unpack") return cmd_unpack(argc, argv);
+    if (cmd == "list") return cmd_list(argc, argv);
+    if (cmd == "get") return cmd_get(argc, argv);
+    if (cmd == "verify") return cmd_verify(argc, argv);
+    if (cmd == "-h" || cmd == "--help") { print_usage(argv[0]); return 0; }
+    std::cerr << "Unknown command: " << cmd << "\n";
+    print_usage(argv[0]);
+    return 1;
+}
@@ -0,0 +1,159 @@
+#include "qbin_bundle/bundle.hpp"
+
+#include "qbin_compiler/encoder.hpp"
+#include "qbin_compiler/hash.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+namespace qbin_bundle {
+
+    static inline void put_u32le(uint8_t* p, uint32_t v) {
+        p[0] = uint8_t(v);
+        p[1] = uint8_t(v >> 8);
+        p[2] = uint8_t(v >> 16);
+        p[3] = uint8_t(v >> 24);
+    }
+
+    static inline void put_u64le(uint8_t* p, uint64_t v) {
+        put_u32le(p, uint32_t(v));
+        put_u32le(p + 4, uint32_t(v >> 32));
+    }
+
+    static inline uint64_t align8(uint64_t v) { return (v + 7) & ~uint64_t(7); }
+
+    // Smallest b with 2^b >= count: about one entry per bucket.
+    static uint32_t bucket_bits_for(size_t count) {
+        uint32_t bits = 0;
+        while (bits < kMaxBucketBits && (size_t(1) << bits) < count) ++bits;
+        return bits;
+    }
+
+    bool pack_bundle(const std::vector<BundleInput>& inputs, std::vector<uint8_t>& out,
+        std::string& err, PackStats* stats) {
+        out.clear();
+        if (inputs.size() > 0xFFFFFFFFull) { err = "too many images"; return false; }
+
+        struct Item {
+            uint64_t name_hash;
+            uint64_t content_hash;
+            size_t input;
+            size_t image;       // index into `stored`
+        };
+        std::vector<Item> items;
+        items.reserve(inputs.size());
+        std::vector<size_t> stored;                         // input index of each stored image
+        std::unordered_multimap<uint64_t, size_t> by_content;   // content hash -> index into `stored`
+        uint64_t image_bytes = 0;
+        for (size_t i = 0; i < inputs.size(); ++i) {
+            const BundleInput& in = inputs[i];
+            if (!valid_name(in.name)) { err = "invalid image name: '" + in.name + "'"; return false; }
+            if (in.size > 0xFFFFFFFFull) { err = in.name + ": image too large"; return false; }
+            uint8_t major = 0, minor = 0;
+            uint32_t table_off = 0, table_size = 0;
+            std::vector<qbin_decompiler::SectionEntry> table;
+            if (!qbin_decompiler::decode_header_and_table(in.data, in.size, major, minor, table_off, table_size, table, err, false)) {
+                err = in.name + ": " + err;
+                return false;
+            }
+            Item it{ name_hash(in.name), qbin_compiler::xxh3_64(in.data, in.size), i, stored.size() };
+            auto range = by_content.equal_range(it.content_hash);
+            for (auto r = range.first; r != range.second; ++r) {
+                const BundleInput& prev = inputs[stored[r->second]];
+                if (prev.size == in.size && std::memcmp(prev.data, in.data, in.size) == 0) {
+                    it.image = r->second;
+                    break;
+                }
+            }
+            if (it.image == stored.size()) {
+                by_content.emplace(it.content_hash, stored.size());
+                stored.push_back(i);
+            }
+            image_bytes += in.size;
+            items.push_back(it);
+        }
+
+        // Directory order: name hash, then name (equal names are rejected)
+        std::sort(items.begin(), items.end(), [&](const Item& a, const Item& b) {
+            if (a.name_hash != b.name_hash) return a.name_hash < b.name_hash;
+            return inputs[a.input].name < inputs[b.input].name;
+        });
+        for (size_t k = 1; k < items.size(); ++k) {
+            if (items[k].name_hash == items[k - 1].name_hash && inputs[items[k].input].name == inputs[items[k - 1].input].name) {
+                err = "duplicate image name: '" + inputs[items[k].input].name + "'";
+                return false;
+            }
+        }
+
+        const uint32_t count = uint32_t(items.size());
+        const uint32_t bits = bucket_bits_for(items.size());
+        const size_t buckets = size_t(1) << bits;
+        uint64_t names_size = 0;
+        for (const Item& it : items) names_size += 2 + inputs[it.input].name.size();
+        if (names_size > 0xFFFFFFFFull) { err = "names too large"; return false; }
+        const uint64_t index_size = (uint64_t(buckets) + 1) * 4;
+        const uint64_t dir_off = align8(kBundleHeaderSize + index_size);
+        const uint64_t names_off = dir_off + uint64_t(count) * kBundleEntrySize;
+        const uint64_t images_off = align8(names_off + names_size);
+        if (images_off > 0xFFFFFFFFull) { err = "directory too large"; return false; }
+
+        std::vector<uint64_t> image_off(stored.size());
+        uint64_t end = images_off;
+        for (size_t s = 0; s < stored.size(); ++s) {
+            image_off[s] = end;
+            end = align8(end + inputs[stored[s]].size);
+        }
+        out.assign(size_t(end), 0);
+        uint8_t* b = out.data();
+
+        std::memcpy(b, "QBND", 4);
+        b[4] = kBundleMajor;
+        b[5] = kBundleMinor;
+        put_u32le(b + 0x08, count);
+        put_u32le(b + 0x0C, bits);
+        put_u32le(b + 0x10, uint32_t(names_size));
+        put_u32le(b + 0x14, uint32_t(images_off));
+        put_u32le(b + 0x1C, qbin_compiler::enc::crc32c(b, 0x1C));
+
+        // Bucket index: first entry of each bucket, then `count`
+        size_t k = 0;
+        for (size_t bucket = 0; bucket <= buckets; ++bucket) {
+            while (k < items.size() && (bits ? size_t(items[k].name_hash >> (64 - bits)) : 0) < bucket) ++k;
+            put_u32le(b + kBundleHeaderSize + bucket * 4, uint32_t(k));
+        }
+
+        uint64_t name_pos = 0;
+        for (size_t i = 0; i < items.size(); ++i) {
+            const Item& it = items[i];
+            const BundleInput& in = inputs[it.input];
+            uint8_t* e = b + dir_off + i * kBundleEntrySize;
+            put_u64le(e + 0, it.name_hash);
+            put_u64le(e + 8, it.content_hash);
+            put_u64le(e + 16, image_off[it.image]);
+            put_u32le(e + 24, uint32_t(in.size));
+            put_u32le(e + 28, uint32_t(name_pos));
+            uint8_t* np = b + names_off + name_pos;
+            np[0] = uint8_t(in.name.size());
+            np[1] = uint8_t(in.name.size() >> 8);
+            std::memcpy(np + 2, in.name.data(), in.name.size());
+            name_pos += 2 + in.name.size();
+        }
+        for (size_t s = 0; s < stored.size(); ++s) {
+            const BundleInput& in = inputs[stored[s]];
+            if (in.size) std::memcpy(b + image_off[s], in.data, in.size);
+        }
+
+        if (stats) {
+            stats->images = items.size();
+            stats->unique_images = stored.size();
+            stats->image_bytes = image_bytes;
+            stats->bundle_bytes = out.size();
+        }
+        return true;
+    }
+
+} // namespace qbin_bundle
@@ -0,0 +1,74 @@
+#ifndef QBIN_COMPILER_CACHE_HPP
+#define QBIN_COMPILER_CACHE_HPP
+
+#include "qbin_compiler/compiler.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// On-disk compile cache: <dir>/<16 hex digits>.qbin holds the output for one
+// (input bytes, compiler version, options) key. Entries are written to a
+// temporary file and renamed into place, so concurrent compilers never see a
+// partial entry. A hit refreshes the entry mtime; after each store the
+// oldest entries are evicted until the directory fits the size bound.
+
+namespace qbin_compiler {
+
+    struct CacheStats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        uint64_t stores = 0;
+        uint64_t evictions = 0;     // entries removed by the size bound
+    };
+
+    class CompileCache {
+    public:
+        static constexpr uint64_t kDefaultMaxBytes = 256ull << 20;
+
+        explicit CompileCache(std::string dir, uint64_t max_bytes = kDefaultMaxBytes);
+
+        // Creates the directory if needed.
+        bool open(std::string& err);
+
+        // xxh3-64 over the compiler version, the options that affect output
+        // and the input text.
+        static uint64_t make_key(const std::string& qasm_text, const CompileOptions& opts);
+
+        // True on hit. Unreadable or corrupt entries count as misses and are
+        // removed.
+        bool lookup(uint64_t key, std::vector<uint8_t>& out);
+
+        // Atomically publishes `blob` under `key`, then enforces the size bound.
+        bool store(uint64_t key, const std::vector<uint8_t>& blob, std::string& err);
+
+        // Counters of this instance.
+        const CacheStats& stats() const { return stats_; }
+
+        // Cumulative counters kept in <dir>/stats. Updates from concurrent
+        // processes may be lost, so treat the totals as approximate.
+        bool read_totals(CacheStats& out) const;
+        void add_to_totals() const;
+
+        // Bytes currently held by entries.
+        uint64_t disk_usage() const;
+
+        const std::string& dir() const { return dir_; }
+        std::string entry_path(uint64_t key) const;
+
+    private:
+        void evict();
+
+        std::string dir_;
+        uint64_t max_bytes_;
+        CacheStats stats_;
+    };
+
+    // Parses "<n>[K|M|G]" (binary units). Returns false on malformed input.
+    bool parse_byte_size(const std::string& s, uint64_t& out);
+
+} // namespace qbin_compiler
+
+#endif // QBIN_COMPILER_CACHE_HPP
@@ -1,6 +1,7 @@
 #ifndef QBIN_COMPILER_COMPILER_HPP
 #define QBIN_COMPILER_COMPILER_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
@@ -12,14 +13,50 @@
 
 namespace qbin_compiler {
 
+// Compiler version ("major.minor.patch"). Part of the compile cache key, so
+// bump it whenever the same input and options can encode differently.
+const char* compiler_version();
+
 // Compile a subset of OpenQASM text into a QBIN blob.
 // On success, returns the full .qbin file bytes.
 // Notes:
 //  - Unsupported statements are skipped (best-effort).
-//  - The output contains a single INST section; optional sections (STRS, META, etc.)
-//    are omitted in this MVP.
+//  - An operand outside its declared register throws std::runtime_error.
+//  - The output holds INST, preceded by QUBS/BITS (and STRS for register
+//    names other than q / c) when the source declares registers; META and
+//    the other optional sections are omitted in this MVP.
 std::vector<uint8_t> compile_qasm_to_qbin_min(const std::string& qasm_text, bool verbose);
 
+// Options for the optional pass pipeline run between parsing and encoding.
+// Defaults reproduce compile_qasm_to_qbin_min() byte for byte.
+struct CompileOptions {
+    int opt_level = 0;      // 0 = encode verbatim, 1 = peephole, 2 = 1 + all encoding passes
+    bool fuse_1q = false;       // fold single-qubit runs into U (fewer instructions, not fewer bytes)
+    bool intern_angles = false; // PARS angle deduplication (implied by opt_level >= 2)
+    bool dedup_gates = false;   // GATE/CALLG subcircuit deduplication (implied by opt_level >= 2)
+    bool delta_operands = false; // INST qubit operands as deltas to the previous instruction (spec 7.7.4)
+    int compress_level = 0;     // > 0: zstd level for PARS/GATE/INST, each kept only if smaller (spec 8)
+    const std::vector<uint8_t>* dict = nullptr; // zstd dictionary for compression, named by a CPRS section
+    bool embed_dict = false;    // store the dictionary in CPRS instead of only its id
+    bool debug_info = false;    // DEBG section mapping instructions to source lines/columns (spec 14)
+    bool verbose = false;
+};
+
+// Size report of one compilation.
+struct CompileStats {
+    size_t instrs_in = 0;           // instructions produced by the parser
+    size_t instrs_out = 0;          // instructions encoded
+    size_t bytes_unoptimized = 0;   // file size the -O0 pipeline would produce (uncompressed)
+    size_t bytes_out = 0;           // returned file size
+};
+
+// Same as compile_qasm_to_qbin_min(), with optimization passes.
+// If stats is non-null it is filled; this costs one extra encode of the
+// unoptimized program to measure bytes_unoptimized.
+std::vector<uint8_t> compile_qasm_to_qbin(const std::string& qasm_text,
+    const CompileOptions& opts,
+    CompileStats* stats = nullptr);
+
 } // namespace qbin_compiler
 
 #endif // QBIN_COMPILER_COMPILER_HPP
@@ -0,0 +1,45 @@
+#ifndef QBIN_COMPILER_COMPRESS_HPP
+#define QBIN_COMPILER_COMPRESS_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Section compression writers (spec 8) and the CPRS dictionary section
+// (spec 7.8). zstd is optional at build time: without it zstd_available()
+// is false, compress_payload() and train_dictionary() fail, and the compiler
+// writes uncompressed files.
+
+namespace qbin_compiler {
+    namespace enc {
+
+        bool zstd_available();
+
+        // zstd dictionary id (header magic EC30A437, then the id); 0 if `dict`
+        // is not a zstd dictionary.
+        uint32_t dict_id(const uint8_t* dict, size_t n);
+
+        // CPRZ wrapper around a zstd frame of `payload`: u32 "CPRZ", u8 alg = 1,
+        // u32 raw_size, frame. Frames omit the content size and dictionary id
+        // (CPRZ and CPRS carry them). `dict` may be null. Compression state for
+        // the last dictionary/level is kept per thread, so repeated calls with
+        // the same dictionary do not re-digest it.
+        bool compress_payload(const uint8_t* payload, size_t n, int level,
+            const uint8_t* dict, size_t dict_size,
+            std::vector<uint8_t>& out, std::string& err);
+
+        // CPRS payload naming the dictionary; with `embed` the dictionary bytes
+        // follow (varint length + bytes), otherwise readers must supply it.
+        void encode_cprs_section(const std::vector<uint8_t>& dict, bool embed, std::vector<uint8_t>& out);
+
+        // zstd dictionary of at most `capacity` bytes trained on `samples`
+        // (ZDICT_trainFromBuffer); zstd picks a non-zero dictionary id.
+        bool train_dictionary(const std::vector<std::vector<uint8_t>>& samples, size_t capacity,
+            std::vector<uint8_t>& dict, std::string& err);
+
+    } // namespace enc
+} // namespace qbin_compiler
+
+#endif // QBIN_COMPILER_COMPRESS_HPP
@@ -0,0 +1,140 @@
+#ifndef QBIN_COMPILER_ENCODER_HPP
+#define QBIN_COMPILER_ENCODER_HPP
+
+#include "qbin_compiler/qasm_frontend.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Byte-level QBIN writers: primitive encoders, section payload encoders and
+// the container assembler (header + section table + 8-byte aligned sections).
+
+namespace qbin_compiler {
+    namespace enc {
+
+        inline void push_u32_le(std::vector<uint8_t>& out, uint32_t v) {
+            out.push_back(static_cast<uint8_t>(v & 0xFF));
+            out.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
+            out.push_back(static_cast<uint8_t>((v >> 16) & 0xFF));
+            out.push_back(static_cast<uint8_t>((v >> 24) & 0xFF));
+        }
+        inline void push_bytes(std::vector<uint8_t>& out, const void* data, size_t n) {
+            const auto* p = static_cast<const uint8_t*>(data);
+            out.insert(out.end(), p, p + n);
+        }
+        inline void push_str(std::vector<uint8_t>& out, const char* s) {
+            push_bytes(out, s, std::strlen(s));
+        }
+        // ULEB128
+        inline void push_uleb128(std::vector<uint8_t>& out, uint64_t n) {
+            do {
+                uint8_t b = static_cast<uint8_t>(n & 0x7Fu);
+                n >>= 7;
+                if (n != 0) b |= 0x80u;
+                out.push_back(b);
+            } while (n != 0);
+        }
+        // SLEB128 (svarint)
+        inline void push_sleb128(std::vector<uint8_t>& out, int64_t n) {
+            for (;;) {
+                uint8_t b = static_cast<uint8_t>(n & 0x7F);
+                n >>= 7;   // arithmetic shift
+                if ((n == 0 && !(b & 0x40u)) || (n == -1 && (b & 0x40u))) { out.push_back(b); return; }
+                out.push_back(b | 0x80u);
+            }
+        }
+        inline size_t uleb128_size(uint64_t n) {
+            size_t len = 1;
+            while (n >= 0x80u) { n >>= 7; ++len; }
+            return len;
+        }
+        // Float32 (IEEE-754) write helper
+        inline void push_f32_le(std::vector<uint8_t>& out, float f) {
+            static_assert(sizeof(float) == 4, "float must be 32-bit");
+            uint32_t u;
+            std::memcpy(&u, &f, sizeof(u));
+            push_u32_le(out, u);
+        }
+
+        // CRC32C (Castagnoli), reflected poly 0x82F63B78
+        uint32_t crc32c(const uint8_t* data, size_t len);
+
+        // Section ID from its 4-character ASCII tag, as stored in the table.
+        inline uint32_t section_id(const char* tag) {
+            uint32_t id = 0;
+            std::memcpy(&id, tag, 4);
+            return id;
+        }
+
+        struct Section {
+            uint32_t id = 0;
+            std::vector<uint8_t> payload;
+            uint32_t flags = 0;
+        };
+
+        // One instruction record (opcode, operand mask, operands) as in spec 7.7.1.
+        void encode_instr(const frontend::Instr& I, std::vector<uint8_t>& out);
+
+        // Section table flags (spec 5.2). Bit 2 marks delta coding: qubit
+        // operands in INST (spec 7.7.4), mapping fields in DEBG (spec 14).
+        constexpr uint32_t kSectionCompressed = 1u << 0;
+        constexpr uint32_t kSectionDeltaOperands = 1u << 2;
+
+        // Full INST payload: magic, instr_count, records. With delta_operands
+        // the qubit operands are written as zigzag deltas (spec 7.7.4) and the
+        // section must carry kSectionDeltaOperands.
+        void encode_inst_section(const std::vector<frontend::Instr>& instrs, std::vector<uint8_t>& out,
+            bool delta_operands = false);
+
+        // STRS payload (spec 7.1); strs[0] should be "".
+        void encode_strs_section(const std::vector<std::string>& strs, std::vector<uint8_t>& out);
+
+        // One named range of a QUBS/BITS table.
+        struct RegisterAlias {
+            uint32_t first = 0;
+            uint32_t count = 0;
+            uint32_t name_str_id = 0;
+        };
+
+        // QUBS (spec 7.3, without layout) and BITS (spec 7.4) payloads: the
+        // size of the qubit/bit index space and its named ranges. With no
+        // aliases readers name the whole space q / c.
+        void encode_qubs_section(uint32_t qubit_count, const std::vector<RegisterAlias>& aliases,
+            std::vector<uint8_t>& out);
+        void encode_bits_section(uint32_t bit_count, const std::vector<RegisterAlias>& aliases,
+            std::vector<uint8_t>& out);
+
+        // PARS payload holding anonymous angle constants (name_str_id 0,
+        // kind 0 = angle, value_tag 1 = const_f32).
+        void encode_pars_section(const std::vector<float>& params, std::vector<uint8_t>& out);
+
+        // GATE payload: anonymous entries (name_str_id 0) without parameters,
+        // each with its body as an inline INST payload over formal qubits.
+        void encode_gate_section(const std::vector<frontend::GateDecl>& gates, std::vector<uint8_t>& out);
+
+        // DEBG payload in delta form (spec 14, section flag kSectionDeltaOperands)
+        // mapping instruction indices to Instr::line/column. One mapping per
+        // change of position; no source files are named (file_count 0).
+        // Returns false, writing nothing, if no instruction has a position.
+        bool encode_debg_section(const std::vector<frontend::Instr>& instrs, std::vector<uint8_t>& out);
+
+        // Header + section table + sections in the given order. Each section
+        // offset is 8-byte aligned (zero padding in between); the last section
+        // is not padded.
+        std::vector<uint8_t> assemble_qbin(const std::vector<Section>& sections);
+
+        // The bytes assemble_qbin() produces before the payload of its last
+        // section, for `head` followed by a section (`id`, `size` bytes,
+        // `flags`) that is not passed: writers build that payload in place
+        // behind a reserved prefix. The payload starts at the returned size.
+        std::vector<uint8_t> assemble_prefix(const std::vector<Section>& head,
+            uint32_t id, uint32_t size, uint32_t flags);
+
+    } // namespace enc
+} // namespace qbin_compiler
+
+#endif // QBIN_COMPILER_ENCODER_HPP
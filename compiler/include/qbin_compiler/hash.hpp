@@ -0,0 +1,17 @@
+#ifndef QBIN_COMPILER_HASH_HPP
+#define QBIN_COMPILER_HASH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// ASCII-only header.
+// XXH3-64 (seed 0, default secret), the non-cryptographic hash listed as
+// algorithm 2 in spec 5.3. Output matches the reference XXH3_64bits().
+
+namespace qbin_compiler {
+
+    uint64_t xxh3_64(const void* data, size_t len);
+
+} // namespace qbin_compiler
+
+#endif // QBIN_COMPILER_HASH_HPP
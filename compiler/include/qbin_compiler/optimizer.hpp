@@ -0,0 +1,83 @@
+#ifndef QBIN_COMPILER_OPTIMIZER_HPP
+#define QBIN_COMPILER_OPTIMIZER_HPP
+
+#include "qbin_compiler/qasm_frontend.hpp"
+
+#include <cstddef>
+
+// ASCII-only header.
+// IR-level optimization passes that run between parse_qasm_subset() and
+// encoding. Passes rewrite frontend::Program in place and never reorder
+// instructions; they only delete instructions or fold them into an earlier one.
+
+namespace qbin_compiler {
+    namespace opt {
+
+        struct PeepholeStats {
+            size_t cancelled = 0;   // instructions removed as inverse pairs
+            size_t merged = 0;      // rotations folded into an earlier rotation
+            size_t dropped = 0;     // zero-angle rotations and empty IF guards removed
+        };
+
+        // -O1 peephole pass. Linear time: keeps the last instruction seen on every
+        // qubit and walks that per-qubit chain (bounded) over gates that commute
+        // with the incoming one. Performs:
+        //  - cancellation of adjacent self-inverse / inverse pairs
+        //    (H H, X X, CX CX, CZ CZ, SWAP SWAP, S SDG, T TDG, SX SXDG, ...)
+        //  - merging of consecutive RX/RY/RZ/PHASE (and CRx/RXX/RYY/RZZ) on the
+        //    same operands
+        //  - removal of zero-angle rotations
+        // IF/ENDIF and BARRIER start a new region; MEASURE/RESET (and any
+        // instruction it does not model) block the chains of their qubits.
+        // Nothing is ever combined across those boundaries.
+        void peephole(frontend::Program& prog, PeepholeStats* stats = nullptr);
+
+        struct FuseStats {
+            size_t runs = 0;        // runs of 2+ single-qubit gates rewritten
+            size_t fused = 0;       // gates in those runs
+            size_t emitted = 0;     // U/PHASE instructions replacing them (identity runs emit none)
+        };
+
+        // Single-qubit fusion. Every maximal run of two or more literal
+        // single-qubit gates (X..PHASE, U) on one qubit is multiplied out as a
+        // 2x2 unitary and folded into its first gate as one U(theta, phi,
+        // lambda) (ZYZ decomposition, up to global phase); diagonal products
+        // become PHASE and the identity is dropped. A run ends at any other
+        // instruction on its qubit (multi-qubit gates, MEASURE, RESET, CALLG,
+        // ...) and at IF/ENDIF and BARRIER. Linear time. Works on prog.instrs
+        // only, so it runs before dedup_gates.
+        void fuse_1q(frontend::Program& prog, FuseStats* stats = nullptr);
+
+        struct InternStats {
+            size_t distinct = 0;    // distinct angle values after normalization
+            size_t interned = 0;    // values moved into prog.params
+            size_t refs = 0;        // angle slots rewritten to param_ref
+        };
+
+        // Angle deduplication. Normalizes literal angles to [-pi, pi) (spec 17.2;
+        // controlled rotations and CU's theta keep their 4*pi period and are
+        // left as is), then
+        // moves values into prog.params and marks their uses as param_ref when
+        // that makes the file smaller: a literal costs 5 bytes, a reference
+        // 1 + varint(id) bytes, a PARS entry 7 bytes plus the section overhead.
+        // Most frequent values get the lowest (shortest) ids.
+        void intern_angles(frontend::Program& prog, InternStats* stats = nullptr);
+
+        struct GateStats {
+            size_t templates = 0;   // GATE entries created
+            size_t calls = 0;       // CALLG instructions emitted
+            size_t folded = 0;      // instructions replaced by those calls
+        };
+
+        // Template deduplication. Finds repeated runs of 2..kMaxLen unitary
+        // gates that touch at most 3 distinct qubits (the CALLG operand slots)
+        // and are equal up to a renaming of those qubits, hoists the most
+        // profitable one into prog.gates and replaces its non-overlapping
+        // occurrences with CALLG. Repeats greedily while it still saves bytes.
+        // Runs never span IF/ENDIF, MEASURE, RESET or BARRIER.
+        void dedup_gates(frontend::Program& prog, GateStats* stats = nullptr);
+
+    } // namespace opt
+} // namespace qbin_compiler
+
+#endif // QBIN_COMPILER_OPTIMIZER_HPP
@@ -34,8 +34,23 @@ namespace qbin_compiler {
 
             // Angle slot 0
             bool has_angle0 = false;
-            bool angle0_is_param = false; // reserved
-            float angle0 = 0.0f;
+            bool angle0_is_param = false; // encode as param_ref (tag 1) to Program::params
+            float angle0 = 0.0f;          // always holds the value, also when interned
+            uint32_t angle0_param = 0;    // PARS index if angle0_is_param
+
+            // Angle slots 1 and 2 (phi, lambda of U/CU), same rules as slot 0
+            bool has_angle1 = false;
+            bool angle1_is_param = false;
+            float angle1 = 0.0f;
+            uint32_t angle1_param = 0;
+            bool has_angle2 = false;
+            bool angle2_is_param = false;
+            float angle2 = 0.0f;
+            uint32_t angle2_param = 0;
+
+            // param_ref slot (operand mask bit 6), e.g. CALLG gate_id
+            bool has_param_ref = false;
+            uint32_t param_ref = 0;
 
             // Aux 32-bit payload (e.g., classical bit index for MEASURE/IF)
             bool has_aux = false;
@@ -44,18 +59,56 @@ namespace qbin_compiler {
             // Small immediate byte (e.g., IF compare value 0/1)
             bool has_imm8 = false;
             uint8_t imm8 = 0;
+
+            // Source position of the statement (1-based; 0 = unknown). Only
+            // written to DEBG, never to INST.
+            uint32_t line = 0;
+            uint32_t column = 0;
+        };
+
+        // GATE table entry (spec 7.6). Body qubits are the formal arguments
+        // 0..num_qubits-1; CALLG binds them to its a/b/c operands in order.
+        struct GateDecl {
+            uint32_t num_qubits = 0;
+            std::vector<Instr> body;
+        };
+
+        // Declared register: qubits or bits first..first+size-1 of the flat
+        // index space the instructions use, in declaration order.
+        struct Register {
+            std::string name;
+            uint32_t first = 0;
+            uint32_t size = 0;
         };
 
+        // Size of the index space covered by `regs` (0 if none were declared).
+        inline uint32_t register_space(const std::vector<Register>& regs) {
+            return regs.empty() ? 0 : regs.back().first + regs.back().size;
+        }
+
         struct Program {
+            std::vector<Register> qregs;  // qubit[N] name; / qreg name[N];  (QUBS)
+            std::vector<Register> cregs;  // bit[N] name; / creg name[N];    (BITS)
             std::vector<Instr> instrs;
+            std::vector<float> params;    // PARS angle constants (filled by opt::intern_angles)
+            std::vector<GateDecl> gates;  // GATE entries called by CALLG (filled by opt::dedup_gates)
         };
 
         // Parse minimal OpenQASM subset used by the MVP compiler:
+        //  - qubit[N] q; / bit[N] c; (also `qubit q;`, qreg q[N]; / creg c[N];)
         //  - h/x/y/z/s/sdg/t/tdg/sx/sxdg q[i];
         //  - rx/ry/rz/phase(<angle>) q[i];
-        //  - cx/cz/swap q[i], q[j];
+        //  - u(<theta>, <phi>, <lambda>) q[i];
+        //  - cx/cz/swap q[i], q[j];  cu(<theta>, <phi>, <lambda>) q[i], q[j];
         //  - c[k] = measure q[i];
         //  - if (c[k] == 1) { <single stmt>; }     (also supports != 0/1)
+        // Operands name a declared register and are resolved to flat indices;
+        // an index outside its register throws std::runtime_error naming the
+        // line, the operand and the declared size (other malformed statements
+        // are skipped). Without declarations q[i] and c[k] are accepted for
+        // any i, k.
+        // Every instruction records the line and column of its statement; the
+        // IF, its body and ENDIF share the position of the `if`.
         Program parse_qasm_subset(std::string_view text, bool verbose);
 
     } // namespace frontend
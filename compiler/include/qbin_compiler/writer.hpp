@@ -0,0 +1,142 @@
+#ifndef QBIN_COMPILER_WRITER_HPP
+#define QBIN_COMPILER_WRITER_HPP
+
+#include "qbin_compiler/qasm_frontend.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <utility>
+#include <vector>
+
+// ASCII-only header.
+// Programmatic QBIN builder for circuit generators: typed gate calls are
+// encoded straight into INST records (same bytes as encode_inst_section), so
+// no QASM text is printed and parsed back.
+//
+//   qbin_compiler::Writer w(1000);
+//   w.h(0).cx(0, 1).rz(0.5f, 1).measure(1, 0);
+//   w.if_eq(0, true, [](qbin_compiler::Writer& b) { b.x(2); });
+//   std::vector<uint8_t> file = w.finish();
+//
+// Qubit and bit indices above INT32_MAX throw std::runtime_error; nothing
+// is written for that call.
+//
+// A Writer is move-only. Records are written behind a reserved file prefix
+// (header, section table, QUBS/BITS, INST magic and count), so finish() hands
+// out the Writer's own buffer as the file instead of copying it.
+
+namespace qbin_compiler {
+
+    class Writer {
+    public:
+        // Average INST record size of gate-level circuits, used by reserve().
+        static constexpr size_t kBytesPerInstr = 7;
+
+        Writer() { clear(); }
+        explicit Writer(size_t expected_instrs) { clear(); reserve(expected_instrs); }
+        Writer(Writer&& o) noexcept
+            : buf_(std::move(o.buf_)), count_(o.count_), num_qubits_(o.num_qubits_), num_bits_(o.num_bits_) { o.clear(); }
+        Writer& operator=(Writer&& o) noexcept {
+            if (this != &o) {
+                buf_ = std::move(o.buf_);
+                count_ = o.count_;
+                num_qubits_ = o.num_qubits_;
+                num_bits_ = o.num_bits_;
+                o.clear();
+            }
+            return *this;
+        }
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        void reserve(size_t instrs) { buf_.reserve(kPrefix + instrs * kBytesPerInstr); }
+
+        // Single-qubit gates
+        Writer& x(uint32_t q)    { return gate1(frontend::Opcode::X, q); }
+        Writer& y(uint32_t q)    { return gate1(frontend::Opcode::Y, q); }
+        Writer& z(uint32_t q)    { return gate1(frontend::Opcode::Z, q); }
+        Writer& h(uint32_t q)    { return gate1(frontend::Opcode::H, q); }
+        Writer& s(uint32_t q)    { return gate1(frontend::Opcode::S, q); }
+        Writer& sdg(uint32_t q)  { return gate1(frontend::Opcode::SDG, q); }
+        Writer& t(uint32_t q)    { return gate1(frontend::Opcode::T, q); }
+        Writer& tdg(uint32_t q)  { return gate1(frontend::Opcode::TDG, q); }
+        Writer& sx(uint32_t q)   { return gate1(frontend::Opcode::SX, q); }
+        Writer& sxdg(uint32_t q) { return gate1(frontend::Opcode::SXDG, q); }
+        Writer& rx(float theta, uint32_t q)    { return rot1(frontend::Opcode::RX, theta, q); }
+        Writer& ry(float theta, uint32_t q)    { return rot1(frontend::Opcode::RY, theta, q); }
+        Writer& rz(float theta, uint32_t q)    { return rot1(frontend::Opcode::RZ, theta, q); }
+        Writer& phase(float theta, uint32_t q) { return rot1(frontend::Opcode::PHASE, theta, q); }
+        Writer& u(float theta, float phi, float lambda, uint32_t q);
+
+        // Two-qubit gates (a = control for the controlled ones)
+        Writer& cx(uint32_t a, uint32_t b)   { return gate2(frontend::Opcode::CX, a, b); }
+        Writer& cz(uint32_t a, uint32_t b)   { return gate2(frontend::Opcode::CZ, a, b); }
+        Writer& ecr(uint32_t a, uint32_t b)  { return gate2(frontend::Opcode::ECR, a, b); }
+        Writer& swap(uint32_t a, uint32_t b) { return gate2(frontend::Opcode::SWAP, a, b); }
+        Writer& csx(uint32_t a, uint32_t b)  { return gate2(frontend::Opcode::CSX, a, b); }
+        Writer& crx(float theta, uint32_t a, uint32_t b) { return rot2(frontend::Opcode::CRX, theta, a, b); }
+        Writer& cry(float theta, uint32_t a, uint32_t b) { return rot2(frontend::Opcode::CRY, theta, a, b); }
+        Writer& crz(float theta, uint32_t a, uint32_t b) { return rot2(frontend::Opcode::CRZ, theta, a, b); }
+        Writer& rxx(float theta, uint32_t a, uint32_t b) { return rot2(frontend::Opcode::RXX, theta, a, b); }
+        Writer& ryy(float theta, uint32_t a, uint32_t b) { return rot2(frontend::Opcode::RYY, theta, a, b); }
+        Writer& rzz(float theta, uint32_t a, uint32_t b) { return rot2(frontend::Opcode::RZZ, theta, a, b); }
+        Writer& cu(float theta, float phi, float lambda, uint32_t a, uint32_t b);
+
+        // c[bit] = measure q[q]
+        Writer& measure(uint32_t q, uint32_t bit);
+        Writer& reset(uint32_t q) { return gate1(frontend::Opcode::RESET, q); }
+        Writer& barrier();
+
+        // if (c[bit] == value) { body } / if (c[bit] != value) { body }.
+        // `body` is called with this Writer; ENDIF is emitted after it returns.
+        template <class Body>
+        Writer& if_eq(uint32_t bit, bool value, Body&& body) {
+            begin_if(frontend::Opcode::IF_EQ, bit, value);
+            body(*this);
+            return end_if();
+        }
+        template <class Body>
+        Writer& if_neq(uint32_t bit, bool value, Body&& body) {
+            begin_if(frontend::Opcode::IF_NEQ, bit, value);
+            body(*this);
+            return end_if();
+        }
+
+        // Any other instruction, encoded by enc::encode_instr.
+        Writer& append(const frontend::Instr& in);
+
+        size_t instr_count() const { return count_; }
+        uint32_t num_qubits() const { return num_qubits_; }   // highest qubit operand + 1
+        uint32_t num_bits() const { return num_bits_; }       // highest bit index + 1
+
+        // Complete .qbin file (header, section table, QUBS/BITS sized by
+        // num_qubits()/num_bits(), INST), byte-identical to what
+        // compile_qasm_to_qbin_min() produces for the same instructions
+        // after `qubit[num_qubits()] q; bit[num_bits()] c;`. The Writer is
+        // empty afterwards.
+        std::vector<uint8_t> finish();
+
+        // Drops everything written so far (capacity is kept).
+        void clear();
+
+    private:
+        Writer& gate1(frontend::Opcode op, uint32_t q);
+        Writer& rot1(frontend::Opcode op, float theta, uint32_t q);
+        Writer& gate2(frontend::Opcode op, uint32_t a, uint32_t b);
+        Writer& rot2(frontend::Opcode op, float theta, uint32_t a, uint32_t b);
+        void begin_if(frontend::Opcode op, uint32_t bit, bool value);
+        Writer& end_if();
+
+        // Header, table of QUBS/BITS/INST, both tables (at most 11 bytes,
+        // padded to 16), INST magic and the longest instr_count varint
+        static constexpr size_t kPrefix = 24 + 3 * 16 + 2 * 16 + 4 + 10;
+
+        std::vector<uint8_t> buf_;   // kPrefix reserved bytes, then the INST records
+        size_t count_ = 0;
+        uint32_t num_qubits_ = 0;
+        uint32_t num_bits_ = 0;
+    };
+
+} // namespace qbin_compiler
+
+#endif // QBIN_COMPILER_WRITER_HPP
@@ -0,0 +1,253 @@
+#include "qbin_compiler/cache.hpp"
+#include "qbin_compiler/encoder.hpp"
+#include "qbin_compiler/hash.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <random>
+#include <sstream>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace qbin_compiler {
+
+    static const char* const kEntryExt = ".qbin";
+    static const char* const kTempMarker = ".tmp-";
+    static const char* const kStatsFile = "stats";
+
+    // Evict down to this fraction of the bound so that a full cache is not
+    // rescanned on every store.
+    static constexpr double kEvictLowWater = 0.9;
+    // Temporaries older than this were left behind by a killed compiler.
+    static constexpr auto kStaleTemp = std::chrono::hours(1);
+
+    static inline std::string hex64(uint64_t v) {
+        char buf[17];
+        std::snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(v));
+        return buf;
+    }
+
+    static inline bool ends_with(const std::string& s, const char* suffix) {
+        const size_t n = std::char_traits<char>::length(suffix);
+        return s.size() >= n && s.compare(s.size() - n, n, suffix) == 0;
+    }
+
+    // Header magic and CRC of a cached file; catches truncated or foreign entries.
+    static inline bool plausible_qbin(const std::vector<uint8_t>& b) {
+        if (b.size() < 24 || b[0] != 'Q' || b[1] != 'B' || b[2] != 'I' || b[3] != 'N') return false;
+        const uint32_t stored = (uint32_t)b[20] | ((uint32_t)b[21] << 8) | ((uint32_t)b[22] << 16) | ((uint32_t)b[23] << 24);
+        return enc::crc32c(b.data(), 0x14) == stored;
+    }
+
+    static inline std::string temp_suffix() {
+        static std::mt19937_64 rng{ std::random_device{}() ^
+            static_cast<uint64_t>(std::chrono::steady_clock::now().time_since_epoch().count()) };
+        return kTempMarker + hex64(rng());
+    }
+
+    // Write to a sibling temporary, then rename over `path`.
+    static bool write_atomic(const fs::path& path, const void* data, size_t n, std::string& err) {
+        fs::path tmp = path;
+        tmp += temp_suffix();
+        {
+            std::ofstream ofs(tmp, std::ios::binary | std::ios::trunc);
+            if (!ofs) { err = "cannot create " + tmp.string(); return false; }
+            ofs.write(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+            if (!ofs) {
+                ofs.close();
+                std::error_code ec;
+                fs::remove(tmp, ec);
+                err = "cannot write " + tmp.string();
+                return false;
+            }
+        }
+        std::error_code ec;
+        fs::rename(tmp, path, ec);
+        if (ec) {
+            fs::remove(tmp, ec);
+            err = "cannot rename into " + path.string();
+            return false;
+        }
+        return true;
+    }
+
+    CompileCache::CompileCache(std::string dir, uint64_t max_bytes)
+        : dir_(std::move(dir)), max_bytes_(max_bytes) {}
+
+    bool CompileCache::open(std::string& err) {
+        std::error_code ec;
+        fs::create_directories(dir_, ec);
+        if (ec || !fs::is_directory(dir_, ec)) {
+            err = "cannot create cache directory: " + dir_;
+            return false;
+        }
+        return true;
+    }
+
+    uint64_t CompileCache::make_key(const std::string& qasm_text, const CompileOptions& opts) {
+        // Only options that change the output bytes; verbose does not.
+        std::string k = "qbin-compile ";
+        k += compiler_version();
+        k += " O" + std::to_string(opts.opt_level);
+        k += opts.fuse_1q ? " fuse-1q" : "";
+        k += opts.intern_angles ? " intern-angles" : "";
+        k += opts.dedup_gates ? " dedup-gates" : "";
+        k += opts.delta_operands ? " delta-operands" : "";
+        k += opts.debug_info ? " debug-info" : "";
+        if (opts.compress_level > 0) {
+            k += " zstd" + std::to_string(opts.compress_level);
+            if (opts.dict && !opts.dict->empty()) {
+                k += " dict=" + hex64(xxh3_64(opts.dict->data(), opts.dict->size()));
+                k += opts.embed_dict ? " embed" : "";
+            }
+        }
+        k += '\n';
+        k += qasm_text;
+        return xxh3_64(k.data(), k.size());
+    }
+
+    std::string CompileCache::entry_path(uint64_t key) const {
+        return (fs::path(dir_) / (hex64(key) + kEntryExt)).string();
+    }
+
+    bool CompileCache::lookup(uint64_t key, std::vector<uint8_t>& out) {
+        const std::string path = entry_path(key);
+        std::ifstream ifs(path, std::ios::binary);
+        if (!ifs) { ++stats_.misses; return false; }
+        std::vector<uint8_t> buf((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+        if (!ifs.eof() && !ifs) { ++stats_.misses; return false; }
+        ifs.close();
+        if (!plausible_qbin(buf)) {
+            std::error_code ec;
+            fs::remove(path, ec);
+            ++stats_.misses;
+            return false;
+        }
+        // LRU: a hit makes the entry the newest
+        std::error_code ec;
+        fs::last_write_time(path, fs::file_time_type::clock::now(), ec);
+        out = std::move(buf);
+        ++stats_.hits;
+        return true;
+    }
+
+    bool CompileCache::store(uint64_t key, const std::vector<uint8_t>& blob, std::string& err) {
+        if (!write_atomic(entry_path(key), blob.data(), blob.size(), err)) return false;
+        ++stats_.stores;
+        evict();
+        return true;
+    }
+
+    uint64_t CompileCache::disk_usage() const {
+        uint64_t total = 0;
+        std::error_code ec;
+        for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+            if (!ends_with(it->path().filename().string(), kEntryExt)) continue;
+            std::error_code sec;
+            const uintmax_t sz = it->file_size(sec);
+            if (!sec) total += sz;
+        }
+        return total;
+    }
+
+    void CompileCache::evict() {
+        struct Entry { fs::file_time_type mtime; uint64_t size; fs::path path; };
+        std::vector<Entry> entries;
+        uint64_t total = 0;
+        const auto now = fs::file_time_type::clock::now();
+
+        std::error_code ec;
+        for (fs::directory_iterator it(dir_, ec), end; !ec && it != end; it.increment(ec)) {
+            const std::string name = it->path().filename().string();
+            std::error_code sec;
+            const auto mtime = it->last_write_time(sec);
+            if (sec) continue;
+            if (name.find(kTempMarker) != std::string::npos) {
+                if (now - mtime > kStaleTemp) fs::remove(it->path(), sec);
+                continue;
+            }
+            if (!ends_with(name, kEntryExt)) continue;
+            const uintmax_t sz = it->file_size(sec);
+            if (sec) continue;
+            entries.push_back({ mtime, static_cast<uint64_t>(sz), it->path() });
+            total += sz;
+        }
+        if (total <= max_bytes_) return;
+
+        std::sort(entries.begin(), entries.end(),
+            [](const Entry& x, const Entry& y) { return x.mtime < y.mtime; });
+        const uint64_t target = static_cast<uint64_t>(static_cast<double>(max_bytes_) * kEvictLowWater);
+        for (const Entry& e : entries) {
+            if (total <= target) break;
+            std::error_code rec;
+            // Another process may have evicted it already; count only our removals
+            if (fs::remove(e.path, rec)) ++stats_.evictions;
+            total -= e.size;
+        }
+    }
+
+    bool CompileCache::read_totals(CacheStats& out) const {
+        out = CacheStats{};
+        std::ifstream ifs(fs::path(dir_) / kStatsFile);
+        if (!ifs) return false;
+        std::string name;
+        uint64_t v = 0;
+        while (ifs >> name >> v) {
+            if (name == "hits") out.hits = v;
+            else if (name == "misses") out.misses = v;
+            else if (name == "stores") out.stores = v;
+            else if (name == "evictions") out.evictions = v;
+        }
+        return true;
+    }
+
+    void CompileCache::add_to_totals() const {
+        CacheStats t;
+        read_totals(t);
+        t.hits += stats_.hits;
+        t.misses += stats_.misses;
+        t.stores += stats_.stores;
+        t.evictions += stats_.evictions;
+        std::ostringstream os;
+        os << "hits " << t.hits << "\n"
+           << "misses " << t.misses << "\n"
+           << "stores " << t.stores << "\n"
+           << "evictions " << t.evictions << "\n";
+        const std::string s = os.str();
+        std::string err;
+        write_atomic(fs::path(dir_) / kStatsFile, s.data(), s.size(), err); // best effort
+    }
+
+    bool parse_byte_size(const std::string& s, uint64_t& out) {
+        if (s.empty()) return false;
+        uint64_t v = 0;
+        size_t i = 0;
+        for (; i < s.size() && s[i] >= '0' && s[i] <= '9'; ++i) {
+            if (v > (UINT64_MAX - 9) / 10) return false;
+            v = v * 10 + uint64_t(s[i] - '0');
+        }
+        if (i == 0) return false;
+        int shift = 0;
+        if (i < s.size()) {
+            switch (s[i]) {
+            case 'k': case 'K': shift = 10; break;
+            case 'm': case 'M': shift = 20; break;
+            case 'g': case 'G': shift = 30; break;
+            default: return false;
+            }
+            if (i + 1 != s.size()) return false;
+        }
+        if (shift && v > (UINT64_MAX >> shift)) return false;
+        out = v << shift;
+        return true;
+    }
+
+} // namespace qbin_compiler
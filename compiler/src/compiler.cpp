@@ -1,133 +1,131 @@
 #include "qbin_compiler/compiler.hpp"
+#include "qbin_compiler/compress.hpp"
+#include "qbin_compiler/encoder.hpp"
+#include "qbin_compiler/optimizer.hpp"
 #include "qbin_compiler/qasm_frontend.hpp"
 
 #include <cstdint>
-#include <cstring>
+#include <cstdio>
 #include <string>
+#include <utility>
 #include <vector>
 
+#ifndef QBIN_COMPILER_VERSION
+#define QBIN_COMPILER_VERSION "0.0.0"
+#endif
+
 namespace qbin_compiler {
 
-    static inline void push_u32_le(std::vector<uint8_t>& out, uint32_t v) {
-        out.push_back(static_cast<uint8_t>(v & 0xFF));
-        out.push_back(static_cast<uint8_t>((v >> 8) & 0xFF));
-        out.push_back(static_cast<uint8_t>((v >> 16) & 0xFF));
-        out.push_back(static_cast<uint8_t>((v >> 24) & 0xFF));
-    }
-    static inline void push_bytes(std::vector<uint8_t>& out, const void* data, size_t n) {
-        const auto* p = static_cast<const uint8_t*>(data);
-        out.insert(out.end(), p, p + n);
-    }
-    static inline void push_str(std::vector<uint8_t>& out, const char* s) {
-        push_bytes(out, s, std::strlen(s));
-    }
-    // ULEB128
-    static inline void push_uleb128(std::vector<uint8_t>& out, uint64_t n) {
-        do {
-            uint8_t b = static_cast<uint8_t>(n & 0x7Fu);
-            n >>= 7;
-            if (n != 0) b |= 0x80u;
-            out.push_back(b);
-        } while (n != 0);
-    }
-    // Float32 (IEEE-754) write helper
-    static inline void push_f32_le(std::vector<uint8_t>& out, float f) {
-        static_assert(sizeof(float) == 4, "float must be 32-bit");
-        uint32_t u;
-        std::memcpy(&u, &f, sizeof(u));
-        push_u32_le(out, u);
+    const char* compiler_version() {
+        return QBIN_COMPILER_VERSION;
     }
-    // CRC32C (Castagnoli), reflected poly 0x82F63B78
-    static inline uint32_t crc32c(const uint8_t* data, size_t len) {
-        static uint32_t table[256];
-        static bool init = false;
-        if (!init) {
-            const uint32_t poly = 0x82F63B78u;
-            for (uint32_t i = 0; i < 256; ++i) {
-                uint32_t c = i;
-                for (int k = 0; k < 8; ++k) {
-                    c = (c & 1u) ? (c >> 1) ^ poly : (c >> 1);
-                }
-                table[i] = c;
+
+    // STRS/QUBS/BITS for the declared registers (spec 7.1, 7.3, 7.4). A
+    // single register with the default name (q, c) needs no alias and so no
+    // string; register names are unique, so STRS needs no deduplication.
+    static void encode_register_sections(const frontend::Program& prog, std::vector<enc::Section>& sections) {
+        std::vector<std::string> strs{ "" };
+        auto aliases = [&strs](const std::vector<frontend::Register>& regs, const char* implicit) {
+            std::vector<enc::RegisterAlias> out;
+            if (regs.size() == 1 && regs[0].name == implicit) return out;
+            for (const auto& r : regs) {
+                out.push_back({ r.first, r.size, static_cast<uint32_t>(strs.size()) });
+                strs.push_back(r.name);
             }
-            init = true;
+            return out;
+        };
+        const std::vector<enc::RegisterAlias> qubit_aliases = aliases(prog.qregs, "q");
+        const std::vector<enc::RegisterAlias> bit_aliases = aliases(prog.cregs, "c");
+        if (strs.size() > 1) {
+            enc::Section s;
+            s.id = enc::section_id("STRS");
+            enc::encode_strs_section(strs, s.payload);
+            sections.push_back(std::move(s));
+        }
+        if (!prog.qregs.empty()) {
+            enc::Section s;
+            s.id = enc::section_id("QUBS");
+            enc::encode_qubs_section(frontend::register_space(prog.qregs), qubit_aliases, s.payload);
+            sections.push_back(std::move(s));
         }
-        uint32_t crc = 0xFFFFFFFFu;
-        for (size_t i = 0; i < len; ++i) {
-            crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xFFu];
+        if (!prog.cregs.empty()) {
+            enc::Section s;
+            s.id = enc::section_id("BITS");
+            enc::encode_bits_section(frontend::register_space(prog.cregs), bit_aliases, s.payload);
+            sections.push_back(std::move(s));
         }
-        return crc ^ 0xFFFFFFFFu;
     }
 
-    static inline void encode_inst_section(const frontend::Program& prog, std::vector<uint8_t>& out) {
-        // INST magic
-        push_str(out, "INST");
-        // instr_count
-        push_uleb128(out, static_cast<uint64_t>(prog.instrs.size()));
-        // encode instructions
-        for (const auto& I : prog.instrs) {
-            out.push_back(static_cast<uint8_t>(I.op));
-            uint8_t mask = 0;
-            if (I.a >= 0) mask |= 1u << 0;
-            if (I.b >= 0) mask |= 1u << 1;
-            if (I.c >= 0) mask |= 1u << 2;
-            if (I.has_angle0) mask |= 1u << 3;
-            if (I.has_aux)    mask |= 1u << 7;
-            out.push_back(mask);
-            if (I.a >= 0) push_uleb128(out, static_cast<uint64_t>(I.a));
-            if (I.b >= 0) push_uleb128(out, static_cast<uint64_t>(I.b));
-            if (I.c >= 0) push_uleb128(out, static_cast<uint64_t>(I.c));
-            if (I.has_angle0) { out.push_back(0); push_f32_le(out, I.angle0); } // tag 0 = f32
-            if (I.has_aux) { push_u32_le(out, I.aux_u32); }
-            // IF_* carry an extra imm8 after operands
-            uint8_t opc = static_cast<uint8_t>(I.op);
-            if (opc == 0x81 || opc == 0x82) {
-                out.push_back(I.has_imm8 ? I.imm8 : 0);
-            }
+    static inline std::vector<enc::Section> encode_sections(const frontend::Program& prog, bool delta_operands,
+        bool debug_info = false) {
+        std::vector<enc::Section> sections;
+        encode_register_sections(prog, sections);
+        if (!prog.params.empty()) {
+            enc::Section pars;
+            pars.id = enc::section_id("PARS");
+            enc::encode_pars_section(prog.params, pars.payload);
+            sections.push_back(std::move(pars));
+        }
+        if (!prog.gates.empty()) {
+            enc::Section gate;
+            gate.id = enc::section_id("GATE");
+            enc::encode_gate_section(prog.gates, gate.payload);
+            sections.push_back(std::move(gate));
         }
+        enc::Section inst;
+        inst.id = enc::section_id("INST");
+        enc::encode_inst_section(prog.instrs, inst.payload, delta_operands);
+        if (delta_operands) inst.flags |= enc::kSectionDeltaOperands;
+        sections.push_back(std::move(inst));
+        if (debug_info) {
+            enc::Section debg;
+            debg.id = enc::section_id("DEBG");
+            debg.flags = enc::kSectionDeltaOperands;
+            if (enc::encode_debg_section(prog.instrs, debg.payload)) sections.push_back(std::move(debg));
+        }
+        return sections;
     }
 
     static inline std::vector<uint8_t> encode_qbin_min(const frontend::Program& prog) {
-        // Build INST payload
-        std::vector<uint8_t> inst;
-        encode_inst_section(prog, inst);
-
-        // Layout
-        const uint32_t header_size = 24;
-        const uint32_t section_count = 1;
-        const uint32_t section_table_offset = header_size;
-        const uint32_t section_table_size = section_count * 16; // one entry
-
-        // Header without CRC
-        std::vector<uint8_t> header;
-        push_str(header, "QBIN");              // 0x00
-        header.push_back(1);                   // major
-        header.push_back(0);                   // minor
-        header.push_back(0);                   // flags (LE, no table hash)
-        header.push_back(static_cast<uint8_t>(header_size)); // header size
-        push_u32_le(header, section_count);    // count
-        push_u32_le(header, section_table_offset);
-        push_u32_le(header, section_table_size);
-        // CRC32C over 0x00..0x13
-        uint32_t crc = crc32c(header.data(), header.size());
-        push_u32_le(header, crc);
-
-        // Section table entry for INST
-        std::vector<uint8_t> table;
-        uint32_t inst_id = 0; std::memcpy(&inst_id, "INST", 4);
-        push_u32_le(table, inst_id);
-        push_u32_le(table, section_table_offset + section_table_size); // offset 40
-        push_u32_le(table, static_cast<uint32_t>(inst.size()));
-        push_u32_le(table, 0); // flags
-
-        // Assemble file
-        std::vector<uint8_t> blob;
-        blob.reserve(header.size() + table.size() + inst.size());
-        blob.insert(blob.end(), header.begin(), header.end());
-        blob.insert(blob.end(), table.begin(), table.end());
-        blob.insert(blob.end(), inst.begin(), inst.end());
+        return enc::assemble_qbin(encode_sections(prog, false));
+    }
 
-        return blob;
+    // Replaces each payload by its CPRZ form where that is smaller. With a
+    // dictionary, CPRS goes first, unless the savings do not pay for it.
+    static void compress_sections(std::vector<enc::Section>& sections, const CompileOptions& opts) {
+        const std::vector<uint8_t>* dict = opts.dict && !opts.dict->empty() ? opts.dict : nullptr;
+        std::vector<enc::Section> packed = sections;
+        std::vector<uint8_t> z;
+        std::string err;
+        size_t saved = 0;
+        for (auto& s : packed) {
+            if (!enc::compress_payload(s.payload.data(), s.payload.size(), opts.compress_level,
+                    dict ? dict->data() : nullptr, dict ? dict->size() : 0, z, err)) {
+                if (opts.verbose) std::fprintf(stderr, "[CPRZ] %s; sections left uncompressed\n", err.c_str());
+                return;
+            }
+            if (z.size() >= s.payload.size()) continue;
+            saved += s.payload.size() - z.size();
+            s.payload.swap(z);
+            s.flags |= enc::kSectionCompressed;
+        }
+        if (saved == 0) return;
+        if (dict) {
+            enc::Section cprs;
+            cprs.id = enc::section_id("CPRS");
+            enc::encode_cprs_section(*dict, opts.embed_dict, cprs.payload);
+            const size_t cost = 16 + ((cprs.payload.size() + 7u) & ~size_t(7u));
+            if (saved <= cost) return;
+            packed.insert(packed.begin(), std::move(cprs));
+        }
+        if (opts.verbose) std::fprintf(stderr, "[CPRZ] %zu bytes saved\n", saved);
+        sections.swap(packed);
+    }
+
+    static inline std::vector<uint8_t> encode_qbin(const frontend::Program& prog, const CompileOptions& opts) {
+        std::vector<enc::Section> sections = encode_sections(prog, opts.delta_operands, opts.debug_info);
+        if (opts.compress_level > 0) compress_sections(sections, opts);
+        return enc::assemble_qbin(sections);
     }
 
     std::vector<uint8_t> compile_qasm_to_qbin_min(const std::string& qasm_text, bool verbose) {
@@ -135,4 +133,62 @@ namespace qbin_compiler {
         return encode_qbin_min(prog);
     }
 
+    std::vector<uint8_t> compile_qasm_to_qbin(const std::string& qasm_text,
+        const CompileOptions& opts,
+        CompileStats* stats) {
+        frontend::Program prog = frontend::parse_qasm_subset(qasm_text, opts.verbose);
+        const bool intern = opts.intern_angles || opts.opt_level >= 2;
+        const bool dedup = opts.dedup_gates || opts.opt_level >= 2;
+        const bool any_pass = opts.opt_level > 0 || opts.fuse_1q || intern || dedup || opts.delta_operands || opts.compress_level > 0 ||
+            opts.debug_info;
+        if (stats) {
+            stats->instrs_in = prog.instrs.size();
+            stats->bytes_unoptimized = any_pass ? encode_qbin_min(prog).size() : 0;
+        }
+
+        if (opts.opt_level >= 1) {
+            opt::PeepholeStats ps{};
+            opt::peephole(prog, &ps);
+            if (opts.verbose) {
+                std::fprintf(stderr, "[O1] peephole: %zu cancelled, %zu merged, %zu dropped\n",
+                    ps.cancelled, ps.merged, ps.dropped);
+            }
+        }
+
+        if (opts.fuse_1q) {
+            opt::FuseStats fs{};
+            opt::fuse_1q(prog, &fs);
+            if (opts.verbose) {
+                std::fprintf(stderr, "[U] %zu single-qubit runs of %zu gates fused into %zu instructions\n",
+                    fs.runs, fs.fused, fs.emitted);
+            }
+        }
+
+        if (dedup) {
+            opt::GateStats gs{};
+            opt::dedup_gates(prog, &gs);
+            if (opts.verbose) {
+                std::fprintf(stderr, "[GATE] %zu templates, %zu instructions folded into %zu CALLG\n",
+                    gs.templates, gs.folded, gs.calls);
+            }
+        }
+
+        if (intern) {
+            opt::InternStats is{};
+            opt::intern_angles(prog, &is);
+            if (opts.verbose) {
+                std::fprintf(stderr, "[PARS] %zu distinct angles, %zu interned, %zu param_refs\n",
+                    is.distinct, is.interned, is.refs);
+            }
+        }
+
+        std::vector<uint8_t> blob = encode_qbin(prog, opts);
+        if (stats) {
+            stats->instrs_out = prog.instrs.size();
+            stats->bytes_out = blob.size();
+            if (!any_pass) stats->bytes_unoptimized = blob.size();
+        }
+        return blob;
+    }
+
 } // namespace qbin_compiler
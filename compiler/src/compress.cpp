@@ -0,0 +1,139 @@
+#include "qbin_compiler/compress.hpp"
+
+#include "qbin_compiler/encoder.hpp"
+#include "qbin_compiler/hash.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+#ifdef QBIN_HAVE_ZSTD
+#include <zdict.h>
+#include <zstd.h>
+#endif
+
+namespace qbin_compiler {
+    namespace enc {
+
+        static const uint8_t kAlgZstd = 1;
+
+        bool zstd_available() {
+#ifdef QBIN_HAVE_ZSTD
+            return true;
+#else
+            return false;
+#endif
+        }
+
+        uint32_t dict_id(const uint8_t* dict, size_t n) {
+            if (n < 8) return 0;
+            uint32_t magic, id;
+            std::memcpy(&magic, dict, 4);
+            std::memcpy(&id, dict + 4, 4);
+            return magic == 0xEC30A437u ? id : 0;
+        }
+
+#ifdef QBIN_HAVE_ZSTD
+        // Per-thread context plus the digested form of the last dictionary,
+        // keyed by its hash, size and level.
+        namespace {
+        struct CCtxState {
+            ZSTD_CCtx* ctx = ZSTD_createCCtx();
+            ZSTD_CDict* cdict = nullptr;
+            uint64_t dict_hash = 0;
+            size_t dict_size = 0;
+            int level = 0;
+            ~CCtxState() {
+                ZSTD_freeCDict(cdict);
+                ZSTD_freeCCtx(ctx);
+            }
+        };
+        } // namespace
+
+        static bool prepare_cctx(CCtxState& st, int level, const uint8_t* dict, size_t dict_size, std::string& err) {
+            ZSTD_CCtx_reset(st.ctx, ZSTD_reset_session_and_parameters);
+            if (dict && dict_size) {
+                const uint64_t h = xxh3_64(dict, dict_size);
+                if (!st.cdict || st.dict_hash != h || st.dict_size != dict_size || st.level != level) {
+                    ZSTD_freeCDict(st.cdict);
+                    st.cdict = ZSTD_createCDict(dict, dict_size, level);
+                    if (!st.cdict) { err = "cannot load zstd dictionary"; return false; }
+                    st.dict_hash = h;
+                    st.dict_size = dict_size;
+                    st.level = level;
+                }
+                ZSTD_CCtx_refCDict(st.ctx, st.cdict);
+            }
+            else {
+                ZSTD_CCtx_setParameter(st.ctx, ZSTD_c_compressionLevel, level);
+            }
+            ZSTD_CCtx_setParameter(st.ctx, ZSTD_c_contentSizeFlag, 0);
+            ZSTD_CCtx_setParameter(st.ctx, ZSTD_c_checksumFlag, 0);
+            ZSTD_CCtx_setParameter(st.ctx, ZSTD_c_dictIDFlag, 0);
+            return true;
+        }
+#endif
+
+        bool compress_payload(const uint8_t* payload, size_t n, int level,
+            const uint8_t* dict, size_t dict_size,
+            std::vector<uint8_t>& out, std::string& err) {
+#ifdef QBIN_HAVE_ZSTD
+            thread_local CCtxState st;
+            if (!st.ctx) { err = "cannot create zstd context"; return false; }
+            if (!prepare_cctx(st, level, dict, dict_size, err)) return false;
+            out.clear();
+            push_str(out, "CPRZ");
+            out.push_back(kAlgZstd);
+            push_u32_le(out, static_cast<uint32_t>(n));
+            const size_t head = out.size();
+            out.resize(head + ZSTD_compressBound(n));
+            const size_t r = ZSTD_compress2(st.ctx, out.data() + head, out.size() - head, payload, n);
+            if (ZSTD_isError(r)) { err = std::string("zstd: ") + ZSTD_getErrorName(r); return false; }
+            out.resize(head + r);
+            return true;
+#else
+            (void)payload; (void)n; (void)level; (void)dict; (void)dict_size; (void)out;
+            err = "this build has no zstd support";
+            return false;
+#endif
+        }
+
+        void encode_cprs_section(const std::vector<uint8_t>& dict, bool embed, std::vector<uint8_t>& out) {
+            push_str(out, "CPRS");
+            out.push_back(kAlgZstd);
+            push_u32_le(out, dict_id(dict.data(), dict.size()));
+            out.push_back(embed ? 1 : 0);
+            if (embed) {
+                push_uleb128(out, dict.size());
+                push_bytes(out, dict.data(), dict.size());
+            }
+        }
+
+        bool train_dictionary(const std::vector<std::vector<uint8_t>>& samples, size_t capacity,
+            std::vector<uint8_t>& dict, std::string& err) {
+#ifdef QBIN_HAVE_ZSTD
+            std::vector<uint8_t> flat;
+            std::vector<size_t> sizes;
+            sizes.reserve(samples.size());
+            for (const auto& s : samples) {
+                if (s.empty()) continue;
+                flat.insert(flat.end(), s.begin(), s.end());
+                sizes.push_back(s.size());
+            }
+            if (sizes.empty()) { err = "no training samples"; return false; }
+            dict.resize(capacity);
+            const size_t r = ZDICT_trainFromBuffer(dict.data(), dict.size(), flat.data(), sizes.data(),
+                static_cast<unsigned>(sizes.size()));
+            if (ZDICT_isError(r)) { err = std::string("dictionary training failed: ") + ZDICT_getErrorName(r); return false; }
+            dict.resize(r);
+            return true;
+#else
+            (void)samples; (void)capacity; (void)dict;
+            err = "this build has no zstd support";
+            return false;
+#endif
+        }
+
+    } // namespace enc
+} // namespace qbin_compiler
@@ -0,0 +1,279 @@
+#include "qbin_compiler/encoder.hpp"
+
+#include <array>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace qbin_compiler {
+    namespace enc {
+
+        uint32_t crc32c(const uint8_t* data, size_t len) {
+            // Built once on first use; a function-local static is initialized
+            // thread-safely, so concurrent compiles may share it.
+            static const std::array<uint32_t, 256> table = [] {
+                std::array<uint32_t, 256> t{};
+                const uint32_t poly = 0x82F63B78u;
+                for (uint32_t i = 0; i < 256; ++i) {
+                    uint32_t c = i;
+                    for (int k = 0; k < 8; ++k) {
+                        c = (c & 1u) ? (c >> 1) ^ poly : (c >> 1);
+                    }
+                    t[i] = c;
+                }
+                return t;
+            }();
+            uint32_t crc = 0xFFFFFFFFu;
+            for (size_t i = 0; i < len; ++i) {
+                crc = (crc >> 8) ^ table[(crc ^ data[i]) & 0xFFu];
+            }
+            return crc ^ 0xFFFFFFFFu;
+        }
+
+        static inline uint64_t zigzag(int64_t v) {
+            return (static_cast<uint64_t>(v) << 1) ^ static_cast<uint64_t>(v >> 63);
+        }
+
+        // Angle slot: u8 tag, then the f32 or the param_ref varint (spec 7.7.1)
+        static inline void push_angle(std::vector<uint8_t>& out, bool is_param, float value, uint32_t param) {
+            if (is_param) { out.push_back(1); push_uleb128(out, param); } // tag 1 = param_ref
+            else { out.push_back(0); push_f32_le(out, value); }          // tag 0 = f32
+        }
+
+        // Record with the qubit slots already masked in; `qubits` writes them.
+        template <class Qubits>
+        static void encode_record(const frontend::Instr& I, std::vector<uint8_t>& out, Qubits&& qubits) {
+            out.push_back(static_cast<uint8_t>(I.op));
+            uint8_t mask = 0;
+            if (I.a >= 0) mask |= 1u << 0;
+            if (I.b >= 0) mask |= 1u << 1;
+            if (I.c >= 0) mask |= 1u << 2;
+            if (I.has_angle0) mask |= 1u << 3;
+            if (I.has_angle1) mask |= 1u << 4;
+            if (I.has_angle2) mask |= 1u << 5;
+            if (I.has_param_ref) mask |= 1u << 6;
+            if (I.has_aux)    mask |= 1u << 7;
+            out.push_back(mask);
+            qubits();
+            if (I.has_angle0) push_angle(out, I.angle0_is_param, I.angle0, I.angle0_param);
+            if (I.has_angle1) push_angle(out, I.angle1_is_param, I.angle1, I.angle1_param);
+            if (I.has_angle2) push_angle(out, I.angle2_is_param, I.angle2, I.angle2_param);
+            if (I.has_param_ref) push_uleb128(out, I.param_ref);
+            if (I.has_aux) { push_u32_le(out, I.aux_u32); }
+            // IF_* carry an extra imm8 after operands
+            uint8_t opc = static_cast<uint8_t>(I.op);
+            if (opc == 0x81 || opc == 0x82) {
+                out.push_back(I.has_imm8 ? I.imm8 : 0);
+            }
+        }
+
+        void encode_instr(const frontend::Instr& I, std::vector<uint8_t>& out) {
+            encode_record(I, out, [&] {
+                if (I.a >= 0) push_uleb128(out, static_cast<uint64_t>(I.a));
+                if (I.b >= 0) push_uleb128(out, static_cast<uint64_t>(I.b));
+                if (I.c >= 0) push_uleb128(out, static_cast<uint64_t>(I.c));
+            });
+        }
+
+        void encode_inst_section(const std::vector<frontend::Instr>& instrs, std::vector<uint8_t>& out,
+            bool delta_operands) {
+            // INST magic
+            push_str(out, "INST");
+            // instr_count
+            push_uleb128(out, static_cast<uint64_t>(instrs.size()));
+            // encode instructions
+            if (!delta_operands) {
+                for (const auto& I : instrs) encode_instr(I, out);
+                return;
+            }
+            // Each qubit is coded against the previous slot of the same
+            // instruction; the first one against the first qubit of the last
+            // instruction that had any.
+            int64_t base = 0;
+            for (const auto& I : instrs) {
+                encode_record(I, out, [&] {
+                    int64_t ref = base;
+                    bool first = true;
+                    for (int q : { I.a, I.b, I.c }) {
+                        if (q < 0) continue;
+                        push_uleb128(out, zigzag(int64_t(q) - ref));
+                        ref = q;
+                        if (first) { base = q; first = false; }
+                    }
+                });
+            }
+        }
+
+        void encode_strs_section(const std::vector<std::string>& strs, std::vector<uint8_t>& out) {
+            push_str(out, "STRS");
+            push_u32_le(out, static_cast<uint32_t>(strs.size()));
+            for (const auto& str : strs) {
+                push_uleb128(out, str.size());
+                push_bytes(out, str.data(), str.size());
+                out.push_back(0);
+            }
+        }
+
+        static void push_aliases(const std::vector<RegisterAlias>& aliases, std::vector<uint8_t>& out) {
+            push_uleb128(out, aliases.size());
+            for (const auto& a : aliases) {
+                push_uleb128(out, a.first);
+                push_uleb128(out, a.count);
+                push_uleb128(out, a.name_str_id);
+            }
+        }
+
+        void encode_qubs_section(uint32_t qubit_count, const std::vector<RegisterAlias>& aliases,
+            std::vector<uint8_t>& out) {
+            push_str(out, "QUBS");
+            push_uleb128(out, qubit_count);
+            out.push_back(0);   // layout_present: no coordinates
+            push_aliases(aliases, out);
+        }
+
+        void encode_bits_section(uint32_t bit_count, const std::vector<RegisterAlias>& aliases,
+            std::vector<uint8_t>& out) {
+            push_str(out, "BITS");
+            push_uleb128(out, bit_count);
+            push_aliases(aliases, out);
+        }
+
+        void encode_pars_section(const std::vector<float>& params, std::vector<uint8_t>& out) {
+            push_str(out, "PARS");
+            push_uleb128(out, static_cast<uint64_t>(params.size()));
+            for (float v : params) {
+                push_uleb128(out, 0);   // name_str_id: "" (anonymous constant)
+                out.push_back(0);       // kind: angle (rad)
+                out.push_back(1);       // value_tag: const_f32
+                push_f32_le(out, v);
+            }
+        }
+
+        void encode_gate_section(const std::vector<frontend::GateDecl>& gates, std::vector<uint8_t>& out) {
+            push_str(out, "GATE");
+            push_uleb128(out, static_cast<uint64_t>(gates.size()));
+            std::vector<uint8_t> body;
+            for (const auto& g : gates) {
+                push_uleb128(out, 0);   // name_str_id: "" (anonymous, named gN on decompile)
+                push_uleb128(out, g.num_qubits);
+                push_uleb128(out, 0);   // num_params
+                out.push_back(1u << 1); // flags: unitary-known (body given)
+                body.clear();
+                encode_inst_section(g.body, body);
+                push_uleb128(out, static_cast<uint64_t>(body.size()));
+                out.insert(out.end(), body.begin(), body.end());
+            }
+        }
+
+        bool encode_debg_section(const std::vector<frontend::Instr>& instrs, std::vector<uint8_t>& out) {
+            // Mappings: (instr delta, line delta, column delta); an instruction
+            // at the same position as its predecessor needs none
+            std::vector<uint8_t> maps;
+            size_t count = 0;
+            uint64_t prev_index = 0;
+            int64_t prev_line = 0, prev_col = 0;
+            for (size_t k = 0; k < instrs.size(); ++k) {
+                const frontend::Instr& I = instrs[k];
+                if (I.line == 0 || (count && I.line == prev_line && I.column == prev_col)) continue;
+                push_uleb128(maps, k - prev_index);
+                push_sleb128(maps, int64_t(I.line) - prev_line);
+                push_sleb128(maps, int64_t(I.column) - prev_col);
+                prev_index = k;
+                prev_line = I.line;
+                prev_col = I.column;
+                ++count;
+            }
+            if (count == 0) return false;
+            push_str(out, "DEBG");
+            push_uleb128(out, 0);   // file_count: the compiled text only
+            push_uleb128(out, count);
+            push_bytes(out, maps.data(), maps.size());
+            return true;
+        }
+
+        // Header (with CRC) for `section_count` entries; the table follows at 24.
+        static void push_header(std::vector<uint8_t>& blob, uint32_t section_count) {
+            const uint32_t header_size = 24;
+            push_str(blob, "QBIN");              // 0x00
+            blob.push_back(1);                   // major
+            blob.push_back(0);                   // minor
+            blob.push_back(0);                   // flags (LE, no table hash)
+            blob.push_back(static_cast<uint8_t>(header_size)); // header size
+            push_u32_le(blob, section_count);    // count
+            push_u32_le(blob, header_size);      // section table offset
+            push_u32_le(blob, section_count * 16);
+            // CRC32C over 0x00..0x13
+            push_u32_le(blob, crc32c(blob.data() + blob.size() - 20, 20));
+        }
+
+        static void push_table_entry(std::vector<uint8_t>& blob, uint32_t id, uint32_t offset,
+            uint32_t size, uint32_t flags) {
+            push_u32_le(blob, id);
+            push_u32_le(blob, offset);
+            push_u32_le(blob, size);
+            push_u32_le(blob, flags);
+        }
+
+        // Offset of each section when `count` sections of the given sizes
+        // follow the header and table; returns the end of the last one.
+        template <class SizeOf>
+        static size_t layout(size_t count, SizeOf&& size_of, std::vector<uint32_t>& offsets) {
+            offsets.clear();
+            offsets.reserve(count);
+            size_t pos = 24 + count * 16;
+            for (size_t i = 0; i < count; ++i) {
+                pos = (pos + 7u) & ~static_cast<size_t>(7u);
+                offsets.push_back(static_cast<uint32_t>(pos));
+                pos += size_of(i);
+            }
+            return pos;
+        }
+
+        std::vector<uint8_t> assemble_qbin(const std::vector<Section>& sections) {
+            // Layout
+            const uint32_t section_count = static_cast<uint32_t>(sections.size());
+            std::vector<uint32_t> offsets;
+            const size_t end = layout(sections.size(), [&](size_t i) { return sections[i].payload.size(); }, offsets);
+
+            std::vector<uint8_t> blob;
+            blob.reserve(end);
+            push_header(blob, section_count);
+
+            // Section table
+            for (size_t i = 0; i < sections.size(); ++i) {
+                push_table_entry(blob, sections[i].id, offsets[i],
+                    static_cast<uint32_t>(sections[i].payload.size()), sections[i].flags);
+            }
+
+            // Payloads
+            for (size_t i = 0; i < sections.size(); ++i) {
+                blob.resize(offsets[i], 0);
+                blob.insert(blob.end(), sections[i].payload.begin(), sections[i].payload.end());
+            }
+            return blob;
+        }
+
+        std::vector<uint8_t> assemble_prefix(const std::vector<Section>& head,
+            uint32_t id, uint32_t size, uint32_t flags) {
+            const size_t count = head.size() + 1;
+            std::vector<uint32_t> offsets;
+            layout(count, [&](size_t i) { return i < head.size() ? head[i].payload.size() : size_t(size); }, offsets);
+
+            std::vector<uint8_t> blob;
+            blob.reserve(offsets.back());
+            push_header(blob, static_cast<uint32_t>(count));
+            for (size_t i = 0; i < head.size(); ++i) {
+                push_table_entry(blob, head[i].id, offsets[i], static_cast<uint32_t>(head[i].payload.size()), head[i].flags);
+            }
+            push_table_entry(blob, id, offsets.back(), size, flags);
+            for (size_t i = 0; i < head.size(); ++i) {
+                blob.resize(offsets[i], 0);
+                blob.insert(blob.end(), head[i].payload.begin(), head[i].payload.end());
+            }
+            blob.resize(offsets.back(), 0);
+            return blob;
+        }
+
+    } // namespace enc
+} // namespace qbin_compiler
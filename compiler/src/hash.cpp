@@ -0,0 +1,198 @@
+#include "qbin_compiler/hash.hpp"
+
+#include <cstdint>
+#include <cstring>
+
+// Scalar port of XXH3_64bits() (xxHash 0.8). Only the seedless variant with
+// the default secret is needed, so the seed terms are folded out.
+
+namespace qbin_compiler {
+
+    namespace {
+
+        constexpr uint64_t kPrime32_1 = 0x9E3779B1u;
+        constexpr uint64_t kPrime32_2 = 0x85EBCA77u;
+        constexpr uint64_t kPrime32_3 = 0xC2B2AE3Du;
+        constexpr uint64_t kPrime64_1 = 0x9E3779B185EBCA87ull;
+        constexpr uint64_t kPrime64_2 = 0xC2B2AE3D27D4EB4Full;
+        constexpr uint64_t kPrime64_3 = 0x165667B19E3779F9ull;
+        constexpr uint64_t kPrime64_4 = 0x85EBCA77C2B2AE63ull;
+        constexpr uint64_t kPrime64_5 = 0x27D4EB2F165667C5ull;
+        constexpr uint64_t kPrimeMx1 = 0x165667919E3779F9ull;
+        constexpr uint64_t kPrimeMx2 = 0x9FB21C651E98DF25ull;
+
+        constexpr size_t kSecretSize = 192;
+        constexpr size_t kStripeLen = 64;
+        constexpr size_t kSecretConsumeRate = 8;
+        constexpr size_t kAccNb = 8;
+
+        const uint8_t kSecret[kSecretSize] = {
+            0xb8, 0xfe, 0x6c, 0x39, 0x23, 0xa4, 0x4b, 0xbe, 0x7c, 0x01, 0x81, 0x2c, 0xf7, 0x21, 0xad, 0x1c,
+            0xde, 0xd4, 0x6d, 0xe9, 0x83, 0x90, 0x97, 0xdb, 0x72, 0x40, 0xa4, 0xa4, 0xb7, 0xb3, 0x67, 0x1f,
+            0xcb, 0x79, 0xe6, 0x4e, 0xcc, 0xc0, 0xe5, 0x78, 0x82, 0x5a, 0xd0, 0x7d, 0xcc, 0xff, 0x72, 0x21,
+            0xb8, 0x08, 0x46, 0x74, 0xf7, 0x43, 0x24, 0x8e, 0xe0, 0x35, 0x90, 0xe6, 0x81, 0x3a, 0x26, 0x4c,
+            0x3c, 0x28, 0x52, 0xbb, 0x91, 0xc3, 0x00, 0xcb, 0x88, 0xd0, 0x65, 0x8b, 0x1b, 0x53, 0x2e, 0xa3,
+            0x71, 0x64, 0x48, 0x97, 0xa2, 0x0d, 0xf9, 0x4e, 0x38, 0x19, 0xef, 0x46, 0xa9, 0xde, 0xac, 0xd8,
+            0xa8, 0xfa, 0x76, 0x3f, 0xe3, 0x9c, 0x34, 0x3f, 0xf9, 0xdc, 0xbb, 0xc7, 0xc7, 0x0b, 0x4f, 0x1d,
+            0x8a, 0x51, 0xe0, 0x4b, 0xcd, 0xb4, 0x59, 0x31, 0xc8, 0x9f, 0x7e, 0xc9, 0xd9, 0x78, 0x73, 0x64,
+            0xea, 0xc5, 0xac, 0x83, 0x34, 0xd3, 0xeb, 0xc3, 0xc5, 0x81, 0xa0, 0xff, 0xfa, 0x13, 0x63, 0xeb,
+            0x17, 0x0d, 0xdd, 0x51, 0xb7, 0xf0, 0xda, 0x49, 0xd3, 0x16, 0x55, 0x26, 0x29, 0xd4, 0x68, 0x9e,
+            0x2b, 0x16, 0xbe, 0x58, 0x7d, 0x47, 0xa1, 0xfc, 0x8f, 0xf8, 0xb8, 0xd1, 0x7a, 0xd0, 0x31, 0xce,
+            0x45, 0xcb, 0x3a, 0x8f, 0x95, 0x16, 0x04, 0x28, 0xaf, 0xd7, 0xfb, 0xca, 0xbb, 0x4b, 0x40, 0x7e,
+        };
+
+        inline uint32_t rd32(const uint8_t* p) {
+            return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+        }
+        inline uint64_t rd64(const uint8_t* p) {
+            return (uint64_t)rd32(p) | ((uint64_t)rd32(p + 4) << 32);
+        }
+        inline uint64_t rotl64(uint64_t x, int r) { return (x << r) | (x >> (64 - r)); }
+        inline uint32_t swap32(uint32_t x) {
+            return ((x << 24) & 0xff000000u) | ((x << 8) & 0x00ff0000u) | ((x >> 8) & 0x0000ff00u) | ((x >> 24) & 0x000000ffu);
+        }
+        inline uint64_t swap64(uint64_t x) {
+            return ((uint64_t)swap32((uint32_t)x) << 32) | swap32((uint32_t)(x >> 32));
+        }
+
+        inline uint64_t mul128_fold64(uint64_t lhs, uint64_t rhs) {
+#if defined(__SIZEOF_INT128__) && !defined(QBIN_NO_INT128)
+            __extension__ typedef unsigned __int128 u128;
+            const u128 p = (u128)lhs * rhs;
+            return (uint64_t)p ^ (uint64_t)(p >> 64);
+#else
+            const uint64_t lo_lo = (lhs & 0xFFFFFFFFu) * (rhs & 0xFFFFFFFFu);
+            const uint64_t hi_lo = (lhs >> 32) * (rhs & 0xFFFFFFFFu);
+            const uint64_t lo_hi = (lhs & 0xFFFFFFFFu) * (rhs >> 32);
+            const uint64_t hi_hi = (lhs >> 32) * (rhs >> 32);
+            const uint64_t cross = (lo_lo >> 32) + (hi_lo & 0xFFFFFFFFu) + lo_hi;
+            const uint64_t upper = (hi_lo >> 32) + (cross >> 32) + hi_hi;
+            const uint64_t lower = (cross << 32) | (lo_lo & 0xFFFFFFFFu);
+            return lower ^ upper;
+#endif
+        }
+
+        inline uint64_t xxh64_avalanche(uint64_t h) {
+            h ^= h >> 33; h *= kPrime64_2;
+            h ^= h >> 29; h *= kPrime64_3;
+            h ^= h >> 32;
+            return h;
+        }
+        inline uint64_t avalanche(uint64_t h) {
+            h ^= h >> 37; h *= kPrimeMx1;
+            h ^= h >> 32;
+            return h;
+        }
+        inline uint64_t rrmxmx(uint64_t h, uint64_t len) {
+            h ^= rotl64(h, 49) ^ rotl64(h, 24);
+            h *= kPrimeMx2;
+            h ^= (h >> 35) + len;
+            h *= kPrimeMx2;
+            return h ^ (h >> 28);
+        }
+        inline uint64_t mix16(const uint8_t* in, const uint8_t* sec) {
+            return mul128_fold64(rd64(in) ^ rd64(sec), rd64(in + 8) ^ rd64(sec + 8));
+        }
+
+        uint64_t hash_0to16(const uint8_t* in, size_t len) {
+            if (len > 8) {
+                const uint64_t lo = rd64(in) ^ (rd64(kSecret + 24) ^ rd64(kSecret + 32));
+                const uint64_t hi = rd64(in + len - 8) ^ (rd64(kSecret + 40) ^ rd64(kSecret + 48));
+                return avalanche(len + swap64(lo) + hi + mul128_fold64(lo, hi));
+            }
+            if (len >= 4) {
+                const uint64_t in64 = rd32(in + len - 4) + ((uint64_t)rd32(in) << 32);
+                return rrmxmx(in64 ^ (rd64(kSecret + 8) ^ rd64(kSecret + 16)), len);
+            }
+            if (len > 0) {
+                const uint32_t combined = ((uint32_t)in[0] << 16) | ((uint32_t)in[len >> 1] << 24)
+                    | (uint32_t)in[len - 1] | ((uint32_t)len << 8);
+                return xxh64_avalanche(combined ^ (uint64_t)(rd32(kSecret) ^ rd32(kSecret + 4)));
+            }
+            return xxh64_avalanche(rd64(kSecret + 56) ^ rd64(kSecret + 64));
+        }
+
+        uint64_t hash_17to128(const uint8_t* in, size_t len) {
+            uint64_t acc = len * kPrime64_1;
+            if (len > 32) {
+                if (len > 64) {
+                    if (len > 96) {
+                        acc += mix16(in + 48, kSecret + 96);
+                        acc += mix16(in + len - 64, kSecret + 112);
+                    }
+                    acc += mix16(in + 32, kSecret + 64);
+                    acc += mix16(in + len - 48, kSecret + 80);
+                }
+                acc += mix16(in + 16, kSecret + 32);
+                acc += mix16(in + len - 32, kSecret + 48);
+            }
+            acc += mix16(in, kSecret);
+            acc += mix16(in + len - 16, kSecret + 16);
+            return avalanche(acc);
+        }
+
+        uint64_t hash_129to240(const uint8_t* in, size_t len) {
+            const size_t rounds = len / 16;
+            uint64_t acc = len * kPrime64_1;
+            for (size_t i = 0; i < 8; ++i) acc += mix16(in + 16 * i, kSecret + 16 * i);
+            acc = avalanche(acc);
+            for (size_t i = 8; i < rounds; ++i) acc += mix16(in + 16 * i, kSecret + 16 * (i - 8) + 3);
+            acc += mix16(in + len - 16, kSecret + 136 - 17);
+            return avalanche(acc);
+        }
+
+        inline void accumulate_512(uint64_t* acc, const uint8_t* in, const uint8_t* sec) {
+            for (size_t i = 0; i < kAccNb; ++i) {
+                const uint64_t v = rd64(in + 8 * i);
+                const uint64_t k = v ^ rd64(sec + 8 * i);
+                acc[i ^ 1] += v;
+                acc[i] += (k & 0xFFFFFFFFu) * (k >> 32);
+            }
+        }
+
+        inline void scramble(uint64_t* acc, const uint8_t* sec) {
+            for (size_t i = 0; i < kAccNb; ++i) {
+                uint64_t a = acc[i];
+                a ^= a >> 47;
+                a ^= rd64(sec + 8 * i);
+                acc[i] = a * kPrime32_1;
+            }
+        }
+
+        uint64_t hash_long(const uint8_t* in, size_t len) {
+            uint64_t acc[kAccNb] = { kPrime32_3, kPrime64_1, kPrime64_2, kPrime64_3,
+                                     kPrime64_4, kPrime32_2, kPrime64_5, kPrime32_1 };
+            const size_t stripes_per_block = (kSecretSize - kStripeLen) / kSecretConsumeRate;
+            const size_t block_len = kStripeLen * stripes_per_block;
+            const size_t blocks = (len - 1) / block_len;
+
+            for (size_t n = 0; n < blocks; ++n) {
+                const uint8_t* blk = in + n * block_len;
+                for (size_t s = 0; s < stripes_per_block; ++s)
+                    accumulate_512(acc, blk + s * kStripeLen, kSecret + s * kSecretConsumeRate);
+                scramble(acc, kSecret + kSecretSize - kStripeLen);
+            }
+            // Partial last block, then the final (possibly overlapping) stripe
+            const size_t stripes = ((len - 1) - block_len * blocks) / kStripeLen;
+            const uint8_t* tail = in + blocks * block_len;
+            for (size_t s = 0; s < stripes; ++s)
+                accumulate_512(acc, tail + s * kStripeLen, kSecret + s * kSecretConsumeRate);
+            accumulate_512(acc, in + len - kStripeLen, kSecret + kSecretSize - kStripeLen - 7);
+
+            uint64_t h = len * kPrime64_1;
+            for (size_t i = 0; i < 4; ++i)
+                h += mul128_fold64(acc[2 * i] ^ rd64(kSecret + 11 + 16 * i), acc[2 * i + 1] ^ rd64(kSecret + 11 + 16 * i + 8));
+            return avalanche(h);
+        }
+
+    } // namespace
+
+    uint64_t xxh3_64(const void* data, size_t len) {
+        const auto* in = static_cast<const uint8_t*>(data);
+        if (len <= 16) return hash_0to16(in, len);
+        if (len <= 128) return hash_17to128(in, len);
+        if (len <= 240) return hash_129to240(in, len);
+        return hash_long(in, len);
+    }
+
+} // namespace qbin_compiler
@@ -1,21 +1,73 @@
-// main.cpp - CLI driver that uses qbin_compiler::compile_qasm_to_qbin_min
+// main.cpp - CLI driver that uses qbin_compiler::compile_qasm_to_qbin
 
+#include "qbin_compiler/cache.hpp"
 #include "qbin_compiler/compiler.hpp"
+#include "qbin_compiler/compress.hpp"
 
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <exception>
 #include <fstream>
 #include <iostream>
+#include <iterator>
+#include <memory>
 #include <sstream>
 #include <string>
 #include <vector>
 
+static const int kDefaultCompressLevel = 19;
+
 static void print_usage(const char* argv0) {
     std::cerr
         << "Usage:\n"
-        << "  " << argv0 << " <input.qasm> -o <output.qbin> [--verbose]\n"
+        << "  " << argv0 << " <input.qasm> -o <output.qbin> [-O0|-O1|-O2] [--fuse-1q] [--intern-angles]\n"
+        << "         [--dedup-gates] [--delta-operands] [--compress] [--compress-level <n>]\n"
+        << "         [--dict <file> [--embed-dict]] [-g]\n"
+        << "         [--cache-dir <dir>] [--cache-max-size <n>[K|M|G]] [--no-cache] [--verbose]\n"
+        << "  " << argv0 << " --cache-stats [--cache-dir <dir>]\n"
+        << "  " << argv0 << " --version\n"
         << "\n"
         << "Description:\n"
         << "  Minimal compiler from a small subset of OpenQASM to QBIN.\n"
-        << "  Unsupported statements are skipped with a warning (if --verbose).\n";
+        << "  Unsupported statements are skipped with a warning (if --verbose).\n"
+        << "\n"
+        << "Options:\n"
+        << "  -O0        encode the parsed program verbatim (default)\n"
+        << "  -O1        peephole pass: cancel inverse pairs, merge rotations,\n"
+        << "             drop zero-angle rotations\n"
+        << "  --fuse-1q  fold every run of single-qubit gates on a qubit into one U\n"
+        << "             (PHASE if diagonal, nothing if the identity): fewer\n"
+        << "             instructions to simulate, though often more bytes\n"
+        << "  -O2        -O1 plus all size-driven encodings below\n"
+        << "  --intern-angles\n"
+        << "             normalize angles to [-pi, pi) and move reused values into\n"
+        << "             a PARS table referenced by param_ref (when smaller)\n"
+        << "  --dedup-gates\n"
+        << "             hoist repeated subcircuits (<= 3 qubits) into GATE entries\n"
+        << "             and replace each occurrence with CALLG\n"
+        << "  --delta-operands\n"
+        << "             store INST qubit operands as deltas to the previous instruction\n"
+        << "             (repetitive layouts compress better)\n"
+        << "  --compress zstd-compress PARS/GATE/INST where that makes them smaller\n"
+        << "  --compress-level <n>\n"
+        << "             zstd level, implies --compress (default 19)\n"
+        << "  --dict <file>\n"
+        << "             compress with a dictionary from qbin-dict, implies --compress;\n"
+        << "             readers need the same file (qbin-decompile --dict)\n"
+        << "  --embed-dict\n"
+        << "             store the dictionary in the output instead\n"
+        << "  -g         add a DEBG section mapping each instruction to its source line\n"
+        << "             and column (qbin-run reports them with runtime errors)\n"
+        << "  --cache-dir <dir>\n"
+        << "             reuse outputs of earlier runs with the same input, options and\n"
+        << "             compiler version (default: $QBIN_CACHE_DIR, unset = no cache)\n"
+        << "  --cache-max-size <n>[K|M|G]\n"
+        << "             evict least recently used entries above this size (default 256M)\n"
+        << "  --no-cache ignore $QBIN_CACHE_DIR\n"
+        << "  --cache-stats\n"
+        << "             print cumulative hit/miss counters of the cache and exit\n"
+        << "  --verbose  report skipped lines, instruction/byte reduction and cache use\n";
 }
 
 int main(int argc, char** argv) {
@@ -23,7 +75,14 @@ int main(int argc, char** argv) {
 
     std::string in_path;
     std::string out_path;
-    bool verbose = false;
+    qbin_compiler::CompileOptions opts;
+    std::string cache_dir;
+    bool no_cache = false;
+    bool cache_stats = false;
+    uint64_t cache_max = qbin_compiler::CompileCache::kDefaultMaxBytes;
+    std::string dict_path;
+    std::vector<uint8_t> dict;
+    if (const char* env = std::getenv("QBIN_CACHE_DIR")) cache_dir = env;
 
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
@@ -31,7 +90,61 @@ int main(int argc, char** argv) {
             out_path = argv[++i];
         }
         else if (a == "--verbose" || a == "-v") {
-            verbose = true;
+            opts.verbose = true;
+        }
+        else if (a == "-O0" || a == "-O1" || a == "-O2") {
+            opts.opt_level = a[2] - '0';
+        }
+        else if (a == "--fuse-1q") {
+            opts.fuse_1q = true;
+        }
+        else if (a == "--intern-angles") {
+            opts.intern_angles = true;
+        }
+        else if (a == "--dedup-gates") {
+            opts.dedup_gates = true;
+        }
+        else if (a == "--delta-operands") {
+            opts.delta_operands = true;
+        }
+        else if (a == "-g" || a == "--debug-info") {
+            opts.debug_info = true;
+        }
+        else if (a == "--compress") {
+            if (opts.compress_level == 0) opts.compress_level = kDefaultCompressLevel;
+        }
+        else if (a == "--compress-level" && i + 1 < argc) {
+            opts.compress_level = std::atoi(argv[++i]);
+            if (opts.compress_level < 1 || opts.compress_level > 22) {
+                std::cerr << "Invalid compression level: " << argv[i] << " (1..22)\n";
+                return 1;
+            }
+        }
+        else if (a == "--dict" && i + 1 < argc) {
+            dict_path = argv[++i];
+            if (opts.compress_level == 0) opts.compress_level = kDefaultCompressLevel;
+        }
+        else if (a == "--embed-dict") {
+            opts.embed_dict = true;
+        }
+        else if (a == "--cache-dir" && i + 1 < argc) {
+            cache_dir = argv[++i];
+        }
+        else if (a == "--cache-max-size" && i + 1 < argc) {
+            if (!qbin_compiler::parse_byte_size(argv[++i], cache_max)) {
+                std::cerr << "Invalid cache size: " << argv[i] << "\n";
+                return 1;
+            }
+        }
+        else if (a == "--no-cache") {
+            no_cache = true;
+        }
+        else if (a == "--cache-stats") {
+            cache_stats = true;
+        }
+        else if (a == "--version") {
+            std::cout << "qbin-compile " << qbin_compiler::compiler_version() << "\n";
+            return 0;
         }
         else if (!a.empty() && a[0] == '-') {
             std::cerr << "Unknown option: " << a << "\n";
@@ -48,11 +161,54 @@ int main(int argc, char** argv) {
         }
     }
 
+    if (no_cache) cache_dir.clear();
+
+    if (cache_stats) {
+        if (cache_dir.empty()) {
+            std::cerr << "Error: --cache-stats needs --cache-dir or $QBIN_CACHE_DIR.\n";
+            return 1;
+        }
+        qbin_compiler::CompileCache cache(cache_dir, cache_max);
+        qbin_compiler::CacheStats t;
+        cache.read_totals(t);
+        const uint64_t lookups = t.hits + t.misses;
+        std::printf("cache dir:  %s\n", cache_dir.c_str());
+        std::printf("hits:       %llu\n", static_cast<unsigned long long>(t.hits));
+        std::printf("misses:     %llu\n", static_cast<unsigned long long>(t.misses));
+        std::printf("hit rate:   %.1f%%\n", lookups ? 100.0 * double(t.hits) / double(lookups) : 0.0);
+        std::printf("stores:     %llu\n", static_cast<unsigned long long>(t.stores));
+        std::printf("evictions:  %llu\n", static_cast<unsigned long long>(t.evictions));
+        std::printf("size:       %llu bytes\n", static_cast<unsigned long long>(cache.disk_usage()));
+        return 0;
+    }
+
     if (in_path.empty() || out_path.empty()) {
         print_usage(argv[0]);
         return 1;
     }
 
+    if (opts.compress_level > 0 && !qbin_compiler::enc::zstd_available()) {
+        std::cerr << "Error: this qbin-compile was built without zstd; --compress is unavailable.\n";
+        return 1;
+    }
+    if (opts.embed_dict && dict_path.empty()) {
+        std::cerr << "Error: --embed-dict needs --dict.\n";
+        return 1;
+    }
+    if (!dict_path.empty()) {
+        std::ifstream dfs(dict_path, std::ios::binary);
+        if (!dfs) {
+            std::cerr << "Error: cannot open dictionary: " << dict_path << "\n";
+            return 1;
+        }
+        dict.assign(std::istreambuf_iterator<char>(dfs), std::istreambuf_iterator<char>());
+        if (qbin_compiler::enc::dict_id(dict.data(), dict.size()) == 0) {
+            std::cerr << "Error: " << dict_path << " is not a zstd dictionary (train one with qbin-dict).\n";
+            return 1;
+        }
+        opts.dict = &dict;
+    }
+
     // Read input QASM
     std::ifstream ifs(in_path, std::ios::binary);
     if (!ifs) {
@@ -67,8 +223,42 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    // Compile
-    std::vector<uint8_t> blob = qbin_compiler::compile_qasm_to_qbin_min(qasm, verbose);
+    // Compile, or reuse a cached output
+    const auto t0 = std::chrono::steady_clock::now();
+    qbin_compiler::CompileStats stats;
+    std::vector<uint8_t> blob;
+    bool cache_hit = false;
+    uint64_t cache_key = 0;
+    std::unique_ptr<qbin_compiler::CompileCache> cache;
+    if (!cache_dir.empty()) {
+        std::string cerr_msg;
+        cache.reset(new qbin_compiler::CompileCache(cache_dir, cache_max));
+        if (!cache->open(cerr_msg)) {
+            // A broken cache must never fail the build
+            std::cerr << "Warning: " << cerr_msg << " (cache disabled)\n";
+            cache.reset();
+        }
+        else {
+            cache_key = qbin_compiler::CompileCache::make_key(qasm, opts);
+            cache_hit = cache->lookup(cache_key, blob);
+        }
+    }
+    if (!cache_hit) {
+        try {
+            blob = qbin_compiler::compile_qasm_to_qbin(qasm, opts, opts.verbose ? &stats : nullptr);
+        }
+        catch (const std::exception& e) {
+            std::cerr << "Error: " << e.what() << "\n";
+            return 1;
+        }
+        if (cache) {
+            std::string cerr_msg;
+            if (!cache->store(cache_key, blob, cerr_msg)) {
+                std::cerr << "Warning: cache store failed: " << cerr_msg << "\n";
+            }
+        }
+    }
+    const auto t1 = std::chrono::steady_clock::now();
 
     // Write output
     std::ofstream ofs(out_path, std::ios::binary);
@@ -81,7 +271,18 @@ int main(int argc, char** argv) {
         std::cerr << "Error: failed to write output file.\n";
         return 1;
     }
-    if (verbose) {
+    if (cache) cache->add_to_totals();
+    if (opts.verbose) {
+        if (cache) {
+            const double us = std::chrono::duration<double, std::micro>(t1 - t0).count();
+            std::fprintf(stderr, "Cache %s %016llx (%.0f us)\n", cache_hit ? "hit" : "miss",
+                static_cast<unsigned long long>(cache_key), us);
+        }
+        if (!cache_hit && (opts.opt_level > 0 || opts.fuse_1q || opts.intern_angles || opts.dedup_gates ||
+                           opts.delta_operands || opts.compress_level > 0)) {
+            std::cerr << "Instructions: " << stats.instrs_in << " -> " << stats.instrs_out
+                      << ", bytes: " << stats.bytes_unoptimized << " -> " << stats.bytes_out << "\n";
+        }
         std::cerr << "Wrote " << blob.size() << " bytes to " << out_path << "\n";
     }
     return 0;
@@ -0,0 +1,775 @@
+#include "qbin_compiler/optimizer.hpp"
+#include "qbin_compiler/encoder.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <cstring>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace qbin_compiler {
+    namespace opt {
+
+        using frontend::Instr;
+        using frontend::Opcode;
+        using frontend::Program;
+
+        // How far back a per-qubit chain is walked looking for a partner.
+        // Bounds the pass to O(n * kMaxWalk).
+        static constexpr int kMaxWalk = 16;
+        static constexpr double kPi = 3.14159265358979323846;
+        static constexpr double kAngleEps = 1e-6;
+
+        // Basis in which a gate acts diagonally on one of its qubits. Two gates
+        // commute on a shared qubit when they are diagonal in the same basis there.
+        enum class Axis : uint8_t { None, Z, X, Y };
+
+        static inline bool is_1q_gate(Opcode op) {
+            uint8_t v = static_cast<uint8_t>(op);
+            return v >= 0x01 && v <= 0x0E;
+        }
+
+        static inline bool is_rotation(Opcode op) {
+            switch (op) {
+            case Opcode::RX: case Opcode::RY: case Opcode::RZ: case Opcode::PHASE:
+            case Opcode::CRX: case Opcode::CRY: case Opcode::CRZ:
+            case Opcode::RXX: case Opcode::RYY: case Opcode::RZZ:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        static inline bool is_controlled_rotation(Opcode op) {
+            return op == Opcode::CRX || op == Opcode::CRY || op == Opcode::CRZ;
+        }
+
+        static inline bool is_self_inverse(Opcode op) {
+            switch (op) {
+            case Opcode::X: case Opcode::Y: case Opcode::Z: case Opcode::H:
+            case Opcode::CX: case Opcode::CZ: case Opcode::SWAP:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // Inverse for the non-self-inverse Clifford+T pairs; returns op itself otherwise.
+        static inline Opcode inverse_of(Opcode op) {
+            switch (op) {
+            case Opcode::S:    return Opcode::SDG;
+            case Opcode::SDG:  return Opcode::S;
+            case Opcode::T:    return Opcode::TDG;
+            case Opcode::TDG:  return Opcode::T;
+            case Opcode::SX:   return Opcode::SXDG;
+            case Opcode::SXDG: return Opcode::SX;
+            default:           return op;
+            }
+        }
+
+        static inline bool is_symmetric(Opcode op) {
+            switch (op) {
+            case Opcode::CZ: case Opcode::SWAP:
+            case Opcode::RXX: case Opcode::RYY: case Opcode::RZZ:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // Gates the pass knows how to cancel or merge.
+        static inline bool is_candidate(const Instr& I) {
+            if (I.c >= 0 || I.has_aux) return false;
+            if (is_1q_gate(I.op)) return true;
+            return is_self_inverse(I.op) || is_rotation(I.op);
+        }
+
+        static Axis axis_on(const Instr& I, int q) {
+            switch (I.op) {
+            case Opcode::Z: case Opcode::S: case Opcode::SDG: case Opcode::T: case Opcode::TDG:
+            case Opcode::RZ: case Opcode::PHASE:
+                return I.a == q ? Axis::Z : Axis::None;
+            case Opcode::X: case Opcode::SX: case Opcode::SXDG: case Opcode::RX:
+                return I.a == q ? Axis::X : Axis::None;
+            case Opcode::Y: case Opcode::RY:
+                return I.a == q ? Axis::Y : Axis::None;
+            case Opcode::CZ: case Opcode::CRZ: case Opcode::RZZ:
+                return Axis::Z;
+            case Opcode::CX: case Opcode::CRX: case Opcode::CSX:
+                return I.a == q ? Axis::Z : Axis::X;
+            case Opcode::CRY:
+                return I.a == q ? Axis::Z : Axis::Y;
+            case Opcode::CU:
+                return I.a == q ? Axis::Z : Axis::None;
+            case Opcode::RXX:
+                return Axis::X;
+            case Opcode::RYY:
+                return Axis::Y;
+            default:
+                return Axis::None;
+            }
+        }
+
+        // True if the rotation angle is the identity up to global phase.
+        // Controlled rotations only reach the identity at multiples of 4*pi.
+        static inline bool is_zero_angle(Opcode op, float angle) {
+            double period = is_controlled_rotation(op) ? 4.0 * kPi : 2.0 * kPi;
+            return std::fabs(std::remainder(static_cast<double>(angle), period)) < kAngleEps;
+        }
+
+        static inline bool same_operands(const Instr& J, const Instr& G) {
+            if (J.a == G.a && J.b == G.b && J.c == G.c) return true;
+            return is_symmetric(G.op) && J.c < 0 && G.c < 0 && J.a == G.b && J.b == G.a;
+        }
+
+        // J (earlier) and G (incoming) fold into nothing or into J alone.
+        static inline bool is_partner(const Instr& J, const Instr& G) {
+            if (!is_candidate(J) || !same_operands(J, G)) return false;
+            if (is_rotation(G.op)) return J.op == G.op && J.has_angle0 && G.has_angle0;
+            if (is_self_inverse(G.op)) return J.op == G.op;
+            return inverse_of(G.op) != G.op && J.op == inverse_of(G.op);
+        }
+
+        namespace {
+
+            struct Chains {
+                const std::vector<Instr>& instrs;
+                std::vector<int> last;      // per qubit: most recent instruction index
+                std::vector<int> prev;      // 3 slots per instruction (a, b, c)
+                std::vector<uint32_t> region;
+                std::vector<uint8_t> alive;
+
+                explicit Chains(const std::vector<Instr>& v) : instrs(v) {}
+
+                int prev_on(int j, int q) const {
+                    const Instr& I = instrs[static_cast<size_t>(j)];
+                    size_t base = static_cast<size_t>(j) * 3;
+                    if (I.a == q) return prev[base + 0];
+                    if (I.b == q) return prev[base + 1];
+                    return prev[base + 2];
+                }
+
+                void link(int k) {
+                    const Instr& I = instrs[static_cast<size_t>(k)];
+                    const int qs[3] = { I.a, I.b, I.c };
+                    for (int s = 0; s < 3; ++s) {
+                        if (qs[s] < 0) continue;
+                        prev[static_cast<size_t>(k) * 3 + s] = last[static_cast<size_t>(qs[s])];
+                        last[static_cast<size_t>(qs[s])] = k;
+                    }
+                }
+
+                // Dead entries deeper in a chain are skipped lazily by walk().
+                void kill(int j) {
+                    alive[static_cast<size_t>(j)] = 0;
+                    const Instr& I = instrs[static_cast<size_t>(j)];
+                    const int qs[3] = { I.a, I.b, I.c };
+                    for (int s = 0; s < 3; ++s) {
+                        if (qs[s] < 0) continue;
+                        int& top = last[static_cast<size_t>(qs[s])];
+                        if (top == j) top = prev[static_cast<size_t>(j) * 3 + s];
+                    }
+                }
+
+                // First live instruction on q's chain that G does not commute past,
+                // provided it is a partner of G; -1 otherwise.
+                int walk(int q, const Instr& G, uint32_t cur) const {
+                    Axis g_axis = axis_on(G, q);
+                    int j = last[static_cast<size_t>(q)];
+                    for (int steps = 0; j >= 0 && steps < kMaxWalk; ++steps) {
+                        if (region[static_cast<size_t>(j)] != cur) return -1;
+                        if (alive[static_cast<size_t>(j)]) {
+                            const Instr& J = instrs[static_cast<size_t>(j)];
+                            if (is_partner(J, G)) return j;
+                            Axis j_axis = axis_on(J, q);
+                            if (j_axis == Axis::None || j_axis != g_axis) return -1;
+                        }
+                        j = prev_on(j, q);
+                    }
+                    return -1;
+                }
+            };
+
+        } // namespace
+
+        void peephole(Program& prog, PeepholeStats* stats) {
+            std::vector<Instr>& instrs = prog.instrs;
+            const size_t n = instrs.size();
+            PeepholeStats st{};
+
+            int max_q = -1;
+            for (const auto& I : instrs) max_q = std::max({ max_q, I.a, I.b, I.c });
+
+            Chains ch(instrs);
+            ch.last.assign(static_cast<size_t>(max_q + 1), -1);
+            ch.prev.assign(n * 3, -1);
+            ch.region.assign(n, 0);
+            ch.alive.assign(n, 1);
+
+            struct Guard { size_t index; size_t live_at_open; };
+            std::vector<Guard> guards;
+            uint32_t cur = 0;
+            size_t live = 0;
+
+            for (size_t k = 0; k < n; ++k) {
+                Instr& G = instrs[k];
+                const int ki = static_cast<int>(k);
+
+                if (G.op == Opcode::IF_EQ || G.op == Opcode::IF_NEQ) {
+                    ch.region[k] = ++cur;
+                    guards.push_back({ k, live });
+                    ++live;
+                    continue;
+                }
+                if (G.op == Opcode::ENDIF) {
+                    ch.region[k] = ++cur;
+                    if (!guards.empty()) {
+                        Guard g = guards.back();
+                        guards.pop_back();
+                        if (live == g.live_at_open + 1) {
+                            // Guard body was optimized away entirely
+                            ch.alive[g.index] = 0;
+                            ch.alive[k] = 0;
+                            --live;
+                            st.dropped += 2;
+                            continue;
+                        }
+                    }
+                    ++live;
+                    continue;
+                }
+                if (G.a < 0 && G.b < 0 && G.c < 0) {
+                    // BARRIER and other whole-register instructions
+                    ch.region[k] = ++cur;
+                    ++live;
+                    continue;
+                }
+                ch.region[k] = cur;
+
+                if (is_candidate(G)) {
+                    if (is_rotation(G.op) && G.has_angle0 && is_zero_angle(G.op, G.angle0)) {
+                        ch.alive[k] = 0;
+                        ++st.dropped;
+                        continue;
+                    }
+                    int j = ch.walk(G.a, G, cur);
+                    if (j >= 0 && G.b >= 0 && ch.walk(G.b, G, cur) != j) j = -1;
+                    if (j >= 0) {
+                        Instr& J = instrs[static_cast<size_t>(j)];
+                        ch.alive[k] = 0;
+                        if (is_rotation(G.op)) {
+                            J.angle0 += G.angle0;
+                            ++st.merged;
+                            if (is_zero_angle(J.op, J.angle0)) {
+                                ch.kill(j);
+                                --live;
+                                ++st.dropped;
+                            }
+                        }
+                        else {
+                            ch.kill(j);
+                            --live;
+                            st.cancelled += 2;
+                        }
+                        continue;
+                    }
+                }
+
+                ch.link(ki);
+                ++live;
+            }
+
+            size_t w = 0;
+            for (size_t k = 0; k < n; ++k) {
+                if (!ch.alive[k]) continue;
+                if (w != k) instrs[w] = instrs[k];
+                ++w;
+            }
+            instrs.resize(w);
+
+            if (stats) *stats = st;
+        }
+
+        // Rotations whose angle only matters modulo 2*pi (up to global phase).
+        static inline bool is_2pi_periodic(Opcode op) {
+            switch (op) {
+            case Opcode::RX: case Opcode::RY: case Opcode::RZ: case Opcode::PHASE:
+            case Opcode::RXX: case Opcode::RYY: case Opcode::RZZ:
+                return true;
+            default:
+                return false;
+            }
+        }
+
+        // Angle slot k of U/CU: phi and lambda are exactly 2*pi-periodic, U's
+        // theta up to global phase; CU's theta has period 4*pi like CRx.
+        static inline bool is_2pi_periodic_slot(Opcode op, int k) {
+            if (op == Opcode::U) return true;
+            if (op == Opcode::CU) return k > 0;
+            return k == 0 && is_2pi_periodic(op);
+        }
+
+        namespace {
+
+            // One angle slot of an instruction, so that passes can treat the
+            // three alike.
+            struct AngleSlot {
+                bool& has;
+                bool& is_param;
+                float& value;
+                uint32_t& param;
+            };
+
+            AngleSlot angle_slot(Instr& I, int k) {
+                if (k == 1) return { I.has_angle1, I.angle1_is_param, I.angle1, I.angle1_param };
+                if (k == 2) return { I.has_angle2, I.angle2_is_param, I.angle2, I.angle2_param };
+                return { I.has_angle0, I.angle0_is_param, I.angle0, I.angle0_param };
+            }
+
+        } // namespace
+
+        // [-pi, pi), with -0 folded into +0 so both share one PARS entry.
+        static inline float normalize_angle(float a) {
+            double r = std::remainder(static_cast<double>(a), 2.0 * kPi);
+            if (r >= kPi) r -= 2.0 * kPi;
+            if (r == 0.0) r = 0.0;
+            return static_cast<float>(r);
+        }
+
+        static inline uint32_t float_bits(float f) {
+            uint32_t u;
+            std::memcpy(&u, &f, sizeof(u));
+            return u;
+        }
+
+        void intern_angles(Program& prog, InternStats* stats) {
+            InternStats st{};
+            prog.params.clear();
+
+            std::unordered_map<uint32_t, size_t> uses;
+            for (auto& I : prog.instrs) {
+                for (int s = 0; s < 3; ++s) {
+                    AngleSlot a = angle_slot(I, s);
+                    a.is_param = false;
+                    if (!a.has) continue;
+                    if (is_2pi_periodic_slot(I.op, s)) a.value = normalize_angle(a.value);
+                    ++uses[float_bits(a.value)];
+                }
+            }
+            st.distinct = uses.size();
+
+            std::vector<std::pair<uint32_t, size_t>> order(uses.begin(), uses.end());
+            std::sort(order.begin(), order.end(), [](const auto& x, const auto& y) {
+                return x.second != y.second ? x.second > y.second : x.first < y.first;
+                });
+
+            // Per-value gain is non-increasing along `order`, so take the profitable prefix.
+            const long kLiteral = 5, kEntry = 7;
+            long saved = 0;
+            size_t k = 0;
+            for (; k < order.size(); ++k) {
+                long ref = 1 + static_cast<long>(enc::uleb128_size(k));
+                long gain = static_cast<long>(order[k].second) * (kLiteral - ref) - kEntry;
+                if (gain <= 0) break;
+                saved += gain;
+            }
+            // Table entry + magic + count + worst-case alignment padding
+            const long overhead = 16 + 4 + static_cast<long>(enc::uleb128_size(k)) + 7;
+            if (k > 0 && saved > overhead) {
+                std::unordered_map<uint32_t, uint32_t> ids;
+                ids.reserve(k);
+                prog.params.reserve(k);
+                for (size_t i = 0; i < k; ++i) {
+                    float v;
+                    std::memcpy(&v, &order[i].first, sizeof(v));
+                    prog.params.push_back(v);
+                    ids.emplace(order[i].first, static_cast<uint32_t>(i));
+                }
+                for (auto& I : prog.instrs) {
+                    for (int s = 0; s < 3; ++s) {
+                        AngleSlot a = angle_slot(I, s);
+                        if (!a.has) continue;
+                        auto it = ids.find(float_bits(a.value));
+                        if (it == ids.end()) continue;
+                        a.is_param = true;
+                        a.param = it->second;
+                        ++st.refs;
+                    }
+                }
+                st.interned = k;
+            }
+
+            if (stats) *stats = st;
+        }
+
+        // ---- GATE/CALLG template deduplication ----
+
+        static constexpr size_t kMaxTemplateLen = 16;
+        static constexpr size_t kMaxTemplates = 32;
+
+        static inline bool is_unitary_gate(const Instr& I) {
+            uint8_t v = static_cast<uint8_t>(I.op);
+            bool gate = (v >= 0x01 && v <= 0x18) || (v >= 0x20 && v <= 0x22);
+            return gate && I.a >= 0 && !I.has_aux && !I.has_param_ref &&
+                !I.angle0_is_param && !I.angle1_is_param && !I.angle2_is_param;
+        }
+
+        static size_t encoded_size(const Instr& I) {
+            size_t n = 2;
+            if (I.a >= 0) n += enc::uleb128_size(static_cast<uint64_t>(I.a));
+            if (I.b >= 0) n += enc::uleb128_size(static_cast<uint64_t>(I.b));
+            if (I.c >= 0) n += enc::uleb128_size(static_cast<uint64_t>(I.c));
+            if (I.has_angle0) n += 1 + (I.angle0_is_param ? enc::uleb128_size(I.angle0_param) : 4);
+            if (I.has_angle1) n += 1 + (I.angle1_is_param ? enc::uleb128_size(I.angle1_param) : 4);
+            if (I.has_angle2) n += 1 + (I.angle2_is_param ? enc::uleb128_size(I.angle2_param) : 4);
+            if (I.has_param_ref) n += enc::uleb128_size(I.param_ref);
+            if (I.has_aux) n += 4;
+            if (I.op == Opcode::IF_EQ || I.op == Opcode::IF_NEQ) n += 1;
+            return n;
+        }
+
+        static inline uint64_t mix(uint64_t h, uint64_t v) {
+            h = (h ^ v) * 0x9E3779B97F4A7C15ull;
+            return h ^ (h >> 29);
+        }
+
+        namespace {
+
+            // Qubits of a window renamed to formal arguments 0..2 by first use.
+            struct Formals {
+                int q[3] = { -1, -1, -1 };
+                int n = 0;
+                // -1 for an absent operand, -2 once a fourth qubit shows up
+                int map(int x) {
+                    if (x < 0) return -1;
+                    for (int i = 0; i < n; ++i) if (q[i] == x) return i;
+                    if (n == 3) return -2;
+                    q[n] = x;
+                    return n++;
+                }
+            };
+
+            struct Candidate {
+                size_t first = 0;
+                size_t len = 0;
+                size_t bytes = 0;       // encoded size of one occurrence
+                size_t count = 0;       // non-overlapping occurrences
+                size_t next_free = 0;
+                int nq = 0;
+            };
+
+            // Window [i, i+len) with qubits renamed to formals, or false if it
+            // is not a candidate run.
+            bool canonical_window(const std::vector<Instr>& v, size_t i, size_t len,
+                std::vector<Instr>& body, Formals& f) {
+                body.clear();
+                f = Formals{};
+                for (size_t k = 0; k < len; ++k) {
+                    const Instr& I = v[i + k];
+                    if (!is_unitary_gate(I)) return false;
+                    Instr B = I;
+                    B.a = f.map(I.a);
+                    B.b = f.map(I.b);
+                    B.c = f.map(I.c);
+                    if (B.a == -2 || B.b == -2 || B.c == -2) return false;
+                    body.push_back(B);
+                }
+                return true;
+            }
+
+            bool same_body(const std::vector<Instr>& x, const std::vector<Instr>& y) {
+                if (x.size() != y.size()) return false;
+                for (size_t k = 0; k < x.size(); ++k) {
+                    const Instr& p = x[k];
+                    const Instr& q = y[k];
+                    if (p.op != q.op || p.a != q.a || p.b != q.b || p.c != q.c) return false;
+                    if (p.has_angle0 != q.has_angle0) return false;
+                    if (p.has_angle0 && float_bits(p.angle0) != float_bits(q.angle0)) return false;
+                    if (p.has_angle1 != q.has_angle1 || p.has_angle2 != q.has_angle2) return false;
+                    if (p.has_angle1 && float_bits(p.angle1) != float_bits(q.angle1)) return false;
+                    if (p.has_angle2 && float_bits(p.angle2) != float_bits(q.angle2)) return false;
+                }
+                return true;
+            }
+
+        } // namespace
+
+        void dedup_gates(Program& prog, GateStats* stats) {
+            GateStats st{};
+            std::vector<Instr>& instrs = prog.instrs;
+
+            int max_q = 0;
+            for (const auto& I : instrs) max_q = std::max({ max_q, I.a, I.b, I.c });
+            const long qubit_bytes = static_cast<long>(enc::uleb128_size(static_cast<uint64_t>(max_q)));
+
+            std::unordered_map<uint64_t, Candidate> cands;
+            std::vector<Instr> body, probe;
+            for (size_t iter = 0; iter < kMaxTemplates; ++iter) {
+                const size_t n = instrs.size();
+                cands.clear();
+                for (size_t i = 0; i < n; ++i) {
+                    Formals f;
+                    uint64_t h = 0xCBF29CE484222325ull;
+                    size_t bytes = 0;
+                    for (size_t len = 1; len <= kMaxTemplateLen && i + len <= n; ++len) {
+                        const Instr& I = instrs[i + len - 1];
+                        if (!is_unitary_gate(I)) break;
+                        int fa = f.map(I.a), fb = f.map(I.b), fc = f.map(I.c);
+                        if (fa == -2 || fb == -2 || fc == -2) break;
+                        h = mix(h, static_cast<uint64_t>(I.op) | (static_cast<uint64_t>(fa + 1) << 8) |
+                            (static_cast<uint64_t>(fb + 1) << 12) | (static_cast<uint64_t>(fc + 1) << 16));
+                        if (I.has_angle0) h = mix(h, 0x100000000ull | float_bits(I.angle0));
+                        if (I.has_angle1) h = mix(h, 0x200000000ull | float_bits(I.angle1));
+                        if (I.has_angle2) h = mix(h, 0x300000000ull | float_bits(I.angle2));
+                        bytes += encoded_size(I);
+                        if (len < 2) continue;
+                        Candidate& c = cands[mix(h, len)];
+                        if (c.count == 0) { c.first = i; c.len = len; c.bytes = bytes; c.nq = f.n; }
+                        if (i >= c.next_free) { ++c.count; c.next_free = i + len; }
+                    }
+                }
+
+                // Net saving: occurrences shrink to one CALLG each, paid for by one
+                // GATE entry (and the section itself for the first template).
+                const long gate_id_bytes = static_cast<long>(enc::uleb128_size(prog.gates.size()));
+                const long section_overhead = prog.gates.empty() ? 16 + 4 + 1 + 7 : 0;
+                const Candidate* best = nullptr;
+                long best_saving = 0;
+                for (const auto& kv : cands) {
+                    const Candidate& c = kv.second;
+                    if (c.count < 2) continue;
+                    long call = 2 + gate_id_bytes + c.nq * qubit_bytes;
+                    long body_len = 4 + static_cast<long>(enc::uleb128_size(c.len) + c.bytes);
+                    long entry = 4 + static_cast<long>(enc::uleb128_size(static_cast<uint64_t>(body_len))) + body_len;
+                    long saving = static_cast<long>(c.count) * (static_cast<long>(c.bytes) - call) - entry - section_overhead;
+                    bool better = saving > best_saving ||
+                        (best && saving == best_saving &&
+                            (c.first < best->first || (c.first == best->first && c.len < best->len)));
+                    if (better) {
+                        best = &c;
+                        best_saving = saving;
+                    }
+                }
+                if (!best) break;
+
+                Formals f;
+                if (!canonical_window(instrs, best->first, best->len, body, f)) break;
+                const size_t len = best->len;
+                const uint32_t gate_id = static_cast<uint32_t>(prog.gates.size());
+
+                std::vector<Instr> out;
+                out.reserve(n);
+                size_t replaced = 0;
+                for (size_t i = 0; i < n;) {
+                    Formals actual;
+                    if (i + len <= n && canonical_window(instrs, i, len, probe, actual) && same_body(probe, body)) {
+                        Instr C{};
+                        C.op = Opcode::CALLG;
+                        C.a = actual.q[0];
+                        C.b = actual.n > 1 ? actual.q[1] : -1;
+                        C.c = actual.n > 2 ? actual.q[2] : -1;
+                        C.has_param_ref = true;
+                        C.param_ref = gate_id;
+                        C.line = instrs[i].line;
+                        C.column = instrs[i].column;
+                        out.push_back(C);
+                        i += len;
+                        ++replaced;
+                    }
+                    else {
+                        out.push_back(instrs[i++]);
+                    }
+                }
+                if (replaced < 2) break;    // hash collision inflated the count
+
+                frontend::GateDecl g;
+                g.num_qubits = static_cast<uint32_t>(f.n);
+                g.body = body;
+                prog.gates.push_back(std::move(g));
+                instrs.swap(out);
+                ++st.templates;
+                st.calls += replaced;
+                st.folded += replaced * len;
+            }
+
+            if (stats) *stats = st;
+        }
+
+        // ---- Single-qubit run fusion ----
+
+        namespace {
+
+            using cplx = std::complex<double>;
+
+            // Row-major 2x2 matrix.
+            struct Mat2 {
+                cplx m00 = 1.0, m01 = 0.0, m10 = 0.0, m11 = 1.0;
+            };
+
+            Mat2 mul(const Mat2& x, const Mat2& y) {
+                return { x.m00 * y.m00 + x.m01 * y.m10, x.m00 * y.m01 + x.m01 * y.m11,
+                         x.m10 * y.m00 + x.m11 * y.m10, x.m10 * y.m01 + x.m11 * y.m11 };
+            }
+
+            Mat2 diag(cplx d0, cplx d1) { return { d0, 0.0, 0.0, d1 }; }
+
+            // Unitary of a single-qubit gate (0x01..0x0F) up to global phase;
+            // an absent angle reads as 0, as in the runner.
+            Mat2 gate_matrix(const Instr& I) {
+                const cplx i(0.0, 1.0);
+                const double r = 0.70710678118654752440;
+                const double th = I.has_angle0 ? I.angle0 : 0.0;
+                const double c = std::cos(th / 2), s = std::sin(th / 2);
+                switch (I.op) {
+                case Opcode::X:    return { 0.0, 1.0, 1.0, 0.0 };
+                case Opcode::Y:    return { 0.0, -i, i, 0.0 };
+                case Opcode::Z:    return diag(1.0, -1.0);
+                case Opcode::H:    return { r, r, r, -r };
+                case Opcode::S:    return diag(1.0, i);
+                case Opcode::SDG:  return diag(1.0, -i);
+                case Opcode::T:    return diag(1.0, std::polar(1.0, kPi / 4));
+                case Opcode::TDG:  return diag(1.0, std::polar(1.0, -kPi / 4));
+                case Opcode::SX:   return { cplx(0.5, 0.5), cplx(0.5, -0.5), cplx(0.5, -0.5), cplx(0.5, 0.5) };
+                case Opcode::SXDG: return { cplx(0.5, -0.5), cplx(0.5, 0.5), cplx(0.5, 0.5), cplx(0.5, -0.5) };
+                case Opcode::RX:   return { c, -i * s, -i * s, c };
+                case Opcode::RY:   return { c, -s, s, c };
+                case Opcode::RZ:   return diag(std::polar(1.0, -th / 2), std::polar(1.0, th / 2));
+                case Opcode::PHASE: return diag(1.0, std::polar(1.0, th));
+                default: {         // U
+                    const double phi = I.has_angle1 ? I.angle1 : 0.0;
+                    const double lam = I.has_angle2 ? I.angle2 : 0.0;
+                    return { c, -std::polar(s, lam), std::polar(s, phi), std::polar(c, phi + lam) };
+                }
+                }
+            }
+
+            // Gates a run may hold: literal single-qubit unitaries.
+            bool is_fusable(const Instr& I) {
+                const uint8_t v = static_cast<uint8_t>(I.op);
+                return v >= 0x01 && v <= 0x0F && I.a >= 0 && I.b < 0 && I.c < 0 && !I.has_aux &&
+                    !I.has_param_ref && !I.angle0_is_param && !I.angle1_is_param && !I.angle2_is_param;
+            }
+
+        } // namespace
+
+        // M = e^(i alpha) U(theta, phi, lambda), U as in OpenQASM:
+        // [[cos(t/2), -e^(i l) sin(t/2)], [e^(i p) sin(t/2), e^(i(p+l)) cos(t/2)]].
+        // Diagonal M (theta = 0) get lambda = 0, so phi is the PHASE angle.
+        static void euler_zyz(const Mat2& M, double& theta, double& phi, double& lambda) {
+            const double c = std::abs(M.m00), s = std::abs(M.m10);
+            theta = 2.0 * std::atan2(s, c);
+            lambda = 0.0;
+            if (s < kAngleEps) {
+                theta = 0.0;
+                phi = std::arg(M.m11) - std::arg(M.m00);
+            }
+            else if (c < kAngleEps) {
+                theta = kPi;
+                phi = std::arg(M.m10) - std::arg(-M.m01);
+            }
+            else {
+                const double alpha = std::arg(M.m00);
+                phi = std::arg(M.m10) - alpha;
+                lambda = std::arg(-M.m01) - alpha;
+            }
+        }
+
+        void fuse_1q(Program& prog, FuseStats* stats) {
+            FuseStats st{};
+            std::vector<Instr>& instrs = prog.instrs;
+            const size_t n = instrs.size();
+
+            int max_q = -1;
+            for (const auto& I : instrs) max_q = std::max({ max_q, I.a, I.b, I.c });
+
+            // Open run per qubit: its first gate and the product so far. Later
+            // gates of a run are deleted as they join; the first one becomes
+            // the fused gate when the run closes.
+            struct Run {
+                size_t first = 0;
+                size_t len = 0;
+                Mat2 m;
+            };
+            std::vector<Run> runs(static_cast<size_t>(max_q + 1));
+            std::vector<int> open;      // qubits that may have a run (duplicates allowed)
+            std::vector<uint8_t> alive(n, 1);
+
+            auto close = [&](int q) {
+                Run& r = runs[static_cast<size_t>(q)];
+                if (r.len >= 2) {
+                    Instr& F = instrs[r.first];
+                    double theta, phi, lambda;
+                    euler_zyz(r.m, theta, phi, lambda);
+                    const float p = normalize_angle(static_cast<float>(phi));
+                    Instr G{};
+                    G.a = q;
+                    G.line = F.line;
+                    G.column = F.column;
+                    if (theta != 0.0) {
+                        G.op = Opcode::U;
+                        G.has_angle0 = true; G.angle0 = static_cast<float>(theta);
+                        G.has_angle1 = true; G.angle1 = p;
+                        G.has_angle2 = true; G.angle2 = normalize_angle(static_cast<float>(lambda));
+                        ++st.emitted;
+                    }
+                    else if (std::fabs(p) >= kAngleEps) {
+                        G.op = Opcode::PHASE;
+                        G.has_angle0 = true; G.angle0 = p;
+                        ++st.emitted;
+                    }
+                    else {
+                        alive[r.first] = 0;     // identity
+                    }
+                    F = G;
+                    ++st.runs;
+                    st.fused += r.len;
+                }
+                r = Run{};
+                };
+            auto close_all = [&]() {
+                for (int q : open) close(q);
+                open.clear();
+                };
+
+            for (size_t k = 0; k < n; ++k) {
+                const Instr& G = instrs[k];
+                if (is_fusable(G)) {
+                    Run& r = runs[static_cast<size_t>(G.a)];
+                    if (r.len == 0) {
+                        r.first = k;
+                        open.push_back(G.a);
+                    }
+                    else {
+                        alive[k] = 0;
+                    }
+                    r.m = mul(gate_matrix(G), r.m);
+                    ++r.len;
+                    continue;
+                }
+                if (G.a < 0 && G.b < 0 && G.c < 0) {
+                    // IF/ENDIF, BARRIER and other whole-register instructions
+                    close_all();
+                    continue;
+                }
+                if (G.a >= 0) close(G.a);
+                if (G.b >= 0) close(G.b);
+                if (G.c >= 0) close(G.c);
+            }
+            close_all();
+
+            size_t w = 0;
+            for (size_t k = 0; k < n; ++k) {
+                if (!alive[k]) continue;
+                if (w != k) instrs[w] = instrs[k];
+                ++w;
+            }
+            instrs.resize(w);
+
+            if (stats) *stats = st;
+        }
+
+    } // namespace opt
+} // namespace qbin_compiler
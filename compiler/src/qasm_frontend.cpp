@@ -3,8 +3,11 @@
 #include <algorithm>
 #include <cctype>
 #include <cstdio>
+#include <cstdint>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <vector>
 
 namespace qbin_compiler {
     namespace frontend {
@@ -16,28 +19,67 @@ namespace qbin_compiler {
             return s;
         }
 
-        static bool parse_qubit_index(const std::string& tok, int& idx) {
-            // expects q[<int>]
-            if (tok.size() < 4) return false;
-            if (tok[0] != 'q') return false;
+        // name[i] against the declared registers `regs` (flat index first + i),
+        // or implicit[i] for any i if none were declared. A declared name with
+        // i >= its size also fails and sets `oob` to that register.
+        static bool parse_operand(const std::string& tok, const std::vector<Register>& regs,
+            const char* implicit, int& idx, const Register*& oob) {
+            oob = nullptr;
             size_t lb = tok.find('[');
             size_t rb = tok.find(']');
-            if (lb == std::string::npos || rb == std::string::npos || rb <= lb + 1) return false;
-            std::string inside = tok.substr(lb + 1, rb - lb - 1);
-            try { idx = std::stoi(inside); return true; }
+            if (lb == std::string::npos || rb == std::string::npos || lb == 0 || rb <= lb + 1) return false;
+            const std::string name = tok.substr(0, lb);
+            long long v = 0;
+            try { v = std::stoll(tok.substr(lb + 1, rb - lb - 1)); }
             catch (...) { return false; }
+            if (v < 0) return false;
+            if (regs.empty()) {
+                if (name != implicit || v > INT32_MAX) return false;
+                idx = static_cast<int>(v);
+                return true;
+            }
+            for (const auto& r : regs) {
+                if (r.name != name) continue;
+                if (static_cast<unsigned long long>(v) >= r.size) { oob = &r; return false; }
+                idx = static_cast<int>(r.first + static_cast<uint32_t>(v));
+                return true;
+            }
+            return false;
         }
 
-        static bool parse_bit_index(const std::string& tok, int& idx) {
-            // expects c[<int>]
-            if (tok.size() < 4) return false;
-            if (tok[0] != 'c') return false;
-            size_t lb = tok.find('[');
-            size_t rb = tok.find(']');
-            if (lb == std::string::npos || rb == std::string::npos || rb <= lb + 1) return false;
-            std::string inside = tok.substr(lb + 1, rb - lb - 1);
-            try { idx = std::stoi(inside); return true; }
+        static bool is_identifier(const std::string& s) {
+            if (s.empty() || !(std::isalpha((unsigned char)s[0]) || s[0] == '_')) return false;
+            return std::all_of(s.begin(), s.end(), [](char c) { return std::isalnum((unsigned char)c) || c == '_'; });
+        }
+
+        // Declaration after its keyword `kw` (without the trailing ';'):
+        // "[N] name" or " name" for qubit/bit, " name[N]" for qreg/creg.
+        static bool parse_declaration(const std::string& kw, const std::string& rest, Register& r) {
+            std::string size, name;
+            if (kw == "qreg" || kw == "creg") {
+                size_t lb = rest.find('['), rb = rest.find(']');
+                if (lb == std::string::npos || rb == std::string::npos || rb <= lb + 1 || !trim_copy(rest.substr(rb + 1)).empty()) return false;
+                name = trim_copy(rest.substr(0, lb));
+                size = rest.substr(lb + 1, rb - lb - 1);
+            }
+            else if (!rest.empty() && rest[0] == '[') {
+                size_t rb = rest.find(']');
+                if (rb == std::string::npos || rb < 2) return false;
+                size = rest.substr(1, rb - 1);
+                name = trim_copy(rest.substr(rb + 1));
+            }
+            else {
+                if (rest.empty() || !std::isspace((unsigned char)rest[0])) return false;
+                size = "1";
+                name = trim_copy(rest);
+            }
+            long long n = 0;
+            try { n = std::stoll(size); }
             catch (...) { return false; }
+            if (n <= 0 || n > INT32_MAX || !is_identifier(name)) return false;
+            r.name = name;
+            r.size = static_cast<uint32_t>(n);
+            return true;
         }
 
         static bool parse_angle_from(const std::string& t, float& val) {
@@ -49,15 +91,73 @@ namespace qbin_compiler {
             catch (...) { return false; }
         }
 
+        // "name(a, b, c) operands" with three literal angles, for the U/CU
+        // statements; must run before commas are normalized to spaces.
+        static bool parse_angle_triple(const std::string& t, std::string& name, float ang[3], std::string& operands) {
+            size_t lp = t.find('(');
+            size_t rp = t.find(')');
+            if (lp == std::string::npos || rp == std::string::npos || rp <= lp + 1) return false;
+            name = trim_copy(t.substr(0, lp));
+            if (name != "u" && name != "U" && name != "cu") return false;
+            std::string list = t.substr(lp + 1, rp - lp - 1);
+            for (int k = 0; k < 3; ++k) {
+                size_t comma = list.find(',');
+                if ((comma == std::string::npos) != (k == 2)) return false;
+                const std::string a = trim_copy(list.substr(0, comma));
+                size_t used = 0;
+                try { ang[k] = std::stof(a, &used); }
+                catch (...) { return false; }
+                if (used != a.size()) return false;
+                if (comma != std::string::npos) list = list.substr(comma + 1);
+            }
+            operands = t.substr(rp + 1);
+            return true;
+        }
+
         Program parse_qasm_subset(std::string_view text, bool verbose) {
             Program P;
             std::istringstream iss{ std::string(text) };
             std::string line;
             size_t lineno = 0;
+            // Instructions before `stamped` carry their source position
+            size_t stamped = 0;
+            uint32_t cur_line = 0, cur_col = 0;
+            // Operands resolved before any declaration of their kind (q[i], c[k])
+            bool implicit_q = false, implicit_c = false;
+            // An index outside its declared register is an error, not a
+            // skipped statement (same wording as the reader's ERR_*_OOB)
+            auto check_oob = [&](const std::string& tok, const Register* oob, const char* kind) {
+                if (!oob) return;
+                throw std::runtime_error("line " + std::to_string(lineno) + ": " + kind + " " + trim_copy(tok) +
+                    " OOB: " + oob->name + " declares " + std::to_string(oob->size));
+                };
+            auto parse_qubit_index = [&](const std::string& tok, int& idx) {
+                if (P.qregs.empty()) implicit_q = true;
+                const Register* oob = nullptr;
+                if (parse_operand(tok, P.qregs, "q", idx, oob)) return true;
+                check_oob(tok, oob, "qubit");
+                return false;
+                };
+            auto parse_bit_index = [&](const std::string& tok, int& idx) {
+                if (P.cregs.empty()) implicit_c = true;
+                const Register* oob = nullptr;
+                if (parse_operand(tok, P.cregs, "c", idx, oob)) return true;
+                check_oob(tok, oob, "bit");
+                return false;
+                };
+            auto stamp = [&]() {
+                for (; stamped < P.instrs.size(); ++stamped) {
+                    P.instrs[stamped].line = cur_line;
+                    P.instrs[stamped].column = cur_col;
+                }
+                };
             while (std::getline(iss, line)) {
                 ++lineno;
+                stamp();
                 std::string s = trim_copy(line);
                 if (s.empty() || s[0] == '/' || s[0] == '#') continue;
+                cur_line = static_cast<uint32_t>(lineno);
+                cur_col = static_cast<uint32_t>(line.find(s[0]) + 1);
 
                 // Keep a lowercase copy for quick checks
                 std::string lower = s;
@@ -67,17 +167,56 @@ namespace qbin_compiler {
                     if (verbose) std::fprintf(stderr, "[skip line %zu] %s: %s\n", lineno, reason, s.c_str());
                     };
 
-                // Ignore declarations (we infer sizes)
+                // U/CU with their three angles (parse_angle_triple); false if
+                // the operands do not match the gate.
+                auto push_u = [&](const std::string& name, const float* ang, std::string operands) {
+                    for (char& c : operands) if (c == ',') c = ' ';
+                    std::istringstream os(operands);
+                    std::string qa, qb, extra;
+                    Instr I{};
+                    I.op = name == "cu" ? Opcode::CU : Opcode::U;
+                    if (!(os >> qa) || !parse_qubit_index(qa, I.a)) return false;
+                    if (I.op == Opcode::CU && (!(os >> qb) || !parse_qubit_index(qb, I.b))) return false;
+                    if (os >> extra) return false;
+                    I.has_angle0 = true; I.angle0 = ang[0];
+                    I.has_angle1 = true; I.angle1 = ang[1];
+                    I.has_angle2 = true; I.angle2 = ang[2];
+                    P.instrs.push_back(I);
+                    return true;
+                    };
+
                 if (lower.rfind("openqasm", 0) == 0) continue;
                 if (lower.rfind("include", 0) == 0) continue;
-                if (lower.rfind("qubit", 0) == 0)   continue;
-                if (lower.rfind("bit", 0) == 0)     continue;
+
+                // Register declarations (QUBS/BITS)
+                {
+                    const std::string kw = lower.substr(0, lower.find_first_not_of("abcdefghijklmnopqrstuvwxyz"));
+                    if (kw == "qubit" || kw == "bit" || kw == "qreg" || kw == "creg") {
+                        const bool is_qubit = kw == "qubit" || kw == "qreg";
+                        std::vector<Register>& regs = is_qubit ? P.qregs : P.cregs;
+                        std::string decl = s;
+                        if (decl.back() == ';') decl.pop_back();
+                        Register r;
+                        if (!parse_declaration(kw, decl.substr(kw.size()), r)) { warn_skip("bad declaration"); continue; }
+                        if (is_qubit ? implicit_q : implicit_c) { warn_skip("declaration after the first implicit operand"); continue; }
+                        auto same_name = [&r](const Register& o) { return o.name == r.name; };
+                        if (std::any_of(P.qregs.begin(), P.qregs.end(), same_name) ||
+                            std::any_of(P.cregs.begin(), P.cregs.end(), same_name)) {
+                            warn_skip("register redeclared");
+                            continue;
+                        }
+                        r.first = register_space(regs);
+                        if (uint64_t(r.first) + r.size > uint64_t(INT32_MAX)) { warn_skip("register too large"); continue; }
+                        regs.push_back(r);
+                        continue;
+                    }
+                }
 
                 // MEASURE: c[k] = measure q[i];
                 {
                     // robust check for pattern
                     size_t eq = lower.find('=');
-                    if (lower.rfind("c[", 0) == 0 && eq != std::string::npos && lower.find("measure", eq) != std::string::npos) {
+                    if (lower.rfind("if", 0) != 0 && eq != std::string::npos && lower.find("measure", eq) != std::string::npos) {
                         std::string lhs = trim_copy(s.substr(0, eq));
                         std::string rhs = trim_copy(s.substr(eq + 1));
                         int bit_idx = -1, q_idx = -1;
@@ -113,7 +252,7 @@ namespace qbin_compiler {
                         warn_skip("unsupported if format");
                         continue;
                     }
-                    std::string cond = trim_copy(lower.substr(lp + 1, rp - lp - 1)); // e.g. c[1] == 1
+                    std::string cond = trim_copy(s.substr(lp + 1, rp - lp - 1)); // e.g. c[1] == 1
                     // parse lhs op rhs
                     bool is_eq = true;
                     size_t pos_eq = cond.find("==");
@@ -138,6 +277,15 @@ namespace qbin_compiler {
                     // Body inside braces
                     std::string body = trim_copy(s.substr(lb + 1, rb - lb - 1));
                     if (!body.empty() && body.back() == ';') body.pop_back();
+                    {
+                        std::string name, operands;
+                        float ang3[3];
+                        if (parse_angle_triple(body, name, ang3, operands)) {
+                            if (!push_u(name, ang3, operands)) warn_skip("if-body bad u/cu operands");
+                            Instr End{}; End.op = Opcode::ENDIF; P.instrs.push_back(End);
+                            continue;
+                        }
+                    }
                     for (char& c : body) if (c == ',') c = ' ';
                     std::istringstream ts(body);
                     std::string tok0;
@@ -208,6 +356,14 @@ namespace qbin_compiler {
                 // Regular statements
                 // Remove trailing ';' then normalize commas to spaces
                 if (!s.empty() && s.back() == ';') s.pop_back();
+                {
+                    std::string name, operands;
+                    float ang3[3];
+                    if (parse_angle_triple(s, name, ang3, operands)) {
+                        if (!push_u(name, ang3, operands)) warn_skip("bad u/cu operands");
+                        continue;
+                    }
+                }
                 for (char& c : s) if (c == ',') c = ' ';
                 std::istringstream ts(s);
                 std::string tok0;
@@ -265,6 +421,7 @@ namespace qbin_compiler {
                 // Unsupported
                 warn_skip("unsupported");
             }
+            stamp();
             return P;
         }
 
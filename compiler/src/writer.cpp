@@ -0,0 +1,224 @@
+#include "qbin_compiler/writer.hpp"
+
+#include "qbin_compiler/encoder.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace qbin_compiler {
+
+    // Operand mask bits (spec 7.7.1)
+    static const uint8_t kMaskA = 1u << 0;
+    static const uint8_t kMaskB = 1u << 1;
+    static const uint8_t kMaskAngle0 = 1u << 3;
+    static const uint8_t kMaskAngles = 7u << 3;    // angle_0..angle_2 (U, CU)
+    static const uint8_t kMaskAux = 1u << 7;
+
+    // Records are assembled in a small stack buffer and appended with one
+    // insert, so the vector checks its capacity once per instruction instead
+    // of once per byte.
+    namespace {
+    struct Rec {
+        uint8_t b[32];
+        size_t n = 0;
+        Rec(frontend::Opcode op, uint8_t mask) { b[0] = static_cast<uint8_t>(op); b[1] = mask; n = 2; }
+        void uleb(uint32_t v) {
+            while (v >= 0x80u) { b[n++] = static_cast<uint8_t>(v | 0x80u); v >>= 7; }
+            b[n++] = static_cast<uint8_t>(v);
+        }
+        void u32(uint32_t v) {
+            for (int k = 0; k < 4; ++k) b[n++] = static_cast<uint8_t>(v >> (8 * k));
+        }
+        void angle(float theta) {
+            uint32_t u;
+            std::memcpy(&u, &theta, sizeof(u));
+            b[n++] = 0;   // tag 0 = f32
+            u32(u);
+        }
+    };
+    } // namespace
+
+    // Qubit and bit indices must fit the decoder's int operands; larger
+    // ones would also wrap num_qubits_/num_bits_ to 0.
+    static inline void checked(uint32_t v, const char* what) {
+        if (v > uint32_t(INT32_MAX)) {
+            throw std::runtime_error(std::string("Writer: ") + what + " " + std::to_string(v) + " exceeds INT32_MAX");
+        }
+    }
+
+    static inline void push_rec(std::vector<uint8_t>& out, const Rec& r) {
+        out.insert(out.end(), r.b, r.b + r.n);
+    }
+
+    Writer& Writer::gate1(frontend::Opcode op, uint32_t q) {
+        checked(q, "qubit");
+        Rec r(op, kMaskA);
+        r.uleb(q);
+        push_rec(buf_, r);
+        num_qubits_ = std::max(num_qubits_, q + 1);
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::rot1(frontend::Opcode op, float theta, uint32_t q) {
+        checked(q, "qubit");
+        Rec r(op, kMaskA | kMaskAngle0);
+        r.uleb(q);
+        r.angle(theta);
+        push_rec(buf_, r);
+        num_qubits_ = std::max(num_qubits_, q + 1);
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::u(float theta, float phi, float lambda, uint32_t q) {
+        checked(q, "qubit");
+        Rec r(frontend::Opcode::U, kMaskA | kMaskAngles);
+        r.uleb(q);
+        r.angle(theta);
+        r.angle(phi);
+        r.angle(lambda);
+        push_rec(buf_, r);
+        num_qubits_ = std::max(num_qubits_, q + 1);
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::gate2(frontend::Opcode op, uint32_t a, uint32_t b) {
+        checked(a, "qubit");
+        checked(b, "qubit");
+        Rec r(op, kMaskA | kMaskB);
+        r.uleb(a);
+        r.uleb(b);
+        push_rec(buf_, r);
+        num_qubits_ = std::max({ num_qubits_, a + 1, b + 1 });
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::rot2(frontend::Opcode op, float theta, uint32_t a, uint32_t b) {
+        checked(a, "qubit");
+        checked(b, "qubit");
+        Rec r(op, kMaskA | kMaskB | kMaskAngle0);
+        r.uleb(a);
+        r.uleb(b);
+        r.angle(theta);
+        push_rec(buf_, r);
+        num_qubits_ = std::max({ num_qubits_, a + 1, b + 1 });
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::cu(float theta, float phi, float lambda, uint32_t a, uint32_t b) {
+        checked(a, "qubit");
+        checked(b, "qubit");
+        Rec r(frontend::Opcode::CU, kMaskA | kMaskB | kMaskAngles);
+        r.uleb(a);
+        r.uleb(b);
+        r.angle(theta);
+        r.angle(phi);
+        r.angle(lambda);
+        push_rec(buf_, r);
+        num_qubits_ = std::max({ num_qubits_, a + 1, b + 1 });
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::measure(uint32_t q, uint32_t bit) {
+        checked(q, "qubit");
+        checked(bit, "bit");
+        Rec r(frontend::Opcode::MEASURE, kMaskA | kMaskAux);
+        r.uleb(q);
+        r.u32(bit);
+        push_rec(buf_, r);
+        num_qubits_ = std::max(num_qubits_, q + 1);
+        num_bits_ = std::max(num_bits_, bit + 1);
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::barrier() {
+        buf_.push_back(static_cast<uint8_t>(frontend::Opcode::BARRIER));
+        buf_.push_back(0);
+        ++count_;
+        return *this;
+    }
+
+    void Writer::begin_if(frontend::Opcode op, uint32_t bit, bool value) {
+        checked(bit, "bit");
+        Rec r(op, kMaskAux);
+        r.u32(bit);
+        r.b[r.n++] = value ? 1 : 0;   // imm8 compare value
+        push_rec(buf_, r);
+        num_bits_ = std::max(num_bits_, bit + 1);
+        ++count_;
+    }
+
+    Writer& Writer::end_if() {
+        buf_.push_back(static_cast<uint8_t>(frontend::Opcode::ENDIF));
+        buf_.push_back(0);
+        ++count_;
+        return *this;
+    }
+
+    Writer& Writer::append(const frontend::Instr& in) {
+        const uint8_t op = static_cast<uint8_t>(in.op);
+        const bool has_bit = in.has_aux && (op == 0x30 || op == 0x81 || op == 0x82);
+        if (has_bit) checked(in.aux_u32, "bit");
+        enc::encode_instr(in, buf_);
+        for (int q : { in.a, in.b, in.c }) {
+            if (q >= 0) num_qubits_ = std::max(num_qubits_, uint32_t(q) + 1);
+        }
+        if (has_bit) {
+            num_bits_ = std::max(num_bits_, in.aux_u32 + 1);
+        }
+        ++count_;
+        return *this;
+    }
+
+    std::vector<uint8_t> Writer::finish() {
+        std::vector<enc::Section> head;
+        if (num_qubits_ > 0) {
+            head.emplace_back();
+            head.back().id = enc::section_id("QUBS");
+            enc::encode_qubs_section(num_qubits_, {}, head.back().payload);
+        }
+        if (num_bits_ > 0) {
+            head.emplace_back();
+            head.back().id = enc::section_id("BITS");
+            enc::encode_bits_section(num_bits_, {}, head.back().payload);
+        }
+        // Close the gap left for a longer prefix, then fill it in.
+        const size_t count_len = enc::uleb128_size(count_);
+        const size_t records = buf_.size() - kPrefix;
+        const std::vector<uint8_t> prefix = enc::assemble_prefix(head, enc::section_id("INST"),
+            static_cast<uint32_t>(4 + count_len + records), 0);
+        const size_t start = prefix.size() + 4 + count_len;
+        std::memmove(buf_.data() + start, buf_.data() + kPrefix, records);
+        buf_.resize(start + records);
+        std::memcpy(buf_.data(), prefix.data(), prefix.size());
+        uint8_t* p = buf_.data() + prefix.size();
+        std::memcpy(p, "INST", 4);
+        p += 4;
+        uint64_t n = count_;
+        while (n >= 0x80u) { *p++ = static_cast<uint8_t>(n | 0x80u); n >>= 7; }
+        *p = static_cast<uint8_t>(n);
+
+        std::vector<uint8_t> out = std::move(buf_);
+        clear();
+        return out;
+    }
+
+    void Writer::clear() {
+        buf_.assign(kPrefix, 0);
+        count_ = 0;
+        num_qubits_ = 0;
+        num_bits_ = 0;
+    }
+
+} // namespace qbin_compiler
@@ -0,0 +1,74 @@
+#ifndef QBIN_DECOMPILER_COMPRESSION_HPP
+#define QBIN_DECOMPILER_COMPRESSION_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Reading compressed sections (spec 8): a section with flags bit0 holds a
+// CPRZ wrapper around a zstd frame. The frame may need the dictionary named by
+// the file's CPRS section (spec 7.8), which is either embedded in CPRS or
+// external, in which case the reader must be given it in a DictionarySet.
+// Without zstd (QBIN_HAVE_ZSTD unset at build time) compressed sections are
+// reported as unsupported; everything else works unchanged.
+
+namespace qbin_decompiler {
+
+    // True if this build can decompress zstd sections.
+    bool zstd_available();
+
+    // zstd dictionary id from the dictionary header (magic EC30A437, then the
+    // id), or 0 if `dict` is not a zstd dictionary.
+    uint32_t zstd_dict_id(const uint8_t* dict, size_t n);
+
+    // External dictionaries, looked up by id. Each one is prepared for
+    // decompression once when added; lookups are thread-safe afterwards.
+    class DictionarySet {
+    public:
+        DictionarySet();
+        ~DictionarySet();
+        DictionarySet(DictionarySet&&) noexcept;
+        DictionarySet& operator=(DictionarySet&&) noexcept;
+        DictionarySet(const DictionarySet&) = delete;
+        DictionarySet& operator=(const DictionarySet&) = delete;
+
+        // Adds a zstd dictionary (as written by qbin-dict); replaces an earlier
+        // one with the same id.
+        bool add(std::vector<uint8_t> dict, std::string& err);
+        bool add_file(const std::string& path, std::string& err);
+
+        size_t size() const;
+        bool contains(uint32_t dict_id) const;
+
+        struct Impl;
+        const Impl* impl() const { return impl_.get(); }
+
+    private:
+        std::unique_ptr<Impl> impl_;
+    };
+
+    // CPRS payload (spec 7.8). For an embedded dictionary `dict` points into
+    // the file buffer.
+    struct CompressionInfo {
+        uint8_t alg = 0;            // 1 = zstd
+        uint32_t dict_id = 0;
+        bool embedded = false;
+        const uint8_t* dict = nullptr;
+        size_t dict_size = 0;
+    };
+
+    bool decode_cprs_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        CompressionInfo& out, std::string& err);
+
+    // Unwraps the CPRZ payload at [off, off+size) into `out`. `cprs` is the
+    // file's CPRS (nullptr if absent); `dicts` resolves external dictionaries.
+    bool decompress_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const CompressionInfo* cprs, const DictionarySet* dicts,
+        std::vector<uint8_t>& out, std::string& err);
+
+} // namespace qbin_decompiler
+
+#endif // QBIN_DECOMPILER_COMPRESSION_HPP
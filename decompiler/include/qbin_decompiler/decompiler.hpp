@@ -1,17 +1,42 @@
 #ifndef QBIN_DECOMPILER_DECOMPILER_HPP
 #define QBIN_DECOMPILER_DECOMPILER_HPP
 
+#include <cstddef>
 #include <cstdint>
 #include <string>
 #include <vector>
 
 namespace qbin_decompiler {
 
+    class DictionarySet;
+
+    struct DecompileOptions {
+        bool verbose = false;
+        // Emit GATE entries as `gate gN a, b { ... }` definitions and CALLG as
+        // calls to them. By default calls are inlined, which reproduces the
+        // source the compiler saw.
+        bool gate_defs = false;
+        // External zstd dictionaries for files whose CPRS section does not
+        // embed its dictionary (nullptr = none).
+        const DictionarySet* dicts = nullptr;
+    };
+
     bool decode_qbin_to_qasm(const std::vector<uint8_t>& bytes,
         std::string& qasm_out,
         std::string& err,
         bool verbose = false);
 
+    bool decode_qbin_to_qasm(const std::vector<uint8_t>& bytes,
+        std::string& qasm_out,
+        std::string& err,
+        const DecompileOptions& opts);
+
+    // Same, over a borrowed buffer (e.g. a request payload).
+    bool decode_qbin_to_qasm(const uint8_t* data, size_t size,
+        std::string& qasm_out,
+        std::string& err,
+        const DecompileOptions& opts);
+
 } // namespace qbin_decompiler
 
 #endif // QBIN_DECOMPILER_DECOMPILER_HPP
@@ -0,0 +1,106 @@
+#ifndef QBIN_DECOMPILER_PROGRAM_CACHE_HPP
+#define QBIN_DECOMPILER_PROGRAM_CACHE_HPP
+
+#include "qbin_decompiler/reader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <future>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// ASCII-only header.
+// In-process cache of decoded programs (decode_program() results) for
+// services that decode the same files repeatedly.
+//
+//  - Entries are keyed by an identity string (the file path) plus a stamp:
+//    size and mtime for files, size and a caller-supplied content hash for
+//    buffers. A changed stamp replaces the entry.
+//  - The key space is split over independently locked shards; the lock is
+//    never held while reading or decoding.
+//  - Concurrent requests for the same missing entry decode once: the first
+//    caller decodes, the others wait for its result.
+//  - Each shard keeps its share of the memory budget and evicts least
+//    recently used entries. Handles are immutable and stay valid after
+//    eviction.
+
+namespace qbin_decompiler {
+
+    struct ProgramCacheStats {
+        uint64_t hits = 0;          // served from a decoded or in-flight entry
+        uint64_t misses = 0;        // decoded by this call
+        uint64_t failures = 0;      // decodes that failed (not cached)
+        uint64_t evictions = 0;
+        uint64_t entries = 0;
+        uint64_t bytes = 0;         // estimated heap size of cached programs
+    };
+
+    class ProgramCache {
+    public:
+        using Handle = std::shared_ptr<const DecodedProgram>;
+
+        static constexpr size_t kDefaultBudget = size_t(64) << 20;
+        static constexpr size_t kDefaultShards = 16;
+
+        explicit ProgramCache(size_t memory_budget = kDefaultBudget, size_t shards = kDefaultShards);
+
+        ProgramCache(const ProgramCache&) = delete;
+        ProgramCache& operator=(const ProgramCache&) = delete;
+
+        // Decoded program of the file at `path`, or nullptr with `err` set.
+        Handle get_file(const std::string& path, std::string& err);
+
+        // Decoded program of an in-memory QBIN image. `id` names the program,
+        // `content_hash` identifies this version of it (e.g. the spec 5.3
+        // integrity hash); the bytes are only read on a miss.
+        Handle get_buffer(const std::string& id, uint64_t content_hash,
+            const uint8_t* b, size_t n, std::string& err);
+
+        // Drops every entry; outstanding handles stay valid.
+        void clear();
+
+        ProgramCacheStats stats() const;
+
+        // Estimated heap bytes held by one decoded program.
+        static size_t footprint(const DecodedProgram& p);
+
+    private:
+        struct Result {
+            Handle prog;
+            std::string err;
+        };
+        struct Entry {
+            uint64_t size = 0;
+            uint64_t tag = 0;       // mtime or content hash
+            std::shared_future<std::shared_ptr<const Result>> result;
+            uint64_t gen = 0;       // distinguishes re-inserted entries
+            bool ready = false;
+            size_t bytes = 0;
+            std::list<std::string>::iterator lru;   // front = most recent
+        };
+        struct Shard {
+            mutable std::mutex mu;
+            std::unordered_map<std::string, Entry> map;
+            std::list<std::string> lru;
+            size_t bytes = 0;
+            uint64_t next_gen = 0;
+            uint64_t hits = 0, misses = 0, failures = 0, evictions = 0;
+        };
+
+        template <class Load>
+        Handle get(const std::string& id, uint64_t size, uint64_t tag, Load&& load, std::string& err);
+
+        Shard& shard_for(const std::string& id);
+        void evict_locked(Shard& s, const std::string& keep);
+
+        std::vector<std::unique_ptr<Shard>> shards_;
+        size_t shard_budget_;
+    };
+
+} // namespace qbin_decompiler
+
+#endif // QBIN_DECOMPILER_PROGRAM_CACHE_HPP
@@ -0,0 +1,222 @@
+#ifndef QBIN_DECOMPILER_READER_HPP
+#define QBIN_DECOMPILER_READER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Low-level QBIN readers used by the decompiler. All functions take a
+// pointer/size view of the whole file, bounds-check every access and report
+// failures through `err` (returning false).
+
+namespace qbin_decompiler {
+
+    // Section table flags (spec 5.2)
+    constexpr uint32_t kSectionCompressed = 1u << 0;     // payload is a CPRZ wrapper (spec 8)
+    constexpr uint32_t kSectionChecksummed = 1u << 1;
+    constexpr uint32_t kSectionDeltaOperands = 1u << 2;  // INST qubit operands (spec 7.7.4) / DEBG mappings (spec 14) delta coded
+
+    class DictionarySet;
+
+    struct SectionEntry {
+        uint32_t id;
+        uint32_t offset;
+        uint32_t size;
+        uint32_t flags;
+    };
+
+    struct DecodedInstr {
+        uint8_t opcode = 0;
+        int a = -1, b = -1, c = -1;
+        bool has_angle0 = false;
+        float angle0 = 0.0f;          // resolved value, also for param_ref angles
+        bool angle0_is_param = false;
+        uint32_t angle0_param = 0;    // PARS index if angle0_is_param
+        bool has_angle1 = false;      // angle_1/angle_2 (phi, lambda of U/CU), as angle_0
+        float angle1 = 0.0f;
+        bool angle1_is_param = false;
+        uint32_t angle1_param = 0;
+        bool has_angle2 = false;
+        float angle2 = 0.0f;
+        bool angle2_is_param = false;
+        uint32_t angle2_param = 0;
+        bool has_param_ref = false;   // operand mask bit 6 (CALLG gate_id)
+        uint32_t param_ref = 0;
+        bool has_aux = false;
+        uint32_t aux = 0;
+        bool has_imm8 = false;
+        uint8_t imm8 = 0;
+    };
+
+    // One PARS entry (spec 7.5).
+    struct DecodedParam {
+        uint32_t name_str_id = 0;
+        uint8_t kind = 0;         // 0=angle, 1=scalar, 2=duration
+        uint8_t value_tag = 0;    // 0=unbound, 1=const_f32, 2=expr_ref
+        float value = 0.0f;       // valid if value_tag == 1
+        uint32_t expr_id = 0;     // valid if value_tag == 2
+    };
+
+    // One GATE entry (spec 7.6); body qubits are formal indices 0..num_qubits-1.
+    struct DecodedGate {
+        uint32_t name_str_id = 0;
+        uint32_t num_qubits = 0;
+        uint32_t num_params = 0;
+        uint8_t flags = 0;
+        std::vector<DecodedInstr> body;
+    };
+
+    // One named range of a QUBS/BITS table (spec 7.3/7.4).
+    struct RegisterAlias {
+        uint32_t first = 0;
+        uint32_t count = 0;
+        uint32_t name_str_id = 0;
+    };
+
+    // QUBS or BITS: size of the qubit/bit index space and its named ranges
+    // (none: the whole space is q / c). QUBS coordinates are skipped.
+    struct DecodedRegisters {
+        bool present = false;
+        uint32_t count = 0;
+        std::vector<RegisterAlias> aliases;
+    };
+
+    // Declared sizes INST operands are checked against while decoding
+    // (spec 11 rule 4): qubit operands (ERR_QUBIT_OOB) and the bit index of
+    // MEASURE/IF_EQ/IF_NEQ (ERR_BIT_OOB).
+    struct OperandBounds {
+        static constexpr uint32_t kUnbounded = 0xFFFFFFFFu;
+        uint32_t qubits = kUnbounded;
+        uint32_t bits = kUnbounded;
+    };
+
+    // DEBG (spec 14): source position of the instructions from instr_index on.
+    struct SourceLoc {
+        uint32_t file_id = 0;     // index into DecodedDebug::files; 0 with file_count 0
+        uint32_t line = 0;        // 1-based
+        uint32_t column = 0;      // 1-based
+    };
+
+    struct DebugMapping {
+        uint32_t instr_index = 0;
+        SourceLoc loc;
+    };
+
+    struct DecodedDebug {
+        std::vector<uint32_t> files;          // path_str_id per source file (may be empty)
+        std::vector<DebugMapping> mappings;   // ascending instr_index
+
+        // Position of INST record `instr_index`: the last mapping at or before
+        // it. False if the first mapping comes later.
+        bool locate(size_t instr_index, SourceLoc& out) const;
+    };
+
+    inline uint32_t rd_u32le(const uint8_t* p) {
+        return (uint32_t)p[0] | ((uint32_t)p[1] << 8) | ((uint32_t)p[2] << 16) | ((uint32_t)p[3] << 24);
+    }
+
+    // ULEB128 at b[i], never reading at or past `end`. Advances i; false if
+    // the value is unterminated before `end` or longer than 64 bits.
+    inline bool read_uleb128_bound(const uint8_t* b, size_t& i, size_t end, uint64_t& v) {
+        v = 0; int shift = 0;
+        while (i < end) {
+            uint8_t byte = b[i++];
+            v |= (uint64_t)(byte & 0x7F) << shift;
+            if ((byte & 0x80) == 0) return true;
+            shift += 7;
+            if (shift > 63) return false;
+        }
+        return false;
+    }
+
+    // Section ID from its 4-character ASCII tag, as stored in the table.
+    inline uint32_t section_id(const char* tag) {
+        return rd_u32le(reinterpret_cast<const uint8_t*>(tag));
+    }
+
+    std::string id_to_ascii(uint32_t id);
+
+    // First entry with the given id, or nullptr.
+    const SectionEntry* find_section(const std::vector<SectionEntry>& table, uint32_t id);
+
+    bool decode_header_and_table(const uint8_t* b, size_t n,
+        uint8_t& major, uint8_t& minor,
+        uint32_t& table_off, uint32_t& table_size,
+        std::vector<SectionEntry>& table,
+        std::string& err, bool verbose = false);
+
+    bool decode_strs_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        std::vector<std::string>& out, std::string& err);
+
+    // QUBS / BITS. Aliases must lie within the declared count and name an
+    // entry of `strs` (pass nullptr when the file has no STRS section).
+    bool decode_qubs_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<std::string>* strs, DecodedRegisters& out, std::string& err);
+    bool decode_bits_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<std::string>* strs, DecodedRegisters& out, std::string& err);
+
+    bool decode_pars_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        std::vector<DecodedParam>& out, std::string& err);
+
+    // Decodes GATE, including each inline body (an INST payload); body
+    // param_ref angles resolve against `params` like the main stream.
+    bool decode_gate_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<DecodedParam>* params,
+        std::vector<DecodedGate>& out, std::string& err);
+
+    // Decodes INST at [off, off+size). param_ref angles (tag 1) are resolved
+    // against `params`; a reference to a missing or non-constant entry is an
+    // error. Pass nullptr when the file has no PARS section. `section_flags`
+    // is the table entry's flags; kSectionDeltaOperands selects delta-coded
+    // qubit operands. Operands are checked against `bounds` as they are read.
+    bool decode_inst_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<DecodedParam>* params,
+        std::vector<DecodedInstr>& out, std::string& err, bool verbose = false,
+        uint32_t section_flags = 0, const OperandBounds& bounds = OperandBounds());
+
+    // Decodes DEBG. With kSectionDeltaOperands in `section_flags` the
+    // mapping fields are deltas to the previous mapping and file_id is only
+    // present when file_count > 1 (spec 14).
+    bool decode_debg_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        DecodedDebug& out, std::string& err, uint32_t section_flags = 0);
+
+    // CALLG checks: gate id within `gates` (ERR_GATE_ID_OOB) and operand
+    // count equal to the gate's num_qubits.
+    bool check_calls(const std::vector<DecodedInstr>& instrs,
+        const std::vector<DecodedGate>& gates, std::string& err);
+
+    // Everything needed to interpret the instruction stream of one file.
+    struct DecodedProgram {
+        uint8_t major = 0, minor = 0;
+        std::vector<std::string> strings;   // STRS (empty if absent)
+        DecodedRegisters qubits, bits;      // QUBS / BITS (present == false if absent)
+        std::vector<DecodedParam> params;   // PARS (empty if absent)
+        std::vector<DecodedGate> gates;     // GATE (empty if absent)
+        std::vector<DecodedInstr> instrs;   // INST
+    };
+
+    // Header, table, STRS, QUBS, BITS, PARS, GATE and INST in one call.
+    // Validates CALLG gate ids (ERR_GATE_ID_OOB) and operand counts against
+    // the GATE table, and INST operands against QUBS/BITS. Compressed
+    // sections are inflated first; `dicts` supplies external dictionaries
+    // named by CPRS (see compression.hpp). Other sections are not read; use
+    // SectionReader (section_reader.hpp) to reach them.
+    bool decode_program(const uint8_t* b, size_t n, DecodedProgram& out,
+        std::string& err, bool verbose = false, const DictionarySet* dicts = nullptr);
+
+    // Replaces every CALLG by its gate body with formals bound to the call's
+    // a/b/c operands (recursively, nesting depth <= 8). The expanded length
+    // is computed first (once per gate); a stream that would grow beyond
+    // 4M instructions is rejected before anything is appended.
+    // If `origin` is non-null it receives, per output instruction, the index
+    // of the input instruction it came from.
+    bool inline_gate_calls(const std::vector<DecodedInstr>& in,
+        const std::vector<DecodedGate>& gates,
+        std::vector<DecodedInstr>& out, std::string& err,
+        std::vector<uint32_t>* origin = nullptr);
+
+} // namespace qbin_decompiler
+
+#endif // QBIN_DECOMPILER_READER_HPP
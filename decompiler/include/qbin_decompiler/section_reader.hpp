@@ -0,0 +1,89 @@
+#ifndef QBIN_DECOMPILER_SECTION_READER_HPP
+#define QBIN_DECOMPILER_SECTION_READER_HPP
+
+#include "qbin_decompiler/compression.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Lazy access to the sections of one file. open() checks only the header and
+// the section table; each section is inflated, validated and decoded on its
+// first access and kept, so a consumer pays for the sections it reads and no
+// others (CPRS only when a compressed section is read, DEBG typically only
+// on an error path). The file buffer is borrowed and must outlive the reader.
+// A section that fails to decode reports the same error on every access.
+// Not thread-safe.
+
+namespace qbin_decompiler {
+
+    class SectionReader {
+    public:
+        // Header and section table (bounds of every entry).
+        bool open(const uint8_t* b, size_t n, std::string& err,
+            bool verbose = false, const DictionarySet* dicts = nullptr);
+
+        uint8_t major() const { return prog_.major; }
+        uint8_t minor() const { return prog_.minor; }
+        const std::vector<SectionEntry>& table() const { return table_; }
+
+        // First table entry with the given id, or nullptr.
+        const SectionEntry* find(uint32_t id) const { return find_section(table_, id); }
+
+        // Payload bytes of a table() entry, inflated if the section is
+        // compressed (kept until the reader is destroyed).
+        bool payload(const SectionEntry& e, const uint8_t*& p, size_t& size, std::string& err);
+
+        // Decoded sections; `out` is nullptr if the file has no such section.
+        bool strings(const std::vector<std::string>*& out, std::string& err);
+        bool qubits(const DecodedRegisters*& out, std::string& err);
+        bool bits(const DecodedRegisters*& out, std::string& err);
+        bool params(const std::vector<DecodedParam>*& out, std::string& err);
+        bool gates(const std::vector<DecodedGate>*& out, std::string& err);
+        bool debug(const DecodedDebug*& out, std::string& err);
+
+        // INST, resolved against PARS and checked against GATE, QUBS and BITS
+        // (all decoded on the way). A file without INST is an error.
+        bool instrs(const std::vector<DecodedInstr>*& out, std::string& err);
+
+        // Decodes INST as above and moves PARS, GATE and INST into `out`
+        // without copying; afterwards those three can no longer be accessed
+        // through this reader (other sections still can). STRS, QUBS and
+        // BITS are copied.
+        bool release_program(DecodedProgram& out, std::string& err);
+
+    private:
+        enum class State : uint8_t { Unread, Ok, Failed, Released };
+        struct Slot {
+            State state = State::Unread;
+            std::string err;
+        };
+
+        // Runs `decode` on the first access of `s`; replays the outcome after.
+        template <class Fn>
+        bool once(Slot& s, const char* name, std::string& err, Fn&& decode);
+
+        // Payload without caching the inflated copy (reuses scratch_).
+        bool section_bytes(const SectionEntry& e, const uint8_t*& p, size_t& size, std::string& err);
+        bool compression(const CompressionInfo*& out, std::string& err);
+
+        const uint8_t* b_ = nullptr;
+        size_t n_ = 0;
+        bool verbose_ = false;
+        const DictionarySet* dicts_ = nullptr;
+        std::vector<SectionEntry> table_;
+
+        Slot cprs_, strs_, qubs_, bits_, pars_, gate_, inst_, debg_;
+        CompressionInfo cprs_info_;
+        DecodedProgram prog_;           // header version + STRS/QUBS/BITS/PARS/GATE/INST
+        DecodedDebug debug_;
+        std::vector<std::vector<uint8_t>> inflated_;   // payload() cache, per table entry
+        std::vector<uint8_t> scratch_;
+    };
+
+} // namespace qbin_decompiler
+
+#endif // QBIN_DECOMPILER_SECTION_READER_HPP
@@ -0,0 +1,168 @@
+#include "qbin_decompiler/compression.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <cstdint>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef QBIN_HAVE_ZSTD
+#include <zstd.h>
+#endif
+
+namespace qbin_decompiler {
+
+    // Decompression bomb guard (spec 16): no section inflates beyond this.
+    static const uint32_t kMaxRawSize = 256u << 20;
+
+    static const uint8_t kAlgZstd = 1;
+
+    bool zstd_available() {
+#ifdef QBIN_HAVE_ZSTD
+        return true;
+#else
+        return false;
+#endif
+    }
+
+    uint32_t zstd_dict_id(const uint8_t* dict, size_t n) {
+        if (n < 8 || rd_u32le(dict) != 0xEC30A437u) return 0;
+        return rd_u32le(dict + 4);
+    }
+
+#ifdef QBIN_HAVE_ZSTD
+    struct DictionarySet::Impl {
+        struct Dict {
+            std::vector<uint8_t> bytes;
+            ZSTD_DDict* ddict = nullptr;
+        };
+        std::map<uint32_t, Dict> by_id;
+
+        ~Impl() {
+            for (auto& kv : by_id) ZSTD_freeDDict(kv.second.ddict);
+        }
+        const Dict* find(uint32_t id) const {
+            auto it = by_id.find(id);
+            return it == by_id.end() ? nullptr : &it->second;
+        }
+    };
+
+    // One decompression context per thread, reused across sections and files
+    namespace {
+    struct DCtxHolder {
+        ZSTD_DCtx* ctx = ZSTD_createDCtx();
+        ~DCtxHolder() { ZSTD_freeDCtx(ctx); }
+    };
+    } // namespace
+
+    static ZSTD_DCtx* thread_dctx() {
+        thread_local DCtxHolder h;
+        return h.ctx;
+    }
+#else
+    struct DictionarySet::Impl {
+        std::map<uint32_t, std::vector<uint8_t>> by_id;
+    };
+#endif
+
+    DictionarySet::DictionarySet() : impl_(new Impl) {}
+    DictionarySet::~DictionarySet() = default;
+    DictionarySet::DictionarySet(DictionarySet&&) noexcept = default;
+    DictionarySet& DictionarySet::operator=(DictionarySet&&) noexcept = default;
+
+    bool DictionarySet::add(std::vector<uint8_t> dict, std::string& err) {
+        const uint32_t id = zstd_dict_id(dict.data(), dict.size());
+        if (id == 0) { err = "not a zstd dictionary (missing magic or dictionary id 0)"; return false; }
+#ifdef QBIN_HAVE_ZSTD
+        ZSTD_DDict* dd = ZSTD_createDDict(dict.data(), dict.size());
+        if (!dd) { err = "cannot load zstd dictionary " + std::to_string(id); return false; }
+        Impl::Dict& slot = impl_->by_id[id];
+        ZSTD_freeDDict(slot.ddict);
+        slot.bytes = std::move(dict);
+        slot.ddict = dd;
+#else
+        impl_->by_id[id] = std::move(dict);
+#endif
+        return true;
+    }
+
+    bool DictionarySet::add_file(const std::string& path, std::string& err) {
+        std::ifstream f(path, std::ios::binary);
+        if (!f) { err = "cannot open dictionary: " + path; return false; }
+        std::vector<uint8_t> bytes((std::istreambuf_iterator<char>(f)), std::istreambuf_iterator<char>());
+        if (!add(std::move(bytes), err)) { err = path + ": " + err; return false; }
+        return true;
+    }
+
+    size_t DictionarySet::size() const {
+        return impl_ ? impl_->by_id.size() : 0;
+    }
+
+    bool DictionarySet::contains(uint32_t dict_id) const {
+        return impl_ && impl_->by_id.count(dict_id) != 0;
+    }
+
+    bool decode_cprs_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        CompressionInfo& out, std::string& err) {
+        if (off + size > n) { err = "CPRS OOB"; return false; }
+        size_t i = off, end = off + size;
+        if (i + 10 > end || std::memcmp(&b[i], "CPRS", 4) != 0) { err = "CPRS magic missing"; return false; }
+        i += 4;
+        out = CompressionInfo{};
+        out.alg = b[i++];
+        out.dict_id = rd_u32le(&b[i]); i += 4;
+        const uint8_t embedded = b[i++];
+        if (out.alg != kAlgZstd) { err = "CPRS: unsupported algorithm " + std::to_string(out.alg); return false; }
+        if (embedded > 1) { err = "CPRS: bad embedded flag"; return false; }
+        out.embedded = embedded == 1;
+        if (out.embedded) {
+            uint64_t len = 0;
+            if (!read_uleb128_bound(b, i, end, len) || len > end - i) { err = "CPRS: dictionary OOB"; return false; }
+            out.dict = b + i;
+            out.dict_size = (size_t)len;
+        }
+        return true;
+    }
+
+    bool decompress_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const CompressionInfo* cprs, const DictionarySet* dicts,
+        std::vector<uint8_t>& out, std::string& err) {
+        if (off + size > n) { err = "compressed section OOB"; return false; }
+        if (size < 9 || std::memcmp(&b[off], "CPRZ", 4) != 0) { err = "CPRZ magic missing"; return false; }
+        const uint8_t alg = b[off + 4];
+        const uint32_t raw_size = rd_u32le(&b[off + 5]);
+        if (alg != kAlgZstd) { err = "unsupported compression algorithm " + std::to_string(alg); return false; }
+        if (raw_size > kMaxRawSize) { err = "raw_size " + std::to_string(raw_size) + " exceeds limit"; return false; }
+#ifdef QBIN_HAVE_ZSTD
+        const uint8_t* src = b + off + 9;
+        const size_t src_size = size - 9;
+        out.resize(raw_size);
+        ZSTD_DCtx* dctx = thread_dctx();
+        if (!dctx) { err = "cannot create zstd context"; return false; }
+        size_t r;
+        if (cprs && cprs->embedded) {
+            r = ZSTD_decompress_usingDict(dctx, out.data(), out.size(), src, src_size, cprs->dict, cprs->dict_size);
+        }
+        else if (cprs) {
+            const DictionarySet::Impl::Dict* d = (dicts && dicts->impl()) ? dicts->impl()->find(cprs->dict_id) : nullptr;
+            if (!d) { err = "needs zstd dictionary " + std::to_string(cprs->dict_id) + " (pass it with --dict)"; return false; }
+            r = ZSTD_decompress_usingDDict(dctx, out.data(), out.size(), src, src_size, d->ddict);
+        }
+        else {
+            r = ZSTD_decompressDCtx(dctx, out.data(), out.size(), src, src_size);
+        }
+        if (ZSTD_isError(r)) { err = std::string("zstd: ") + ZSTD_getErrorName(r); return false; }
+        if (r != raw_size) { err = "decompressed size does not match raw_size"; return false; }
+        return true;
+#else
+        (void)cprs; (void)dicts; (void)out;
+        err = "compressed section, but this build has no zstd support";
+        return false;
+#endif
+    }
+
+} // namespace qbin_decompiler
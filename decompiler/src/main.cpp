@@ -1,3 +1,4 @@
+#include "qbin_decompiler/compression.hpp"
 #include "qbin_decompiler/decompiler.hpp"
 
 #include <cstdint>
@@ -20,15 +21,22 @@ static bool read_file(const std::string& path, std::vector<uint8_t>& out) {
 
 int main(int argc, char** argv) {
     if (argc < 2) {
-        std::cerr << "Usage: " << argv[0] << " input.qbin [-o output.qasm] [--verbose]\n";
+        std::cerr << "Usage: " << argv[0] << " input.qbin [-o output.qasm] [--gate-defs] [--dict file]... [--verbose]\n";
         return 1;
     }
     std::string in_path, out_path;
-    bool verbose = false;
+    qbin_decompiler::DecompileOptions opts;
+    qbin_decompiler::DictionarySet dicts;
+    std::string err;
     for (int i = 1; i < argc; ++i) {
         std::string a = argv[i];
         if (a == "-o" && i + 1 < argc) out_path = argv[++i];
-        else if (a == "--verbose" || a == "-v") verbose = true;
+        else if (a == "--verbose" || a == "-v") opts.verbose = true;
+        else if (a == "--gate-defs") opts.gate_defs = true;
+        else if (a == "--dict" && i + 1 < argc) {
+            if (!dicts.add_file(argv[++i], err)) { std::cerr << err << "\n"; return 1; }
+            opts.dicts = &dicts;
+        }
         else if (!a.empty() && a[0] != '-') in_path = a;
         else { std::cerr << "Unknown option: " << a << "\n"; return 1; }
     }
@@ -40,8 +48,8 @@ int main(int argc, char** argv) {
         return 1;
     }
 
-    std::string qasm, err;
-    if (!qbin_decompiler::decode_qbin_to_qasm(buf, qasm, err, verbose)) {
+    std::string qasm;
+    if (!qbin_decompiler::decode_qbin_to_qasm(buf, qasm, err, opts)) {
         std::cerr << "INST decode error: " << err << "\n";
         return 1;
     }
@@ -0,0 +1,186 @@
+#include "qbin_decompiler/program_cache.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <exception>
+#include <filesystem>
+#include <fstream>
+#include <functional>
+#include <string>
+#include <system_error>
+#include <utility>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+namespace qbin_decompiler {
+
+    ProgramCache::ProgramCache(size_t memory_budget, size_t shards) {
+        shards = std::max<size_t>(1, shards);
+        shards_.reserve(shards);
+        for (size_t i = 0; i < shards; ++i) shards_.emplace_back(new Shard());
+        shard_budget_ = memory_budget / shards;
+    }
+
+    ProgramCache::Shard& ProgramCache::shard_for(const std::string& id) {
+        return *shards_[std::hash<std::string>{}(id) % shards_.size()];
+    }
+
+    size_t ProgramCache::footprint(const DecodedProgram& p) {
+        size_t n = sizeof(DecodedProgram);
+        n += p.instrs.capacity() * sizeof(DecodedInstr);
+        n += p.params.capacity() * sizeof(DecodedParam);
+        n += p.gates.capacity() * sizeof(DecodedGate);
+        for (const auto& g : p.gates) n += g.body.capacity() * sizeof(DecodedInstr);
+        for (const auto& str : p.strings) n += sizeof(std::string) + str.capacity();
+        n += (p.qubits.aliases.capacity() + p.bits.aliases.capacity()) * sizeof(RegisterAlias);
+        return n;
+    }
+
+    void ProgramCache::evict_locked(Shard& s, const std::string& keep) {
+        auto it = s.lru.end();
+        while (s.bytes > shard_budget_ && it != s.lru.begin()) {
+            --it;
+            auto e = s.map.find(*it);
+            // In-flight entries have no size yet and the new entry stays
+            // until the next insert, even if it alone exceeds the budget.
+            if (e == s.map.end() || !e->second.ready || *it == keep) continue;
+            s.bytes -= e->second.bytes;
+            s.map.erase(e);
+            it = s.lru.erase(it);
+            ++s.evictions;
+        }
+    }
+
+    template <class Load>
+    ProgramCache::Handle ProgramCache::get(const std::string& id, uint64_t size, uint64_t tag,
+        Load&& load, std::string& err) {
+        Shard& s = shard_for(id);
+        std::promise<std::shared_ptr<const Result>> promise;
+        std::shared_future<std::shared_ptr<const Result>> fut;
+        bool owner = false;
+        uint64_t gen = 0;
+        {
+            std::lock_guard<std::mutex> lock(s.mu);
+            auto it = s.map.find(id);
+            if (it != s.map.end() && it->second.size == size && it->second.tag == tag) {
+                s.lru.splice(s.lru.begin(), s.lru, it->second.lru);
+                fut = it->second.result;
+                ++s.hits;
+            }
+            else {
+                if (it != s.map.end()) {
+                    // Stale version: replace. A pending decode of it still
+                    // completes for its waiters but is not cached.
+                    if (it->second.ready) s.bytes -= it->second.bytes;
+                    s.lru.erase(it->second.lru);
+                    s.map.erase(it);
+                }
+                Entry e;
+                e.size = size;
+                e.tag = tag;
+                e.result = promise.get_future().share();
+                e.gen = gen = ++s.next_gen;
+                s.lru.push_front(id);
+                e.lru = s.lru.begin();
+                fut = e.result;
+                s.map.emplace(id, std::move(e));
+                ++s.misses;
+                owner = true;
+            }
+        }
+
+        if (owner) {
+            auto r = std::make_shared<Result>();
+            auto prog = std::make_shared<DecodedProgram>();
+            bool ok = false;
+            try {
+                ok = load(*prog, r->err);
+            }
+            catch (const std::exception& ex) {
+                r->err = ex.what();
+            }
+            size_t bytes = 0;
+            if (ok) {
+                prog->instrs.shrink_to_fit();
+                bytes = footprint(*prog) + id.size();
+                r->prog = std::move(prog);
+            }
+            promise.set_value(r);
+
+            // The entry may have been replaced or cleared while decoding
+            std::lock_guard<std::mutex> lock(s.mu);
+            auto it = s.map.find(id);
+            const bool still_ours = it != s.map.end() && it->second.gen == gen;
+            if (!ok) ++s.failures;
+            if (still_ours) {
+                if (!ok) {
+                    // Failures are not cached so a fixed file is picked up
+                    s.lru.erase(it->second.lru);
+                    s.map.erase(it);
+                }
+                else {
+                    it->second.ready = true;
+                    it->second.bytes = bytes;
+                    s.bytes += bytes;
+                    evict_locked(s, id);
+                }
+            }
+        }
+
+        std::shared_ptr<const Result> r = fut.get();
+        if (!r->prog) err = r->err;
+        return r->prog;
+    }
+
+    ProgramCache::Handle ProgramCache::get_file(const std::string& path, std::string& err) {
+        std::error_code ec;
+        const uintmax_t size = fs::file_size(path, ec);
+        if (ec) { err = "Cannot stat " + path + ": " + ec.message(); return nullptr; }
+        const auto mtime = fs::last_write_time(path, ec);
+        if (ec) { err = "Cannot stat " + path + ": " + ec.message(); return nullptr; }
+        const uint64_t tag = static_cast<uint64_t>(mtime.time_since_epoch().count());
+
+        return get(path, static_cast<uint64_t>(size), tag,
+            [&path](DecodedProgram& out, std::string& e) {
+                std::ifstream ifs(path, std::ios::binary);
+                if (!ifs) { e = "Cannot open " + path; return false; }
+                std::vector<uint8_t> buf((std::istreambuf_iterator<char>(ifs)), std::istreambuf_iterator<char>());
+                return decode_program(buf.data(), buf.size(), out, e);
+            }, err);
+    }
+
+    ProgramCache::Handle ProgramCache::get_buffer(const std::string& id, uint64_t content_hash,
+        const uint8_t* b, size_t n, std::string& err) {
+        return get(id, static_cast<uint64_t>(n), content_hash,
+            [b, n](DecodedProgram& out, std::string& e) {
+                return decode_program(b, n, out, e);
+            }, err);
+    }
+
+    void ProgramCache::clear() {
+        for (auto& sp : shards_) {
+            Shard& s = *sp;
+            std::lock_guard<std::mutex> lock(s.mu);
+            s.map.clear();
+            s.lru.clear();
+            s.bytes = 0;
+        }
+    }
+
+    ProgramCacheStats ProgramCache::stats() const {
+        ProgramCacheStats t;
+        for (const auto& sp : shards_) {
+            const Shard& s = *sp;
+            std::lock_guard<std::mutex> lock(s.mu);
+            t.hits += s.hits;
+            t.misses += s.misses;
+            t.failures += s.failures;
+            t.evictions += s.evictions;
+            t.entries += s.map.size();
+            t.bytes += s.bytes;
+        }
+        return t;
+    }
+
+} // namespace qbin_decompiler
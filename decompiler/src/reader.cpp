@@ -0,0 +1,534 @@
+#include "qbin_decompiler/reader.hpp"
+
+#include "qbin_decompiler/section_reader.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace qbin_decompiler {
+
+    std::string id_to_ascii(uint32_t id) {
+        char s[5];
+        s[0] = char(id & 0xFF);
+        s[1] = char((id >> 8) & 0xFF);
+        s[2] = char((id >> 16) & 0xFF);
+        s[3] = char((id >> 24) & 0xFF);
+        s[4] = 0;
+        return std::string(s);
+    }
+
+    const SectionEntry* find_section(const std::vector<SectionEntry>& table, uint32_t id) {
+        for (const auto& e : table) { if (e.id == id) return &e; }
+        return nullptr;
+    }
+
+    // SLEB128 (svarint) with local end bound
+    static bool read_sleb128_bound(const uint8_t* b, size_t& i, size_t end, int64_t& v) {
+        uint64_t u = 0; int shift = 0;
+        while (i < end) {
+            uint8_t byte = b[i++];
+            u |= (uint64_t)(byte & 0x7F) << shift;
+            shift += 7;
+            if ((byte & 0x80) == 0) {
+                if (shift < 64 && (byte & 0x40)) u |= ~uint64_t(0) << shift;
+                v = (int64_t)u;
+                return true;
+            }
+            if (shift > 63) return false;
+        }
+        return false;
+    }
+
+    static inline int64_t unzigzag(uint64_t v) {
+        return (int64_t)(v >> 1) ^ -(int64_t)(v & 1);
+    }
+
+    static bool read_f32le_bound(const uint8_t* b, size_t& i, size_t end, float& out) {
+        if (i + 4 > end) return false;
+        uint32_t u = rd_u32le(&b[i]); i += 4;
+        std::memcpy(&out, &u, 4);
+        return true;
+    }
+
+    bool decode_header_and_table(const uint8_t* b, size_t n,
+        uint8_t& major, uint8_t& minor,
+        uint32_t& table_off, uint32_t& table_size,
+        std::vector<SectionEntry>& table,
+        std::string& err, bool verbose) {
+        if (n < 24) { err = "file too small for header"; return false; }
+        if (std::memcmp(b, "QBIN", 4) != 0) { err = "bad magic"; return false; }
+        major = b[4];
+        minor = b[5];
+        uint8_t hdr_size = b[7];
+        if (hdr_size != 24) { err = "unexpected header size"; return false; }
+        uint32_t section_count = rd_u32le(&b[8]);
+        table_off = rd_u32le(&b[12]);
+        table_size = rd_u32le(&b[16]);
+        if ((size_t)table_off + (size_t)table_size > n) { err = "section table OOB"; return false; }
+        if (section_count == 0 || table_size != section_count * 16) { err = "table size mismatch"; return false; }
+        table.clear();
+        table.reserve(section_count);
+        size_t p = table_off;
+        for (uint32_t i = 0; i < section_count; ++i) {
+            SectionEntry e;
+            e.id = rd_u32le(&b[p + 0]);
+            e.offset = rd_u32le(&b[p + 4]);
+            e.size = rd_u32le(&b[p + 8]);
+            e.flags = rd_u32le(&b[p + 12]);
+            if ((size_t)e.offset + (size_t)e.size > n) { err = "section out of bounds"; return false; }
+            table.push_back(e);
+            p += 16;
+        }
+        if (verbose) {
+            for (const auto& e : table) {
+                std::fprintf(stderr, "  [%s] off=%u size=%u flags=%u\n", id_to_ascii(e.id).c_str(), e.offset, e.size, e.flags);
+            }
+        }
+        return true;
+    }
+
+    bool decode_strs_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        std::vector<std::string>& out, std::string& err) {
+        if (off + size > n) { err = "STRS OOB"; return false; }
+        size_t i = off, end = off + size;
+        if (size < 8 || std::memcmp(&b[i], "STRS", 4) != 0) { err = "STRS magic missing"; return false; }
+        const uint32_t count = rd_u32le(&b[i + 4]);
+        i += 8;
+        // Each entry takes at least 2 bytes (length + terminator)
+        if (count > (end - i) / 2) { err = "STRS count exceeds section size"; return false; }
+        out.clear();
+        out.reserve(count);
+        for (uint32_t k = 0; k < count; ++k) {
+            uint64_t len = 0;
+            if (!read_uleb128_bound(b, i, end, len) || len >= end - i || b[i + len] != 0) {
+                err = "truncated string (idx=" + std::to_string(k) + ")"; return false;
+            }
+            out.emplace_back(reinterpret_cast<const char*>(&b[i]), (size_t)len);
+            i += (size_t)len + 1;
+        }
+        return true;
+    }
+
+    // QUBS and BITS differ only in QUBS's optional coordinates.
+    static bool decode_register_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const char* magic, const std::vector<std::string>* strs, DecodedRegisters& out, std::string& err) {
+        const std::string tag(magic);
+        if (off + size > n) { err = tag + " OOB"; return false; }
+        size_t i = off, end = off + size;
+        if (i + 4 > end || std::memcmp(&b[i], magic, 4) != 0) { err = tag + " magic missing"; return false; }
+        i += 4;
+        uint64_t count = 0, aliases = 0;
+        if (!read_uleb128_bound(b, i, end, count) || count > 0x7FFFFFFFu) { err = "bad " + tag + " count"; return false; }
+        if (tag == "QUBS") {
+            if (i >= end) { err = "QUBS layout_present OOB"; return false; }
+            if (b[i++] != 0) {
+                if (count * 12 > end - i) { err = "QUBS layout OOB"; return false; }
+                i += (size_t)count * 12;
+            }
+        }
+        // Each alias takes at least 3 bytes
+        if (!read_uleb128_bound(b, i, end, aliases) || aliases > (end - i) / 3) { err = "bad " + tag + " alias_count"; return false; }
+        out.present = true;
+        out.count = (uint32_t)count;
+        out.aliases.clear();
+        out.aliases.reserve((size_t)aliases);
+        for (uint64_t k = 0; k < aliases; ++k) {
+            uint64_t first = 0, len = 0, name = 0;
+            if (!read_uleb128_bound(b, i, end, first) || !read_uleb128_bound(b, i, end, len) ||
+                !read_uleb128_bound(b, i, end, name)) {
+                err = "truncated " + tag + " alias (idx=" + std::to_string(k) + ")"; return false;
+            }
+            if (first > count || len > count - first) { err = tag + " alias out of range (idx=" + std::to_string(k) + ")"; return false; }
+            if (!strs || name >= strs->size()) { err = tag + " name_str_id OOB (idx=" + std::to_string(k) + ")"; return false; }
+            out.aliases.push_back({ (uint32_t)first, (uint32_t)len, (uint32_t)name });
+        }
+        return true;
+    }
+
+    bool decode_qubs_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<std::string>* strs, DecodedRegisters& out, std::string& err) {
+        return decode_register_section(b, n, off, size, "QUBS", strs, out, err);
+    }
+
+    bool decode_bits_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<std::string>* strs, DecodedRegisters& out, std::string& err) {
+        return decode_register_section(b, n, off, size, "BITS", strs, out, err);
+    }
+
+    bool decode_pars_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        std::vector<DecodedParam>& out, std::string& err) {
+        if (off + size > n) { err = "PARS OOB"; return false; }
+        size_t i = off, end = off + size;
+        if (i + 4 > end || std::memcmp(&b[i], "PARS", 4) != 0) { err = "PARS magic missing"; return false; }
+        i += 4;
+        uint64_t count = 0;
+        if (!read_uleb128_bound(b, i, end, count)) { err = "bad param_count"; return false; }
+        // Each entry takes at least 3 bytes; reject counts the payload cannot hold
+        if (count > (end - i) / 3) { err = "param_count exceeds PARS size"; return false; }
+        out.clear();
+        out.reserve((size_t)count);
+        for (uint64_t k = 0; k < count; ++k) {
+            DecodedParam p{};
+            uint64_t v;
+            if (!read_uleb128_bound(b, i, end, v)) { err = "bad param name (idx=" + std::to_string(k) + ")"; return false; }
+            p.name_str_id = (uint32_t)v;
+            if (i + 2 > end) { err = "truncated param (idx=" + std::to_string(k) + ")"; return false; }
+            p.kind = b[i++];
+            p.value_tag = b[i++];
+            if (p.value_tag == 1) {
+                if (!read_f32le_bound(b, i, end, p.value)) { err = "param f32 OOB (idx=" + std::to_string(k) + ")"; return false; }
+            }
+            else if (p.value_tag == 2) {
+                if (!read_uleb128_bound(b, i, end, v)) { err = "bad param expr_id (idx=" + std::to_string(k) + ")"; return false; }
+                p.expr_id = (uint32_t)v;
+            }
+            else if (p.value_tag != 0) { err = "unknown param value_tag (idx=" + std::to_string(k) + ")"; return false; }
+            out.push_back(p);
+        }
+        return true;
+    }
+
+    bool decode_gate_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<DecodedParam>* params,
+        std::vector<DecodedGate>& out, std::string& err) {
+        if (off + size > n) { err = "GATE OOB"; return false; }
+        size_t i = off, end = off + size;
+        if (i + 4 > end || std::memcmp(&b[i], "GATE", 4) != 0) { err = "GATE magic missing"; return false; }
+        i += 4;
+        uint64_t count = 0;
+        if (!read_uleb128_bound(b, i, end, count)) { err = "bad decl_count"; return false; }
+        // Each entry takes at least 5 bytes; reject counts the payload cannot hold
+        if (count > (end - i) / 5) { err = "decl_count exceeds GATE size"; return false; }
+        out.clear();
+        out.reserve((size_t)count);
+        for (uint64_t k = 0; k < count; ++k) {
+            DecodedGate g{};
+            uint64_t name = 0, nq = 0, np = 0, body_len = 0;
+            if (!read_uleb128_bound(b, i, end, name) ||
+                !read_uleb128_bound(b, i, end, nq) ||
+                !read_uleb128_bound(b, i, end, np) ||
+                i >= end) {
+                err = "truncated gate decl (idx=" + std::to_string(k) + ")"; return false;
+            }
+            g.flags = b[i++];
+            if (!read_uleb128_bound(b, i, end, body_len) || body_len > end - i) {
+                err = "gate body OOB (idx=" + std::to_string(k) + ")"; return false;
+            }
+            if (nq > 3) { err = "gate takes more than 3 qubits (idx=" + std::to_string(k) + ")"; return false; }
+            g.name_str_id = (uint32_t)name;
+            g.num_qubits = (uint32_t)nq;
+            g.num_params = (uint32_t)np;
+            if (body_len > 0) {
+                std::string body_err;
+                if (!decode_inst_section(b, n, i, (size_t)body_len, params, g.body, body_err)) {
+                    err = "gate " + std::to_string(k) + " body: " + body_err; return false;
+                }
+                for (const auto& bi : g.body) {
+                    if (bi.a >= (int)nq || bi.b >= (int)nq || bi.c >= (int)nq) {
+                        err = "gate " + std::to_string(k) + " body uses a qubit beyond num_qubits"; return false;
+                    }
+                }
+            }
+            i += (size_t)body_len;
+            out.push_back(std::move(g));
+        }
+        return true;
+    }
+
+    // One tagged angle slot (spec 7.7.1) of instruction k; param_ref angles
+    // resolve to their PARS constant.
+    static bool read_angle_slot(const uint8_t* b, size_t& i, size_t end,
+        const std::vector<DecodedParam>* params, uint64_t k,
+        bool& has, float& value, bool& is_param, uint32_t& param, std::string& err) {
+        if (i >= end) { err = "angle tag OOB"; return false; }
+        uint8_t tag = b[i++];
+        if (tag == 0) {
+            if (!read_f32le_bound(b, i, end, value)) { err = "angle f32 OOB"; return false; }
+        }
+        else if (tag == 1) {
+            uint64_t id; if (!read_uleb128_bound(b, i, end, id)) { err = "angle param_ref OOB"; return false; }
+            if (!params || id >= params->size()) { err = "param_ref " + std::to_string(id) + " OOB (idx=" + std::to_string(k) + ")"; return false; }
+            const DecodedParam& p = (*params)[(size_t)id];
+            if (p.value_tag != 1) { err = "param_ref " + std::to_string(id) + " has no constant value (idx=" + std::to_string(k) + ")"; return false; }
+            value = p.value;
+            is_param = true; param = (uint32_t)id;
+        }
+        else { err = "unknown angle tag"; return false; }
+        has = true;
+        return true;
+    }
+
+    // "<tag> declares N", or that the section is absent for an unbounded space.
+    static std::string declared(const char* tag, uint32_t count) {
+        if (count == OperandBounds::kUnbounded) return std::string("no ") + tag + " section";
+        return std::string(tag) + " declares " + std::to_string(count);
+    }
+
+    bool decode_inst_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        const std::vector<DecodedParam>* params,
+        std::vector<DecodedInstr>& out, std::string& err, bool verbose,
+        uint32_t section_flags, const OperandBounds& bounds) {
+        if (off + size > n) { err = "INST OOB"; return false; }
+        size_t i = off, end = off + size;
+        if (i + 4 > end) { err = "short INST"; return false; }
+        if (std::memcmp(&b[i], "INST", 4) != 0) { err = "INST magic missing"; return false; }
+        i += 4;
+        uint64_t count = 0;
+        if (!read_uleb128_bound(b, i, end, count)) { err = "bad instr_count"; return false; }
+        // Each instruction takes at least 2 bytes; do not trust count for reserve()
+        if (count > (end - i) / 2) { err = "instr_count exceeds INST size"; return false; }
+        out.clear();
+        out.reserve((size_t)count);
+        const bool delta = (section_flags & kSectionDeltaOperands) != 0;
+        int64_t delta_base = 0;
+        for (uint64_t k = 0; k < count; ++k) {
+            if (i + 2 > end) { err = "truncated instruction header"; return false; }
+            DecodedInstr di{};
+            di.opcode = b[i++];
+            uint8_t mask = b[i++];
+            if (verbose) std::fprintf(stderr, "idx=%llu: op=0x%02X mask=0x%02X @%zu\n",
+                (unsigned long long)k, di.opcode, mask, i);
+
+            // a, b, c
+            if (!delta) {
+                if (mask & (1u << 0)) { uint64_t v; if (!read_uleb128_bound(b, i, end, v) || v > INT32_MAX) { err = "bad a (idx=" + std::to_string(k) + ")"; return false; } di.a = (int)v; }
+                if (mask & (1u << 1)) { uint64_t v; if (!read_uleb128_bound(b, i, end, v) || v > INT32_MAX) { err = "bad b (idx=" + std::to_string(k) + ")"; return false; } di.b = (int)v; }
+                if (mask & (1u << 2)) { uint64_t v; if (!read_uleb128_bound(b, i, end, v) || v > INT32_MAX) { err = "bad c (idx=" + std::to_string(k) + ")"; return false; } di.c = (int)v; }
+            }
+            else {
+                // zigzag(q - ref): ref is the previous slot of this instruction,
+                // or for the first slot the first qubit of the last instruction
+                // that had one (spec 7.7.4)
+                int* const slot[3] = { &di.a, &di.b, &di.c };
+                int64_t ref = delta_base;
+                bool first = true;
+                for (int s = 0; s < 3; ++s) {
+                    if (!(mask & (1u << s))) continue;
+                    uint64_t v;
+                    if (!read_uleb128_bound(b, i, end, v) || v > 0xFFFFFFFFu) { err = std::string("bad ") + char('a' + s) + " (idx=" + std::to_string(k) + ")"; return false; }
+                    const int64_t q = ref + unzigzag(v);
+                    if (q < 0 || q > INT32_MAX) { err = std::string("delta ") + char('a' + s) + " out of range (idx=" + std::to_string(k) + ")"; return false; }
+                    *slot[s] = (int)q;
+                    ref = q;
+                    if (first) { delta_base = q; first = false; }
+                }
+            }
+
+            // ERR_QUBIT_OOB (an absent slot is -1; operands are <= INT32_MAX)
+            const int top = std::max({ di.a, di.b, di.c });
+            if (top >= 0 && uint32_t(top) >= bounds.qubits) {
+                err = "qubit " + std::to_string(top) + " OOB: " + declared("QUBS", bounds.qubits) +
+                    " (idx=" + std::to_string(k) + ")";
+                return false;
+            }
+
+            // angle_0..angle_2
+            if ((mask & (1u << 3)) && !read_angle_slot(b, i, end, params, k, di.has_angle0, di.angle0, di.angle0_is_param, di.angle0_param, err)) return false;
+            if ((mask & (1u << 4)) && !read_angle_slot(b, i, end, params, k, di.has_angle1, di.angle1, di.angle1_is_param, di.angle1_param, err)) return false;
+            if ((mask & (1u << 5)) && !read_angle_slot(b, i, end, params, k, di.has_angle2, di.angle2, di.angle2_is_param, di.angle2_param, err)) return false;
+
+            // param_ref (CALLG gate_id)
+            if (mask & (1u << 6)) {
+                uint64_t v; if (!read_uleb128_bound(b, i, end, v)) { err = "bad param_ref (idx=" + std::to_string(k) + ")"; return false; }
+                di.has_param_ref = true; di.param_ref = (uint32_t)v;
+            }
+
+            // aux_u32
+            if (mask & (1u << 7)) {
+                if (i + 4 > end) { err = "aux OOB"; return false; }
+                di.has_aux = true; di.aux = rd_u32le(&b[i]); i += 4;
+                // ERR_BIT_OOB
+                if ((di.opcode == 0x30 || di.opcode == 0x81 || di.opcode == 0x82) && di.aux >= bounds.bits) {
+                    err = "bit " + std::to_string(di.aux) + " OOB: " + declared("BITS", bounds.bits) +
+                        " (idx=" + std::to_string(k) + ")";
+                    return false;
+                }
+            }
+
+            // IF imm8
+            if (di.opcode == 0x81 || di.opcode == 0x82) {
+                if (i >= end) { err = "if imm8 OOB"; return false; }
+                di.has_imm8 = true; di.imm8 = b[i++];
+            }
+
+            out.push_back(di);
+        }
+        return true;
+    }
+
+    bool check_calls(const std::vector<DecodedInstr>& instrs,
+        const std::vector<DecodedGate>& gates, std::string& err) {
+        for (size_t k = 0; k < instrs.size(); ++k) {
+            const DecodedInstr& di = instrs[k];
+            if (di.opcode != 0x40) continue;
+            if (!di.has_param_ref || di.param_ref >= gates.size()) {
+                err = "CALLG gate_id OOB (idx=" + std::to_string(k) + ")"; return false;
+            }
+            uint32_t nq = (di.a >= 0) + (di.b >= 0) + (di.c >= 0);
+            if (nq != gates[di.param_ref].num_qubits) {
+                err = "CALLG operand count mismatch (idx=" + std::to_string(k) + ")"; return false;
+            }
+        }
+        return true;
+    }
+
+    bool decode_debg_section(const uint8_t* b, size_t n, size_t off, size_t size,
+        DecodedDebug& out, std::string& err, uint32_t section_flags) {
+        if (off + size > n) { err = "DEBG OOB"; return false; }
+        size_t i = off, end = off + size;
+        if (i + 4 > end || std::memcmp(&b[i], "DEBG", 4) != 0) { err = "DEBG magic missing"; return false; }
+        i += 4;
+        uint64_t files = 0, count = 0, v = 0;
+        if (!read_uleb128_bound(b, i, end, files) || files > end - i) { err = "bad file_count"; return false; }
+        out.files.clear();
+        out.files.reserve((size_t)files);
+        for (uint64_t k = 0; k < files; ++k) {
+            if (!read_uleb128_bound(b, i, end, v) || v > 0xFFFFFFFFu) { err = "bad path_str_id (file=" + std::to_string(k) + ")"; return false; }
+            out.files.push_back((uint32_t)v);
+        }
+        // Each mapping takes at least 3 bytes; reject counts the payload cannot hold
+        if (!read_uleb128_bound(b, i, end, count) || count > (end - i) / 3) { err = "bad mapping_count"; return false; }
+        const bool delta = (section_flags & kSectionDeltaOperands) != 0;
+        const uint64_t max_file = files > 0 ? files - 1 : 0;
+        out.mappings.clear();
+        out.mappings.reserve((size_t)count);
+        int64_t index = 0, file = 0, line = 0, col = 0;
+        for (uint64_t k = 0; k < count; ++k) {
+            const std::string at = " (mapping=" + std::to_string(k) + ")";
+            if (!delta) {
+                uint64_t f[4];
+                for (auto& x : f) {
+                    if (!read_uleb128_bound(b, i, end, x) || x > 0xFFFFFFFFu) { err = "bad DEBG mapping" + at; return false; }
+                }
+                if (k > 0 && (int64_t)f[0] < index) { err = "DEBG instr_index not ascending" + at; return false; }
+                index = (int64_t)f[0]; file = (int64_t)f[1]; line = (int64_t)f[2]; col = (int64_t)f[3];
+            }
+            else {
+                int64_t dl = 0, dc = 0;
+                if (!read_uleb128_bound(b, i, end, v) || v > 0xFFFFFFFFu) { err = "bad DEBG instr_index" + at; return false; }
+                index += (int64_t)v;
+                if (files > 1) {
+                    if (!read_uleb128_bound(b, i, end, v) || v > 0xFFFFFFFFu) { err = "bad DEBG file_id" + at; return false; }
+                    file = (int64_t)v;
+                }
+                if (!read_sleb128_bound(b, i, end, dl) || !read_sleb128_bound(b, i, end, dc)) { err = "bad DEBG line/column" + at; return false; }
+                line += dl;
+                col += dc;
+            }
+            if (index > INT32_MAX || (uint64_t)file > max_file ||
+                line < 0 || line > INT32_MAX || col < 0 || col > INT32_MAX) {
+                err = "DEBG mapping out of range" + at; return false;
+            }
+            DebugMapping m;
+            m.instr_index = (uint32_t)index;
+            m.loc.file_id = (uint32_t)file;
+            m.loc.line = (uint32_t)line;
+            m.loc.column = (uint32_t)col;
+            out.mappings.push_back(m);
+        }
+        return true;
+    }
+
+    bool DecodedDebug::locate(size_t instr_index, SourceLoc& out) const {
+        // Last mapping with instr_index <= the requested one
+        size_t lo = 0, hi = mappings.size();
+        while (lo < hi) {
+            const size_t mid = lo + (hi - lo) / 2;
+            if (mappings[mid].instr_index <= instr_index) lo = mid + 1;
+            else hi = mid;
+        }
+        if (lo == 0) return false;
+        out = mappings[lo - 1].loc;
+        return true;
+    }
+
+    bool decode_program(const uint8_t* b, size_t n, DecodedProgram& out,
+        std::string& err, bool verbose, const DictionarySet* dicts) {
+        SectionReader sections;
+        return sections.open(b, n, err, verbose, dicts) && sections.release_program(out, err);
+    }
+
+    // Inlining bomb guard: no stream expands beyond this many instructions
+    // (a few KB of nested GATE bodies can otherwise describe ~100^8).
+    static const uint64_t kMaxInlinedInstrs = 1u << 22;
+    static const int kMaxCallDepth = 8;
+    static const uint64_t kLenUnknown = ~uint64_t(0);
+
+    // Instructions gate `id` expands to, memoized in `len` (kLenUnknown =
+    // not computed yet) and saturated at kMaxInlinedInstrs + 1.
+    static bool expanded_len(uint32_t id, const std::vector<DecodedGate>& gates,
+        std::vector<uint64_t>& len, std::string& err, int depth) {
+        if (depth > kMaxCallDepth) { err = "CALLG nesting too deep"; return false; }
+        if (len[id] != kLenUnknown) return true;
+        uint64_t n = 0;
+        for (const auto& bi : gates[id].body) {
+            if (bi.opcode != 0x40) { ++n; }
+            else {
+                if (!bi.has_param_ref || bi.param_ref >= gates.size()) { err = "CALLG gate_id OOB"; return false; }
+                if (!expanded_len(bi.param_ref, gates, len, err, depth + 1)) return false;
+                n += len[bi.param_ref];
+            }
+            if (n > kMaxInlinedInstrs) { n = kMaxInlinedInstrs + 1; break; }
+        }
+        len[id] = n;
+        return true;
+    }
+
+    static bool inline_call(const DecodedInstr& call, const std::vector<DecodedGate>& gates,
+        std::vector<DecodedInstr>& out, std::string& err, int depth) {
+        if (depth > kMaxCallDepth) { err = "CALLG nesting too deep"; return false; }
+        if (!call.has_param_ref || call.param_ref >= gates.size()) { err = "CALLG gate_id OOB"; return false; }
+        const int actual[3] = { call.a, call.b, call.c };
+        auto bind = [&](int f) { return (f >= 0 && f < 3) ? actual[f] : f; };
+        for (const auto& bi : gates[call.param_ref].body) {
+            DecodedInstr di = bi;
+            di.a = bind(bi.a);
+            di.b = bind(bi.b);
+            di.c = bind(bi.c);
+            if (di.opcode == 0x40) {
+                if (!inline_call(di, gates, out, err, depth + 1)) return false;
+            }
+            else {
+                out.push_back(di);
+            }
+        }
+        return true;
+    }
+
+    bool inline_gate_calls(const std::vector<DecodedInstr>& in,
+        const std::vector<DecodedGate>& gates,
+        std::vector<DecodedInstr>& out, std::string& err,
+        std::vector<uint32_t>* origin) {
+        out.clear();
+        if (origin) origin->clear();
+
+        // Size the expansion before appending anything
+        std::vector<uint64_t> len(gates.size(), kLenUnknown);
+        uint64_t total = 0;
+        for (const auto& di : in) {
+            if (di.opcode != 0x40) { ++total; }
+            else {
+                if (!di.has_param_ref || di.param_ref >= gates.size()) { err = "CALLG gate_id OOB"; return false; }
+                if (!expanded_len(di.param_ref, gates, len, err, 0)) return false;
+                total += len[di.param_ref];
+            }
+            if (total > kMaxInlinedInstrs) {
+                err = "CALLG expansion exceeds " + std::to_string(kMaxInlinedInstrs) + " instructions";
+                return false;
+            }
+        }
+        out.reserve((size_t)total);
+        for (size_t k = 0; k < in.size(); ++k) {
+            const DecodedInstr& di = in[k];
+            if (di.opcode != 0x40) out.push_back(di);
+            else if (!inline_call(di, gates, out, err, 0)) return false;
+            if (origin) origin->resize(out.size(), (uint32_t)k);
+        }
+        return true;
+    }
+
+} // namespace qbin_decompiler
@@ -0,0 +1,246 @@
+#include "qbin_decompiler/section_reader.hpp"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace qbin_decompiler {
+
+    bool SectionReader::open(const uint8_t* b, size_t n, std::string& err,
+        bool verbose, const DictionarySet* dicts) {
+        *this = SectionReader();
+        uint32_t table_off = 0, table_size = 0;
+        if (!decode_header_and_table(b, n, prog_.major, prog_.minor, table_off, table_size, table_, err, verbose)) {
+            return false;
+        }
+        b_ = b;
+        n_ = n;
+        verbose_ = verbose;
+        dicts_ = dicts;
+        inflated_.resize(table_.size());
+        return true;
+    }
+
+    template <class Fn>
+    bool SectionReader::once(Slot& s, const char* name, std::string& err, Fn&& decode) {
+        switch (s.state) {
+        case State::Ok: return true;
+        case State::Failed: err = s.err; return false;
+        case State::Released: err = std::string(name) + " was released by release_program()"; return false;
+        case State::Unread: break;
+        }
+        if (decode(s.err)) {
+            s.state = State::Ok;
+            s.err.clear();
+            return true;
+        }
+        s.state = State::Failed;
+        err = s.err;
+        return false;
+    }
+
+    bool SectionReader::compression(const CompressionInfo*& out, std::string& err) {
+        const SectionEntry* e = find(section_id("CPRS"));
+        out = nullptr;
+        if (!e) return true;
+        if (!once(cprs_, "CPRS", err, [&](std::string& derr) {
+                return decode_cprs_section(b_, n_, e->offset, e->size, cprs_info_, derr);
+            })) {
+            return false;
+        }
+        out = &cprs_info_;
+        return true;
+    }
+
+    bool SectionReader::section_bytes(const SectionEntry& e, const uint8_t*& p, size_t& size, std::string& err) {
+        if (!(e.flags & kSectionCompressed)) {
+            p = b_ + e.offset;
+            size = e.size;
+            return true;
+        }
+        const size_t k = size_t(&e - table_.data());
+        if (k < inflated_.size() && !inflated_[k].empty()) {
+            p = inflated_[k].data();
+            size = inflated_[k].size();
+            return true;
+        }
+        const CompressionInfo* cprs = nullptr;
+        if (!compression(cprs, err)) return false;
+        if (!decompress_section(b_, n_, e.offset, e.size, cprs, dicts_, scratch_, err)) {
+            err = id_to_ascii(e.id) + ": " + err;
+            return false;
+        }
+        p = scratch_.data();
+        size = scratch_.size();
+        return true;
+    }
+
+    bool SectionReader::payload(const SectionEntry& e, const uint8_t*& p, size_t& size, std::string& err) {
+        if (table_.empty() || &e < table_.data() || &e >= table_.data() + table_.size()) {
+            err = "section entry does not belong to this reader";
+            return false;
+        }
+        if (!section_bytes(e, p, size, err)) return false;
+        if (p == scratch_.data()) {
+            std::vector<uint8_t>& keep = inflated_[size_t(&e - table_.data())];
+            keep.swap(scratch_);
+            p = keep.data();
+        }
+        return true;
+    }
+
+    bool SectionReader::strings(const std::vector<std::string>*& out, std::string& err) {
+        const SectionEntry* e = find(section_id("STRS"));
+        out = nullptr;
+        if (!e) return true;
+        if (!once(strs_, "STRS", err, [&](std::string& derr) {
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+                return section_bytes(*e, p, size, derr) &&
+                    decode_strs_section(p, size, 0, size, prog_.strings, derr);
+            })) {
+            return false;
+        }
+        out = &prog_.strings;
+        return true;
+    }
+
+    bool SectionReader::qubits(const DecodedRegisters*& out, std::string& err) {
+        const SectionEntry* e = find(section_id("QUBS"));
+        out = nullptr;
+        if (!e) return true;
+        if (!once(qubs_, "QUBS", err, [&](std::string& derr) {
+                const std::vector<std::string>* strs = nullptr;
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+                return strings(strs, derr) && section_bytes(*e, p, size, derr) &&
+                    decode_qubs_section(p, size, 0, size, strs, prog_.qubits, derr);
+            })) {
+            return false;
+        }
+        out = &prog_.qubits;
+        return true;
+    }
+
+    bool SectionReader::bits(const DecodedRegisters*& out, std::string& err) {
+        const SectionEntry* e = find(section_id("BITS"));
+        out = nullptr;
+        if (!e) return true;
+        if (!once(bits_, "BITS", err, [&](std::string& derr) {
+                const std::vector<std::string>* strs = nullptr;
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+                return strings(strs, derr) && section_bytes(*e, p, size, derr) &&
+                    decode_bits_section(p, size, 0, size, strs, prog_.bits, derr);
+            })) {
+            return false;
+        }
+        out = &prog_.bits;
+        return true;
+    }
+
+    bool SectionReader::params(const std::vector<DecodedParam>*& out, std::string& err) {
+        const SectionEntry* e = find(section_id("PARS"));
+        out = nullptr;
+        if (!e) return true;
+        if (!once(pars_, "PARS", err, [&](std::string& derr) {
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+                return section_bytes(*e, p, size, derr) &&
+                    decode_pars_section(p, size, 0, size, prog_.params, derr);
+            })) {
+            return false;
+        }
+        out = &prog_.params;
+        return true;
+    }
+
+    bool SectionReader::gates(const std::vector<DecodedGate>*& out, std::string& err) {
+        const SectionEntry* e = find(section_id("GATE"));
+        out = nullptr;
+        if (!e) return true;
+        if (!once(gate_, "GATE", err, [&](std::string& derr) {
+                const std::vector<DecodedParam>* params = nullptr;
+                if (!this->params(params, derr)) return false;
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+                if (!section_bytes(*e, p, size, derr) ||
+                    !decode_gate_section(p, size, 0, size, params, prog_.gates, derr)) {
+                    return false;
+                }
+                for (const auto& g : prog_.gates) {
+                    if (!check_calls(g.body, prog_.gates, derr)) return false;
+                }
+                return true;
+            })) {
+            return false;
+        }
+        out = &prog_.gates;
+        return true;
+    }
+
+    bool SectionReader::instrs(const std::vector<DecodedInstr>*& out, std::string& err) {
+        out = nullptr;
+        if (!once(inst_, "INST", err, [&](std::string& derr) {
+                const SectionEntry* e = find(section_id("INST"));
+                if (!e) { derr = "No INST section found"; return false; }
+                const std::vector<DecodedParam>* params = nullptr;
+                const std::vector<DecodedGate>* gates = nullptr;
+                const DecodedRegisters* qubs = nullptr;
+                const DecodedRegisters* bits = nullptr;
+                if (!this->params(params, derr) || !this->gates(gates, derr) ||
+                    !qubits(qubs, derr) || !this->bits(bits, derr)) {
+                    return false;
+                }
+                OperandBounds bounds;
+                if (qubs) bounds.qubits = qubs->count;
+                if (bits) bounds.bits = bits->count;
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+                return section_bytes(*e, p, size, derr) &&
+                    decode_inst_section(p, size, 0, size, params, prog_.instrs, derr, verbose_, e->flags, bounds) &&
+                    check_calls(prog_.instrs, prog_.gates, derr);
+            })) {
+            return false;
+        }
+        out = &prog_.instrs;
+        return true;
+    }
+
+    bool SectionReader::debug(const DecodedDebug*& out, std::string& err) {
+        const SectionEntry* e = find(section_id("DEBG"));
+        out = nullptr;
+        if (!e) return true;
+        if (!once(debg_, "DEBG", err, [&](std::string& derr) {
+                const uint8_t* p = nullptr;
+                size_t size = 0;
+                return section_bytes(*e, p, size, derr) &&
+                    decode_debg_section(p, size, 0, size, debug_, derr, e->flags);
+            })) {
+            return false;
+        }
+        out = &debug_;
+        return true;
+    }
+
+    bool SectionReader::release_program(DecodedProgram& out, std::string& err) {
+        const std::vector<DecodedInstr>* instrs = nullptr;
+        if (!this->instrs(instrs, err)) return false;
+        out.major = prog_.major;
+        out.minor = prog_.minor;
+        out.strings = prog_.strings;
+        out.qubits = prog_.qubits;
+        out.bits = prog_.bits;
+        out.params = std::move(prog_.params);
+        out.gates = std::move(prog_.gates);
+        out.instrs = std::move(prog_.instrs);
+        prog_.params.clear();
+        prog_.gates.clear();
+        prog_.instrs.clear();
+        for (Slot* s : { &pars_, &gate_, &inst_ }) {
+            if (s->state == State::Ok) s->state = State::Released;
+        }
+        return true;
+    }
+
+} // namespace qbin_decompiler
@@ -0,0 +1,59 @@
+#ifndef QBIN_LINKER_LINKER_HPP
+#define QBIN_LINKER_LINKER_HPP
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// QBIN linker: concatenates the INST streams of several QBIN files into one
+// program without decoding them to instructions.
+//
+//  - Records of an input that needs no renumbering (no offsets, PARS/GATE ids
+//    unchanged) are copied with a single memcpy; otherwise each record is
+//    walked once and only the affected varints are rewritten (qubits, bit
+//    index of MEASURE/IF_*, angle param_refs, CALLG gate ids).
+//  - STRS, PARS and GATE tables are merged; equal entries are stored once
+//    (strings always, PARS/GATE unless dedup is off). Gate bodies keep their
+//    formal qubits and only get their PARS/GATE ids remapped. The merged
+//    STRS holds only the strings PARS/GATE names use and is left out when
+//    there are none.
+//  - QUBS/BITS sizes are merged (the highest offset + count) when every
+//    input declares them; register names are dropped.
+//  - The output is rebuilt with enc::assemble_qbin (fresh section table and
+//    header CRC). Other sections (META, DEBG, SIGN, ...) do not survive
+//    concatenation and are dropped; see LinkStats::dropped.
+
+namespace qbin_linker {
+
+    struct LinkInput {
+        const uint8_t* data = nullptr;
+        size_t size = 0;
+        uint32_t qubit_offset = 0;   // added to every qubit operand of the main stream
+        uint32_t bit_offset = 0;     // added to the bit index of MEASURE and IF_EQ/IF_NEQ
+    };
+
+    struct LinkOptions {
+        bool dedup = true;           // store equal PARS/GATE entries once
+    };
+
+    struct LinkStats {
+        size_t inputs = 0;
+        uint64_t instrs = 0;
+        size_t inputs_copied = 0;    // INST records taken verbatim (memcpy)
+        size_t inputs_rewritten = 0; // INST records walked and renumbered
+        size_t strings_in = 0, strings_out = 0;
+        size_t params_in = 0, params_out = 0;
+        size_t gates_in = 0, gates_out = 0;
+        std::vector<std::string> dropped;  // "<TAG> (input <k>)" per dropped section or register names
+    };
+
+    // Links `inputs` in order into `out`. Inputs must be QBIN v1 files with an
+    // uncompressed INST section; on failure `err` names the offending input.
+    bool link_qbin(const std::vector<LinkInput>& inputs, const LinkOptions& opts,
+        std::vector<uint8_t>& out, std::string& err, LinkStats* stats = nullptr);
+
+} // namespace qbin_linker
+
+#endif // QBIN_LINKER_LINKER_HPP
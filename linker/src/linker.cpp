@@ -0,0 +1,424 @@
+#include "qbin_linker/linker.hpp"
+
+#include "qbin_compiler/encoder.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <limits>
+#include <string>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace qbin_linker {
+
+    namespace enc = qbin_compiler::enc;
+    using qbin_decompiler::DecodedParam;
+    using qbin_decompiler::read_uleb128_bound;
+    using qbin_decompiler::SectionEntry;
+
+    static const uint32_t kUnmapped = std::numeric_limits<uint32_t>::max();
+    static const uint32_t kInProgress = kUnmapped - 1;
+
+    // GATE entry as stored; body points into the input buffer.
+    struct RawGate {
+        uint64_t name_str_id = 0, num_qubits = 0, num_params = 0;
+        uint8_t flags = 0;
+        const uint8_t* body = nullptr;
+        size_t body_len = 0;
+    };
+
+    // One input after the section lookup. INST records are not decoded.
+    struct Unit {
+        const uint8_t* b = nullptr;
+        size_t n = 0;
+        uint64_t instr_count = 0;
+        size_t rec_off = 0, rec_end = 0;           // INST records
+        std::vector<std::string> strs;
+        qbin_decompiler::DecodedRegisters qubits, bits;   // QUBS / BITS
+        std::vector<DecodedParam> params;
+        std::vector<RawGate> gates;
+        std::vector<uint32_t> str_map, param_map, gate_map;   // local id -> merged id
+    };
+
+    // Merged tables; each entry is kept in its encoded form, which is also the
+    // dedup key.
+    struct Tables {
+        std::vector<std::string> strs;   // "" and the strings PARS/GATE names use
+        std::unordered_map<std::string, uint32_t> str_ids;
+        std::vector<std::string> params, gates;
+        std::unordered_map<std::string, uint32_t> param_ids, gate_ids;
+    };
+
+    static bool parse_gates(const uint8_t* b, size_t off, size_t size,
+        std::vector<RawGate>& out, std::string& err) {
+        size_t i = off, end = off + size;
+        if (size < 4 || std::memcmp(&b[i], "GATE", 4) != 0) { err = "GATE magic missing"; return false; }
+        i += 4;
+        uint64_t count = 0;
+        if (!read_uleb128_bound(b, i, end, count)) { err = "bad decl_count"; return false; }
+        if (count > (end - i) / 5) { err = "decl_count exceeds GATE size"; return false; }
+        out.clear();
+        out.reserve(size_t(count));
+        for (uint64_t k = 0; k < count; ++k) {
+            RawGate g;
+            uint64_t body_len = 0;
+            if (!read_uleb128_bound(b, i, end, g.name_str_id) ||
+                !read_uleb128_bound(b, i, end, g.num_qubits) ||
+                !read_uleb128_bound(b, i, end, g.num_params) ||
+                i >= end) {
+                err = "truncated gate decl (idx=" + std::to_string(k) + ")"; return false;
+            }
+            g.flags = b[i++];
+            if (!read_uleb128_bound(b, i, end, body_len) || body_len > end - i) {
+                err = "gate body OOB (idx=" + std::to_string(k) + ")"; return false;
+            }
+            g.body = &b[i];
+            g.body_len = size_t(body_len);
+            i += size_t(body_len);
+            out.push_back(g);
+        }
+        return true;
+    }
+
+    static bool is_identity(const std::vector<uint32_t>& m) {
+        for (size_t i = 0; i < m.size(); ++i) {
+            if (m[i] != i) return false;
+        }
+        return true;
+    }
+
+    static bool map_id(const std::vector<uint32_t>& m, uint64_t v, uint32_t& out) {
+        if (v >= m.size()) return false;
+        out = m[size_t(v)];
+        return true;
+    }
+
+    // Copies `count` instruction records from b[i, end) to `out`, adding the
+    // offsets to qubit operands and bit indices and remapping param_refs
+    // through `pmap` and CALLG gate ids through `map_gate`. The records must
+    // end exactly at `end`.
+    template <class MapGate>
+    static bool rewrite_records(const uint8_t* b, size_t i, size_t end, uint64_t count,
+        uint32_t qubit_off, uint32_t bit_off, const std::vector<uint32_t>& pmap,
+        MapGate&& map_gate, std::vector<uint8_t>& out, std::string& err) {
+        for (uint64_t k = 0; k < count; ++k) {
+            if (i + 2 > end) { err = "truncated instruction (idx=" + std::to_string(k) + ")"; return false; }
+            const uint8_t op = b[i++], mask = b[i++];
+            out.push_back(op);
+            out.push_back(mask);
+            uint64_t v = 0;
+            for (int s = 0; s < 3; ++s) {
+                if (!(mask & (1u << s))) continue;
+                if (!read_uleb128_bound(b, i, end, v)) { err = "bad qubit operand (idx=" + std::to_string(k) + ")"; return false; }
+                v += qubit_off;
+                if (v > uint64_t(std::numeric_limits<int>::max())) { err = "qubit index overflow (idx=" + std::to_string(k) + ")"; return false; }
+                enc::push_uleb128(out, v);
+            }
+            for (int s = 3; s < 6; ++s) {
+                if (!(mask & (1u << s))) continue;
+                if (i >= end) { err = "truncated angle (idx=" + std::to_string(k) + ")"; return false; }
+                const uint8_t tag = b[i++];
+                out.push_back(tag);
+                if (tag == 0) {
+                    if (i + 4 > end) { err = "truncated angle (idx=" + std::to_string(k) + ")"; return false; }
+                    enc::push_bytes(out, &b[i], 4);
+                    i += 4;
+                }
+                else if (tag == 1) {
+                    uint32_t id = 0;
+                    if (!read_uleb128_bound(b, i, end, v) || !map_id(pmap, v, id)) {
+                        err = "param_ref out of range (idx=" + std::to_string(k) + ")"; return false;
+                    }
+                    enc::push_uleb128(out, id);
+                }
+                else { err = "unknown angle tag (idx=" + std::to_string(k) + ")"; return false; }
+            }
+            if (mask & (1u << 6)) {
+                uint32_t id = 0;
+                if (!read_uleb128_bound(b, i, end, v)) { err = "bad param_ref (idx=" + std::to_string(k) + ")"; return false; }
+                const bool ok = op == 0x40 ? map_gate(v, id, err) : map_id(pmap, v, id);
+                if (!ok) {
+                    if (err.empty()) err = "param_ref out of range (idx=" + std::to_string(k) + ")";
+                    return false;
+                }
+                enc::push_uleb128(out, id);
+            }
+            if (mask & (1u << 7)) {
+                if (i + 4 > end) { err = "truncated aux (idx=" + std::to_string(k) + ")"; return false; }
+                uint32_t aux = qbin_decompiler::rd_u32le(&b[i]);
+                i += 4;
+                if (op == 0x30 || op == 0x81 || op == 0x82) {
+                    if (uint64_t(aux) + bit_off > std::numeric_limits<uint32_t>::max()) {
+                        err = "bit index overflow (idx=" + std::to_string(k) + ")"; return false;
+                    }
+                    aux += bit_off;
+                }
+                enc::push_u32_le(out, aux);
+            }
+            if (op == 0x81 || op == 0x82) {
+                if (i >= end) { err = "truncated IF immediate (idx=" + std::to_string(k) + ")"; return false; }
+                out.push_back(b[i++]);
+            }
+        }
+        if (i != end) { err = "INST size does not match instr_count"; return false; }
+        return true;
+    }
+
+    static uint32_t intern(std::unordered_map<std::string, uint32_t>& ids,
+        std::vector<std::string>& entries, std::string key, bool dedup) {
+        if (dedup) {
+            auto it = ids.find(key);
+            if (it != ids.end()) return it->second;
+        }
+        const uint32_t id = uint32_t(entries.size());
+        if (dedup) ids.emplace(key, id);
+        entries.push_back(std::move(key));
+        return id;
+    }
+
+    // Merged id of string `local` of `u`, added to the merged STRS on first
+    // use: strings nothing in the output names are not copied.
+    static bool map_name(Unit& u, Tables& t, uint64_t local, uint32_t& out, std::string& err) {
+        if (local == 0) { out = 0; return true; }   // "" is id 0 in every table
+        if (local >= u.str_map.size()) { err = "name_str_id out of range"; return false; }
+        uint32_t& slot = u.str_map[size_t(local)];
+        if (slot == kUnmapped) {
+            const std::string& s = u.strs[size_t(local)];
+            auto it = t.str_ids.find(s);
+            if (it == t.str_ids.end()) {
+                it = t.str_ids.emplace(s, uint32_t(t.strs.size())).first;
+                t.strs.push_back(s);
+            }
+            slot = it->second;
+        }
+        out = slot;
+        return true;
+    }
+
+    // Merged id of gate `gi` of `u`; callees of its body are merged first.
+    static bool map_gate(Unit& u, size_t gi, Tables& t, bool dedup, std::string& err) {
+        uint32_t& slot = u.gate_map[gi];
+        if (slot == kInProgress) { err = "recursive gate (idx=" + std::to_string(gi) + ")"; return false; }
+        if (slot != kUnmapped) return true;
+        slot = kInProgress;
+
+        const RawGate& g = u.gates[gi];
+        uint32_t name = 0;
+        if (!map_name(u, t, g.name_str_id, name, err)) return false;
+        std::vector<uint8_t> body;
+        size_t i = 0;
+        uint64_t count = 0;
+        if (g.body_len < 4 || std::memcmp(g.body, "INST", 4) != 0) { err = "gate body magic missing (idx=" + std::to_string(gi) + ")"; return false; }
+        i = 4;
+        if (!read_uleb128_bound(g.body, i, g.body_len, count)) { err = "bad gate body instr_count (idx=" + std::to_string(gi) + ")"; return false; }
+        enc::push_str(body, "INST");
+        enc::push_uleb128(body, count);
+        auto callee = [&](uint64_t v, uint32_t& id, std::string& e) {
+            if (v >= u.gates.size()) return false;
+            if (!map_gate(u, size_t(v), t, dedup, e)) return false;
+            id = u.gate_map[size_t(v)];
+            return true;
+        };
+        if (!rewrite_records(g.body, i, g.body_len, count, 0, 0, u.param_map, callee, body, err)) {
+            err = "gate " + std::to_string(gi) + ": " + err;
+            return false;
+        }
+
+        std::vector<uint8_t> entry;
+        enc::push_uleb128(entry, name);
+        enc::push_uleb128(entry, g.num_qubits);
+        enc::push_uleb128(entry, g.num_params);
+        entry.push_back(g.flags);
+        enc::push_uleb128(entry, body.size());
+        entry.insert(entry.end(), body.begin(), body.end());
+        slot = intern(t.gate_ids, t.gates, std::string(entry.begin(), entry.end()), dedup);
+        return true;
+    }
+
+    static bool load_unit(const LinkInput& in, Unit& u, Tables& t, bool dedup,
+        size_t index, LinkStats& st, std::string& err) {
+        u.b = in.data;
+        u.n = in.size;
+        uint8_t major = 0, minor = 0;
+        uint32_t table_off = 0, table_size = 0;
+        std::vector<SectionEntry> table;
+        if (!qbin_decompiler::decode_header_and_table(u.b, u.n, major, minor, table_off, table_size, table, err)) return false;
+        if (major != 1) { err = "unsupported major version " + std::to_string(major); return false; }
+
+        const SectionEntry* inst = nullptr;
+        const SectionEntry* pars = nullptr;
+        const SectionEntry* gate = nullptr;
+        const SectionEntry* strs = nullptr;
+        const SectionEntry* qubs = nullptr;
+        const SectionEntry* bits = nullptr;
+        for (const auto& e : table) {
+            const SectionEntry** slot = nullptr;
+            if (e.id == enc::section_id("INST")) slot = &inst;
+            else if (e.id == enc::section_id("PARS")) slot = &pars;
+            else if (e.id == enc::section_id("GATE")) slot = &gate;
+            else if (e.id == enc::section_id("STRS")) slot = &strs;
+            else if (e.id == enc::section_id("QUBS")) slot = &qubs;
+            else if (e.id == enc::section_id("BITS")) slot = &bits;
+            if (!slot) {
+                st.dropped.push_back(qbin_decompiler::id_to_ascii(e.id) + " (input " + std::to_string(index + 1) + ")");
+                continue;
+            }
+            if (*slot) { err = "duplicate " + qbin_decompiler::id_to_ascii(e.id) + " section"; return false; }
+            if (e.flags != 0) { err = qbin_decompiler::id_to_ascii(e.id) + " is compressed, delta coded or checksummed; not supported (compile without --compress/--delta-operands)"; return false; }
+            *slot = &e;
+        }
+        if (!inst) { err = "INST section missing"; return false; }
+
+        // Strings first: register, PARS and GATE names refer to them. They
+        // are merged as map_name() reaches them.
+        if (strs) {
+            if (!qbin_decompiler::decode_strs_section(u.b, u.n, strs->offset, strs->size, u.strs, err)) return false;
+            u.str_map.assign(u.strs.size(), kUnmapped);
+            st.strings_in += u.strs.size();
+        }
+
+        // Only the sizes are merged; register names do not survive.
+        const std::vector<std::string>* names = strs ? &u.strs : nullptr;
+        if (qubs && !qbin_decompiler::decode_qubs_section(u.b, u.n, qubs->offset, qubs->size, names, u.qubits, err)) return false;
+        if (bits && !qbin_decompiler::decode_bits_section(u.b, u.n, bits->offset, bits->size, names, u.bits, err)) return false;
+        for (const auto* t : { &u.qubits, &u.bits }) {
+            if (!t->aliases.empty()) {
+                st.dropped.push_back(std::string(t == &u.qubits ? "QUBS" : "BITS") + " names (input " + std::to_string(index + 1) + ")");
+            }
+        }
+
+        if (pars) {
+            if (!qbin_decompiler::decode_pars_section(u.b, u.n, pars->offset, pars->size, u.params, err)) return false;
+            u.param_map.resize(u.params.size());
+            for (size_t k = 0; k < u.params.size(); ++k) {
+                const DecodedParam& p = u.params[k];
+                uint32_t name = 0;
+                if (!map_name(u, t, p.name_str_id, name, err)) return false;
+                std::vector<uint8_t> entry;
+                enc::push_uleb128(entry, name);
+                entry.push_back(p.kind);
+                entry.push_back(p.value_tag);
+                if (p.value_tag == 1) enc::push_f32_le(entry, p.value);
+                else if (p.value_tag == 2) enc::push_uleb128(entry, p.expr_id);
+                u.param_map[k] = intern(t.param_ids, t.params, std::string(entry.begin(), entry.end()), dedup);
+            }
+            st.params_in += u.params.size();
+        }
+
+        if (gate) {
+            if (!parse_gates(u.b, gate->offset, gate->size, u.gates, err)) return false;
+            u.gate_map.assign(u.gates.size(), kUnmapped);
+            for (size_t k = 0; k < u.gates.size(); ++k) {
+                if (!map_gate(u, k, t, dedup, err)) return false;
+            }
+            st.gates_in += u.gates.size();
+        }
+
+        size_t i = inst->offset, end = size_t(inst->offset) + inst->size;
+        if (inst->size < 4 || std::memcmp(&u.b[i], "INST", 4) != 0) { err = "INST magic missing"; return false; }
+        i += 4;
+        if (!read_uleb128_bound(u.b, i, end, u.instr_count)) { err = "bad instr_count"; return false; }
+        u.rec_off = i;
+        u.rec_end = end;
+        return true;
+    }
+
+    bool link_qbin(const std::vector<LinkInput>& inputs, const LinkOptions& opts,
+        std::vector<uint8_t>& out, std::string& err, LinkStats* stats) {
+        LinkStats st;
+        st.inputs = inputs.size();
+        if (inputs.empty()) { err = "no inputs"; return false; }
+
+        Tables t;
+        t.strs.push_back("");
+        t.str_ids.emplace("", 0);
+        std::vector<Unit> units(inputs.size());
+        size_t rec_bytes = 0;
+        for (size_t k = 0; k < inputs.size(); ++k) {
+            if (!load_unit(inputs[k], units[k], t, opts.dedup, k, st, err)) {
+                err = "input " + std::to_string(k + 1) + ": " + err;
+                return false;
+            }
+            st.instrs += units[k].instr_count;
+            rec_bytes += units[k].rec_end - units[k].rec_off;
+        }
+
+        enc::Section inst;
+        inst.id = enc::section_id("INST");
+        std::vector<uint8_t>& p = inst.payload;
+        p.reserve(4 + enc::uleb128_size(st.instrs) + rec_bytes);
+        enc::push_str(p, "INST");
+        enc::push_uleb128(p, st.instrs);
+        for (size_t k = 0; k < units.size(); ++k) {
+            const Unit& u = units[k];
+            const LinkInput& in = inputs[k];
+            if (in.qubit_offset == 0 && in.bit_offset == 0 && is_identity(u.param_map) && is_identity(u.gate_map)) {
+                enc::push_bytes(p, &u.b[u.rec_off], u.rec_end - u.rec_off);
+                ++st.inputs_copied;
+                continue;
+            }
+            auto gate_id = [&u](uint64_t v, uint32_t& id, std::string&) { return map_id(u.gate_map, v, id); };
+            if (!rewrite_records(u.b, u.rec_off, u.rec_end, u.instr_count, in.qubit_offset, in.bit_offset,
+                    u.param_map, gate_id, p, err)) {
+                err = "input " + std::to_string(k + 1) + ": " + err;
+                return false;
+            }
+            ++st.inputs_rewritten;
+        }
+
+        std::vector<enc::Section> sections;
+        const bool have_strs = t.strs.size() > 1;   // more than ""
+        if (have_strs) {
+            enc::Section s;
+            s.id = enc::section_id("STRS");
+            enc::encode_strs_section(t.strs, s.payload);
+            sections.push_back(std::move(s));
+        }
+        // QUBS/BITS: the declared spaces, shifted by each input's offset, if
+        // every input declares one
+        uint64_t qubit_count = 0, bit_count = 0;
+        bool all_qubs = true, all_bits = true;
+        for (size_t k = 0; k < units.size(); ++k) {
+            all_qubs = all_qubs && units[k].qubits.present;
+            all_bits = all_bits && units[k].bits.present;
+            qubit_count = std::max<uint64_t>(qubit_count, uint64_t(inputs[k].qubit_offset) + units[k].qubits.count);
+            bit_count = std::max<uint64_t>(bit_count, uint64_t(inputs[k].bit_offset) + units[k].bits.count);
+        }
+        if (all_qubs && qubit_count <= 0x7FFFFFFFu) {
+            enc::Section s;
+            s.id = enc::section_id("QUBS");
+            enc::encode_qubs_section(uint32_t(qubit_count), {}, s.payload);
+            sections.push_back(std::move(s));
+        }
+        if (all_bits && bit_count <= 0xFFFFFFFFu) {
+            enc::Section s;
+            s.id = enc::section_id("BITS");
+            enc::encode_bits_section(uint32_t(bit_count), {}, s.payload);
+            sections.push_back(std::move(s));
+        }
+        const std::pair<const char*, const std::vector<std::string>*> tables[] = {
+            { "PARS", &t.params }, { "GATE", &t.gates },
+        };
+        for (const auto& tab : tables) {
+            if (tab.second->empty()) continue;
+            enc::Section s;
+            s.id = enc::section_id(tab.first);
+            enc::push_str(s.payload, tab.first);
+            enc::push_uleb128(s.payload, tab.second->size());
+            for (const auto& e : *tab.second) enc::push_bytes(s.payload, e.data(), e.size());
+            sections.push_back(std::move(s));
+        }
+        sections.push_back(std::move(inst));
+        out = enc::assemble_qbin(sections);
+
+        st.strings_out = have_strs ? t.strs.size() : 0;
+        st.params_out = t.params.size();
+        st.gates_out = t.gates.size();
+        if (stats) *stats = std::move(st);
+        return true;
+    }
+
+} // namespace qbin_linker
@@ -0,0 +1,125 @@
+// main.cpp - qbin-link: concatenate QBIN programs without decompiling them
+
+#include "qbin_linker/linker.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+static void print_usage(const char* argv0) {
+    std::cerr
+        << "Usage:\n"
+        << "  " << argv0 << " -o <output.qbin> <in.qbin> [[--qubit-offset N] [--bit-offset N] <in.qbin>]...\n"
+        << "         [--no-dedup] [--verbose]\n"
+        << "\n"
+        << "Appends the instruction streams of the inputs in order and merges their\n"
+        << "STRS/PARS/GATE tables. Inputs that need no renumbering are copied verbatim.\n"
+        << "\n"
+        << "Options:\n"
+        << "  --qubit-offset N  shift the qubit operands of the next input by N\n"
+        << "  --bit-offset N    shift the classical bit indices (MEASURE, IF_*) of the\n"
+        << "                    next input by N\n"
+        << "  --no-dedup        keep equal PARS/GATE entries of different inputs apart\n"
+        << "  --verbose         report merged table sizes, copied/rewritten inputs and\n"
+        << "                    dropped sections\n";
+}
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool parse_u32(const char* s, uint32_t& v) {
+    char* end = nullptr;
+    const unsigned long long x = std::strtoull(s, &end, 10);
+    if (!end || *end != '\0' || end == s || x > 0xFFFFFFFFull) return false;
+    v = uint32_t(x);
+    return true;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { print_usage(argv[0]); return 1; }
+
+    std::string out_path;
+    qbin_linker::LinkOptions opts;
+    bool verbose = false;
+    std::vector<std::string> paths;
+    std::vector<qbin_linker::LinkInput> inputs;
+    qbin_linker::LinkInput next;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-o" && i + 1 < argc) out_path = argv[++i];
+        else if ((a == "--qubit-offset" || a == "--bit-offset") && i + 1 < argc) {
+            uint32_t v = 0;
+            if (!parse_u32(argv[++i], v)) {
+                std::cerr << "Invalid value for " << a << ": " << argv[i] << "\n";
+                return 1;
+            }
+            (a == "--qubit-offset" ? next.qubit_offset : next.bit_offset) = v;
+        }
+        else if (a == "--no-dedup") opts.dedup = false;
+        else if (a == "--verbose" || a == "-v") verbose = true;
+        else if (!a.empty() && a[0] == '-') {
+            std::cerr << "Unknown option: " << a << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+        else {
+            paths.push_back(a);
+            inputs.push_back(next);
+            next = qbin_linker::LinkInput{};
+        }
+    }
+    if (out_path.empty() || inputs.empty()) { print_usage(argv[0]); return 1; }
+
+    std::vector<std::vector<uint8_t>> bufs(paths.size());
+    for (size_t k = 0; k < paths.size(); ++k) {
+        if (!read_file(paths[k], bufs[k])) {
+            std::cerr << "Failed to read: " << paths[k] << "\n";
+            return 1;
+        }
+        inputs[k].data = bufs[k].data();
+        inputs[k].size = bufs[k].size();
+    }
+
+    const auto t0 = std::chrono::steady_clock::now();
+    std::vector<uint8_t> blob;
+    std::string err;
+    qbin_linker::LinkStats stats;
+    if (!qbin_linker::link_qbin(inputs, opts, blob, err, &stats)) {
+        std::cerr << "Link error: " << err << "\n";
+        return 1;
+    }
+    const auto t1 = std::chrono::steady_clock::now();
+
+    std::ofstream ofs(out_path, std::ios::binary);
+    if (!ofs) {
+        std::cerr << "Error: cannot open output file: " << out_path << "\n";
+        return 1;
+    }
+    ofs.write(reinterpret_cast<const char*>(blob.data()), static_cast<std::streamsize>(blob.size()));
+    if (!ofs) {
+        std::cerr << "Error: failed to write output file.\n";
+        return 1;
+    }
+
+    if (verbose) {
+        std::fprintf(stderr, "Linked %zu inputs (%zu copied, %zu rewritten): %llu instructions in %.0f us\n",
+            stats.inputs, stats.inputs_copied, stats.inputs_rewritten,
+            static_cast<unsigned long long>(stats.instrs),
+            std::chrono::duration<double, std::micro>(t1 - t0).count());
+        std::fprintf(stderr, "STRS %zu -> %zu, PARS %zu -> %zu, GATE %zu -> %zu\n",
+            stats.strings_in, stats.strings_out, stats.params_in, stats.params_out,
+            stats.gates_in, stats.gates_out);
+        for (const auto& d : stats.dropped) std::cerr << "Dropped " << d << "\n";
+        std::cerr << "Wrote " << blob.size() << " bytes to " << out_path << "\n";
+    }
+    return 0;
+}
@@ -0,0 +1,58 @@
+#ifndef QBIN_RUNNER_EXECUTOR_HPP
+#define QBIN_RUNNER_EXECUTOR_HPP
+
+#include "qbin_decompiler/reader.hpp"
+#include "qbin_runner/statevector.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <map>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Executes a decoded INST stream on a state vector and samples shots.
+//
+// CALLG is inlined first. If every MEASURE comes after the last gate and
+// there are no RESET or IF guards, the circuit is simulated once and all
+// shots are drawn from the final distribution; otherwise each shot runs the
+// whole program (measurements collapse the state, IF_EQ/IF_NEQ test the
+// classical bits written so far).
+
+namespace qbin_runner {
+
+    struct RunOptions {
+        uint64_t shots = 1024;
+        uint64_t seed = 1;
+        bool simd = true;           // false forces the scalar kernels
+        unsigned num_qubits = 0;    // 0 = highest qubit operand + 1
+    };
+
+    struct RunResult {
+        unsigned num_qubits = 0;
+        unsigned num_bits = 0;
+        static constexpr unsigned kMaxBits = 1u << 16;  // larger bit spaces are rejected
+        bool sampled_once = false;      // single simulation + sampling
+        uint64_t gates_applied = 0;     // over all shots
+        double gate_seconds = 0.0;      // time spent in gate kernels
+        // Classical register c[num_bits-1] ... c[0] -> occurrences; num_bits
+        // is the BITS count if the file declares one (unmeasured bits read 0)
+        std::map<std::string, uint64_t> counts;
+        // On failure: INST index of the offending instruction (the CALLG for
+        // gate bodies), or kNoInstr if the error is not tied to one. Look it
+        // up in DEBG (SectionReader::debug) for a source position.
+        static constexpr size_t kNoInstr = ~size_t(0);
+        size_t failed_instr = kNoInstr;
+    };
+
+    bool run_program(const qbin_decompiler::DecodedProgram& prog, const RunOptions& opts,
+        RunResult& out, std::string& err);
+
+    // Applies one gate instruction. Returns false (with err) for opcodes that
+    // are not unitary gates or cannot be simulated. U/CU read absent angles
+    // as 0.
+    bool apply_gate(StateVector& sv, const qbin_decompiler::DecodedInstr& di, std::string& err);
+
+} // namespace qbin_runner
+
+#endif // QBIN_RUNNER_EXECUTOR_HPP
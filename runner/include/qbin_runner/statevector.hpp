@@ -0,0 +1,85 @@
+#ifndef QBIN_RUNNER_STATEVECTOR_HPP
+#define QBIN_RUNNER_STATEVECTOR_HPP
+
+#include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Dense state vector of 2^n complex<double> amplitudes with in-place gate
+// kernels. Amplitude index bit k is qubit k (little-endian, as OpenQASM).
+// Kernels use AVX2/FMA when compiled in and supported by the CPU, otherwise
+// portable scalar loops; both are parallelized with OpenMP when enabled.
+
+namespace qbin_runner {
+
+    using amp_t = std::complex<double>;
+
+    // Row-major 2x2 unitary.
+    struct Mat2 {
+        amp_t m00, m01, m10, m11;
+    };
+
+    // Row-major 4x4 unitary on (q0, q1); basis index = (bit q1 << 1) | bit q0.
+    struct Mat4 {
+        amp_t m[4][4];
+    };
+
+    // True if AVX2 kernels are compiled in and the CPU supports AVX2 + FMA.
+    bool have_avx2();
+
+    class StateVector {
+    public:
+        // Largest register accepted by init() (16 GiB of amplitudes).
+        static constexpr unsigned kMaxQubits = 30;
+
+        // Allocates 2^num_qubits amplitudes in |0...0>.
+        bool init(unsigned num_qubits, std::string& err);
+        void reset_zero();
+
+        unsigned num_qubits() const { return n_; }
+        size_t size() const { return amps_.size(); }
+        const amp_t* data() const { return amps_.data(); }
+        amp_t* data() { return amps_.data(); }
+
+        // Off forces the scalar kernels (for comparison and testing).
+        void set_simd(bool on) { simd_ = on && have_avx2(); }
+        bool simd() const { return simd_; }
+
+        void apply_1q(unsigned t, const Mat2& m);
+        // m applied to `t` where qubit `c` is 1.
+        void apply_c1q(unsigned c, unsigned t, const Mat2& m);
+        void apply_2q(unsigned q0, unsigned q1, const Mat4& m);
+
+        // Probability of reading 1 on qubit q.
+        double prob_one(unsigned q) const;
+        // Projects qubit q onto `bit` (probability p of that outcome) and renormalizes.
+        void collapse(unsigned q, int bit, double p);
+
+    private:
+        unsigned n_ = 0;
+        std::vector<amp_t> amps_;
+        bool simd_ = have_avx2();
+    };
+
+    namespace detail {
+        // AVX2 kernels (kernels_avx2.cpp), only called when have_avx2().
+        void apply_1q_avx2(amp_t* a, size_t n, unsigned t, const Mat2& m);
+        void apply_c1q_avx2(amp_t* a, size_t n, unsigned c, unsigned t, const Mat2& m);
+        void apply_2q_avx2(amp_t* a, size_t n, unsigned q0, unsigned q1, const Mat4& m);
+
+        // Index of the k-th amplitude with bit `pos` clear.
+        inline size_t insert_zero(size_t k, unsigned pos) {
+            const size_t low = (size_t(1) << pos) - 1;
+            return ((k & ~low) << 1) | (k & low);
+        }
+
+        // Minimum loop length worth an OpenMP team.
+        constexpr size_t kParallelThreshold = size_t(1) << 14;
+    } // namespace detail
+
+} // namespace qbin_runner
+
+#endif // QBIN_RUNNER_STATEVECTOR_HPP
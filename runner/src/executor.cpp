@@ -0,0 +1,309 @@
+#include "qbin_runner/executor.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <complex>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+namespace qbin_runner {
+
+    using qbin_decompiler::DecodedInstr;
+
+    static const double kPi = 3.14159265358979323846;
+    static const double kInvSqrt2 = 0.70710678118654752440;
+    static const amp_t kI(0.0, 1.0);
+
+    static inline bool is_nop(uint8_t op) {
+        return op == 0x32 /*BARRIER*/ || op == 0x38 /*DELAY*/ || op == 0x39 /*FRAME*/;
+    }
+
+    // Uniform double in [0, 1) from the top 53 bits; identical on every
+    // standard library, unlike std::uniform_real_distribution.
+    static inline double uniform01(std::mt19937_64& rng) {
+        return double(rng() >> 11) * (1.0 / 9007199254740992.0);
+    }
+
+    static inline Mat2 diag(amp_t d0, amp_t d1) { return { d0, 0.0, 0.0, d1 }; }
+    static inline Mat2 rx(double th) {
+        const double c = std::cos(th / 2), s = std::sin(th / 2);
+        return { c, -kI * s, -kI * s, c };
+    }
+    static inline Mat2 ry(double th) {
+        const double c = std::cos(th / 2), s = std::sin(th / 2);
+        return { c, -s, s, c };
+    }
+    static inline Mat2 rz(double th) {
+        return diag(std::polar(1.0, -th / 2), std::polar(1.0, th / 2));
+    }
+
+    // U(theta, phi, lambda) = Rz(phi) Ry(theta) Rz(lambda) up to global phase,
+    // with the phase of OpenQASM's U (also the target part of CU).
+    static inline Mat2 u3(double th, double phi, double lam) {
+        const double c = std::cos(th / 2), s = std::sin(th / 2);
+        return { c, -std::polar(s, lam), std::polar(s, phi), std::polar(c, phi + lam) };
+    }
+
+    // Single-qubit matrix of opcodes 0x01..0x0E (also the target part of
+    // controlled gates).
+    static bool mat2_for(uint8_t op, double th, Mat2& m) {
+        switch (op) {
+        case 0x01: m = { 0.0, 1.0, 1.0, 0.0 }; return true;                     // X
+        case 0x02: m = { 0.0, -kI, kI, 0.0 }; return true;                      // Y
+        case 0x03: m = diag(1.0, -1.0); return true;                            // Z
+        case 0x04: m = { kInvSqrt2, kInvSqrt2, kInvSqrt2, -kInvSqrt2 }; return true; // H
+        case 0x05: m = diag(1.0, kI); return true;                              // S
+        case 0x06: m = diag(1.0, -kI); return true;                             // SDG
+        case 0x07: m = diag(1.0, std::polar(1.0, kPi / 4)); return true;       // T
+        case 0x08: m = diag(1.0, std::polar(1.0, -kPi / 4)); return true;      // TDG
+        case 0x09: m = { amp_t(0.5, 0.5), amp_t(0.5, -0.5), amp_t(0.5, -0.5), amp_t(0.5, 0.5) }; return true; // SX
+        case 0x0A: m = { amp_t(0.5, -0.5), amp_t(0.5, 0.5), amp_t(0.5, 0.5), amp_t(0.5, -0.5) }; return true; // SXDG
+        case 0x0B: m = rx(th); return true;
+        case 0x0C: m = ry(th); return true;
+        case 0x0D: m = rz(th); return true;
+        case 0x0E: m = diag(1.0, std::polar(1.0, th)); return true;             // PHASE
+        default: return false;
+        }
+    }
+
+    static Mat4 mat4_zero() {
+        Mat4 m;
+        for (auto& row : m.m)
+            for (auto& v : row) v = 0.0;
+        return m;
+    }
+
+    static inline bool qubit_ok(const StateVector& sv, int q) {
+        return q >= 0 && unsigned(q) < sv.num_qubits();
+    }
+
+    bool apply_gate(StateVector& sv, const DecodedInstr& di, std::string& err) {
+        const double th = di.has_angle0 ? double(di.angle0) : 0.0;
+        const uint8_t op = di.opcode;
+        Mat2 m;
+        if (op >= 0x01 && op <= 0x0E) {
+            if (!qubit_ok(sv, di.a)) { err = "Qubit operand out of range"; return false; }
+            mat2_for(op, th, m);
+            sv.apply_1q(unsigned(di.a), m);
+            return true;
+        }
+        const double phi = di.has_angle1 ? double(di.angle1) : 0.0;
+        const double lam = di.has_angle2 ? double(di.angle2) : 0.0;
+        if (op == 0x0F) {
+            if (!qubit_ok(sv, di.a)) { err = "Qubit operand out of range"; return false; }
+            sv.apply_1q(unsigned(di.a), u3(th, phi, lam));
+            return true;
+        }
+        if (!qubit_ok(sv, di.a) || !qubit_ok(sv, di.b) || di.a == di.b) {
+            err = "Invalid two-qubit operands";
+            return false;
+        }
+        const unsigned a = unsigned(di.a), b = unsigned(di.b);
+        switch (op) {
+        case 0x10: mat2_for(0x01, 0.0, m); sv.apply_c1q(a, b, m); return true;   // CX
+        case 0x11: mat2_for(0x03, 0.0, m); sv.apply_c1q(a, b, m); return true;   // CZ
+        case 0x14: mat2_for(0x09, 0.0, m); sv.apply_c1q(a, b, m); return true;   // CSX
+        case 0x15: sv.apply_c1q(a, b, rx(th)); return true;
+        case 0x16: sv.apply_c1q(a, b, ry(th)); return true;
+        case 0x17: sv.apply_c1q(a, b, rz(th)); return true;
+        case 0x18: sv.apply_c1q(a, b, u3(th, phi, lam)); return true;
+        default: break;
+        }
+
+        // Two-qubit matrices on (q0 = a, q1 = b)
+        Mat4 u = mat4_zero();
+        const double c = std::cos(th / 2), s = std::sin(th / 2);
+        switch (op) {
+        case 0x12: { // ECR = (IX - XY) / sqrt(2)
+            const double r = kInvSqrt2;
+            u.m[0][1] = r;        u.m[0][3] = kI * r;
+            u.m[1][0] = r;        u.m[1][2] = -kI * r;
+            u.m[2][1] = kI * r;   u.m[2][3] = r;
+            u.m[3][0] = -kI * r;  u.m[3][2] = r;
+            break;
+        }
+        case 0x13: // SWAP
+            u.m[0][0] = 1.0; u.m[1][2] = 1.0; u.m[2][1] = 1.0; u.m[3][3] = 1.0;
+            break;
+        case 0x20: // RXX = exp(-i th/2 XX)
+            for (int i = 0; i < 4; ++i) { u.m[i][i] = c; u.m[i][3 - i] = -kI * s; }
+            break;
+        case 0x21: // RYY = exp(-i th/2 YY)
+            for (int i = 0; i < 4; ++i) u.m[i][i] = c;
+            u.m[0][3] = kI * s;  u.m[3][0] = kI * s;
+            u.m[1][2] = -kI * s; u.m[2][1] = -kI * s;
+            break;
+        case 0x22: // RZZ = exp(-i th/2 ZZ)
+            u.m[0][0] = u.m[3][3] = std::polar(1.0, -th / 2);
+            u.m[1][1] = u.m[2][2] = std::polar(1.0, th / 2);
+            break;
+        default:
+            err = "Opcode 0x" + std::to_string(int(op)) + " is not a simulatable gate";
+            return false;
+        }
+        sv.apply_2q(a, b, u);
+        return true;
+    }
+
+    // End of the IF body starting after `i` (index of the matching ENDIF).
+    static size_t matching_endif(const std::vector<DecodedInstr>& v, size_t i) {
+        int depth = 0;
+        for (size_t j = i + 1; j < v.size(); ++j) {
+            if (v[j].opcode == 0x81 || v[j].opcode == 0x82) ++depth;
+            else if (v[j].opcode == 0x8F) {
+                if (depth == 0) return j;
+                --depth;
+            }
+        }
+        return v.size();
+    }
+
+    // MEASURE / IF_EQ / IF_NEQ with a classical bit index in aux
+    static inline bool uses_bit(const DecodedInstr& di) {
+        return di.has_aux && (di.opcode == 0x30 || di.opcode == 0x81 || di.opcode == 0x82);
+    }
+
+    static std::string bits_key(const std::vector<uint8_t>& bits) {
+        std::string s(bits.size(), '0');
+        for (size_t i = 0; i < bits.size(); ++i) s[bits.size() - 1 - i] = bits[i] ? '1' : '0';
+        return s;
+    }
+
+    bool run_program(const qbin_decompiler::DecodedProgram& prog, const RunOptions& opts,
+        RunResult& out, std::string& err) {
+        std::vector<DecodedInstr> instrs;
+        std::vector<uint32_t> origin;   // INST index per inlined instruction
+        if (!prog.gates.empty()) {
+            if (!qbin_decompiler::inline_gate_calls(prog.instrs, prog.gates, instrs, err, &origin)) return false;
+        }
+        else {
+            instrs = prog.instrs;
+        }
+        auto fail_at = [&](size_t i) {
+            out.failed_instr = origin.empty() ? i : origin[i];
+            return false;
+            };
+
+        // Register sizes
+        int max_q = -1;
+        uint64_t bit_space = 0;
+        bool has_guard = false;
+        for (const auto& di : instrs) {
+            max_q = std::max({ max_q, di.a, di.b, di.c });
+            if (uses_bit(di)) bit_space = std::max(bit_space, uint64_t(di.aux) + 1);
+            if (di.opcode == 0x81 || di.opcode == 0x82 || di.opcode == 0x31) has_guard = true;
+        }
+        out = RunResult{};
+        if (prog.bits.present) bit_space = prog.bits.count;
+        if (bit_space > RunResult::kMaxBits) {
+            err = "Program uses " + std::to_string(bit_space) + " classical bits (max " +
+                std::to_string(RunResult::kMaxBits) + ")";
+            return false;
+        }
+        out.num_qubits = opts.num_qubits ? opts.num_qubits : unsigned(max_q + 1);
+        out.num_bits = unsigned(bit_space);
+        if (max_q >= int(out.num_qubits)) {
+            err = "Program uses qubit " + std::to_string(max_q) + " but only " +
+                std::to_string(out.num_qubits) + " were requested";
+            return false;
+        }
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            if (uses_bit(instrs[i]) && instrs[i].aux >= out.num_bits) {
+                err = "Bit " + std::to_string(instrs[i].aux) + " out of range (" +
+                    std::to_string(out.num_bits) + " bits)";
+                return fail_at(i);
+            }
+        }
+
+        StateVector sv;
+        if (!sv.init(out.num_qubits, err)) return false;
+        sv.set_simd(opts.simd);
+
+        // Terminal measurements only: everything from the first MEASURE on is
+        // MEASURE or a no-op.
+        size_t first_meas = instrs.size();
+        for (size_t i = 0; i < instrs.size(); ++i) {
+            if (instrs[i].opcode == 0x30) { first_meas = i; break; }
+        }
+        bool terminal = !has_guard;
+        for (size_t i = first_meas; terminal && i < instrs.size(); ++i) {
+            terminal = instrs[i].opcode == 0x30 || is_nop(instrs[i].opcode);
+        }
+
+        std::mt19937_64 rng(opts.seed);
+        std::vector<uint8_t> bits(out.num_bits, 0);
+        using clock = std::chrono::steady_clock;
+
+        if (terminal) {
+            out.sampled_once = true;
+            const auto t0 = clock::now();
+            for (size_t i = 0; i < first_meas; ++i) {
+                if (is_nop(instrs[i].opcode)) continue;
+                if (!apply_gate(sv, instrs[i], err)) return fail_at(i);
+                ++out.gates_applied;
+            }
+            out.gate_seconds = std::chrono::duration<double>(clock::now() - t0).count();
+            for (size_t i = first_meas; i < instrs.size(); ++i) {
+                if (instrs[i].opcode == 0x30 && !qubit_ok(sv, instrs[i].a)) { err = "Qubit operand out of range"; return fail_at(i); }
+            }
+
+            // Sorted uniforms, then one sweep over the cumulative distribution
+            std::vector<double> u(opts.shots);
+            for (auto& x : u) x = uniform01(rng);
+            std::sort(u.begin(), u.end());
+            const amp_t* a = sv.data();
+            double cum = 0.0;
+            size_t idx = 0;
+            for (double x : u) {
+                while (idx + 1 < sv.size() && cum + std::norm(a[idx]) <= x) cum += std::norm(a[idx++]);
+                std::fill(bits.begin(), bits.end(), 0);
+                for (size_t i = first_meas; i < instrs.size(); ++i) {
+                    const auto& di = instrs[i];
+                    if (di.opcode == 0x30 && di.has_aux) bits[di.aux] = uint8_t((idx >> di.a) & 1u);
+                }
+                ++out.counts[bits_key(bits)];
+            }
+            return true;
+        }
+
+        for (uint64_t shot = 0; shot < opts.shots; ++shot) {
+            sv.reset_zero();
+            std::fill(bits.begin(), bits.end(), 0);
+            for (size_t i = 0; i < instrs.size(); ++i) {
+                const auto& di = instrs[i];
+                const uint8_t op = di.opcode;
+                if (is_nop(op) || op == 0x8F) continue;
+                if (op == 0x81 || op == 0x82) {
+                    const uint8_t want = di.has_imm8 ? di.imm8 : 0;
+                    const uint8_t have = di.has_aux ? bits[di.aux] : 0;
+                    if ((have == want) != (op == 0x81)) i = matching_endif(instrs, i);
+                    continue;
+                }
+                if (op == 0x30 || op == 0x31) {
+                    if (!qubit_ok(sv, di.a)) { err = "Qubit operand out of range"; return fail_at(i); }
+                    const unsigned q = unsigned(di.a);
+                    const double p1 = sv.prob_one(q);
+                    const int outcome = uniform01(rng) < p1 ? 1 : 0;
+                    sv.collapse(q, outcome, outcome ? p1 : 1.0 - p1);
+                    if (op == 0x30 && di.has_aux) bits[di.aux] = uint8_t(outcome);
+                    if (op == 0x31 && outcome) {
+                        Mat2 x;
+                        mat2_for(0x01, 0.0, x);
+                        sv.apply_1q(q, x);
+                    }
+                    continue;
+                }
+                const auto t0 = clock::now();
+                if (!apply_gate(sv, di, err)) return fail_at(i);
+                out.gate_seconds += std::chrono::duration<double>(clock::now() - t0).count();
+                ++out.gates_applied;
+            }
+            ++out.counts[bits_key(bits)];
+        }
+        return true;
+    }
+
+} // namespace qbin_runner
@@ -0,0 +1,155 @@
+// kernels_avx2.cpp - AVX2/FMA gate kernels. Built with -mavx2 -mfma and only
+// entered after have_avx2() checked the CPU.
+//
+// One __m256d holds two complex<double> amplitudes [re0, im0, re1, im1].
+// Complex products use the movedup/permute + fmaddsub pattern:
+//   x * y = fmaddsub(x, re(y), swap(x) * im(y))
+
+#include "qbin_runner/statevector.hpp"
+
+#include <immintrin.h>
+
+#include <algorithm>
+#include <cstddef>
+
+#if defined(QBIN_RUNNER_OPENMP)
+#define QBIN_OMP_FOR _Pragma("omp parallel for schedule(static) if(parallel)")
+#else
+#define QBIN_OMP_FOR
+#endif
+
+namespace qbin_runner {
+    namespace detail {
+
+        namespace {
+
+            // Broadcast complex scalar as (re, re, re, re) and (im, im, im, im).
+            struct CBcast {
+                __m256d re, im;
+            };
+            inline CBcast bcast(const amp_t& z) {
+                return { _mm256_set1_pd(z.real()), _mm256_set1_pd(z.imag()) };
+            }
+            // Two different complex scalars, one per 128-bit lane.
+            inline CBcast bcast2(const amp_t& lo, const amp_t& hi) {
+                return { _mm256_setr_pd(lo.real(), lo.real(), hi.real(), hi.real()),
+                         _mm256_setr_pd(lo.imag(), lo.imag(), hi.imag(), hi.imag()) };
+            }
+
+            inline __m256d cmul(__m256d x, const CBcast& y) {
+                const __m256d xs = _mm256_permute_pd(x, 0x5);   // [im0, re0, im1, re1]
+                return _mm256_fmaddsub_pd(x, y.re, _mm256_mul_pd(xs, y.im));
+            }
+            // x * y + acc
+            inline __m256d cmadd(__m256d x, const CBcast& y, __m256d acc) {
+                return _mm256_add_pd(acc, cmul(x, y));
+            }
+
+            inline __m256d load2(const amp_t* p) { return _mm256_loadu_pd(reinterpret_cast<const double*>(p)); }
+            inline void store2(amp_t* p, __m256d v) { _mm256_storeu_pd(reinterpret_cast<double*>(p), v); }
+
+            // Pair (a[i], a[i+1]) as the two amplitudes of one target-qubit-0 pair.
+            inline void pair_t0(amp_t* p, const CBcast& col0, const CBcast& col1) {
+                const __m256d v = load2(p);
+                const __m256d a0 = _mm256_permute2f128_pd(v, v, 0x00);  // [a0, a0]
+                const __m256d a1 = _mm256_permute2f128_pd(v, v, 0x11);  // [a1, a1]
+                store2(p, cmadd(a1, col1, cmul(a0, col0)));
+            }
+
+        } // namespace
+
+        void apply_1q_avx2(amp_t* a, size_t n, unsigned t, const Mat2& m) {
+            const size_t half = n >> 1;
+            const bool parallel = half >= kParallelThreshold;
+            (void)parallel;
+            if (t == 0) {
+                // Both amplitudes of a pair share one register
+                const CBcast col0 = bcast2(m.m00, m.m10), col1 = bcast2(m.m01, m.m11);
+                QBIN_OMP_FOR
+                for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(half); ++k) pair_t0(a + 2 * k, col0, col1);
+                return;
+            }
+            const size_t bit = size_t(1) << t;
+            const CBcast m00 = bcast(m.m00), m01 = bcast(m.m01), m10 = bcast(m.m10), m11 = bcast(m.m11);
+            // k even: pairs k and k+1 start at consecutive indices
+            QBIN_OMP_FOR
+            for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(half); k += 2) {
+                const size_t i0 = insert_zero(size_t(k), t), i1 = i0 | bit;
+                const __m256d v0 = load2(a + i0), v1 = load2(a + i1);
+                store2(a + i0, cmadd(v1, m01, cmul(v0, m00)));
+                store2(a + i1, cmadd(v1, m11, cmul(v0, m10)));
+            }
+        }
+
+        void apply_c1q_avx2(amp_t* a, size_t n, unsigned c, unsigned t, const Mat2& m) {
+            const size_t quarter = n >> 2;
+            const unsigned lo = std::min(c, t), hi = std::max(c, t);
+            const size_t cbit = size_t(1) << c, tbit = size_t(1) << t;
+            const bool parallel = quarter >= kParallelThreshold;
+            (void)parallel;
+            if (t == 0) {
+                const CBcast col0 = bcast2(m.m00, m.m10), col1 = bcast2(m.m01, m.m11);
+                QBIN_OMP_FOR
+                for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(quarter); ++k)
+                    pair_t0(a + (insert_zero(insert_zero(size_t(k), lo), hi) | cbit), col0, col1);
+                return;
+            }
+            if (c == 0) {
+                // Controlled amplitudes are every other index: no contiguous pairs
+                QBIN_OMP_FOR
+                for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(quarter); ++k) {
+                    const size_t i0 = insert_zero(insert_zero(size_t(k), lo), hi) | cbit, i1 = i0 | tbit;
+                    const amp_t a0 = a[i0], a1 = a[i1];
+                    a[i0] = m.m00 * a0 + m.m01 * a1;
+                    a[i1] = m.m10 * a0 + m.m11 * a1;
+                }
+                return;
+            }
+            const CBcast m00 = bcast(m.m00), m01 = bcast(m.m01), m10 = bcast(m.m10), m11 = bcast(m.m11);
+            QBIN_OMP_FOR
+            for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(quarter); k += 2) {
+                const size_t i0 = insert_zero(insert_zero(size_t(k), lo), hi) | cbit, i1 = i0 | tbit;
+                const __m256d v0 = load2(a + i0), v1 = load2(a + i1);
+                store2(a + i0, cmadd(v1, m01, cmul(v0, m00)));
+                store2(a + i1, cmadd(v1, m11, cmul(v0, m10)));
+            }
+        }
+
+        void apply_2q_avx2(amp_t* a, size_t n, unsigned q0, unsigned q1, const Mat4& m) {
+            const size_t quarter = n >> 2;
+            const unsigned lo = std::min(q0, q1), hi = std::max(q0, q1);
+            const size_t b0 = size_t(1) << q0, b1 = size_t(1) << q1;
+            const bool parallel = quarter >= kParallelThreshold;
+            (void)parallel;
+            if (lo == 0) {
+                // Scalar: the four amplitudes of a group are never pairwise contiguous
+                QBIN_OMP_FOR
+                for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(quarter); ++k) {
+                    const size_t base = insert_zero(insert_zero(size_t(k), lo), hi);
+                    const size_t idx[4] = { base, base | b0, base | b1, base | b0 | b1 };
+                    const amp_t in[4] = { a[idx[0]], a[idx[1]], a[idx[2]], a[idx[3]] };
+                    for (int r = 0; r < 4; ++r)
+                        a[idx[r]] = m.m[r][0] * in[0] + m.m[r][1] * in[1] + m.m[r][2] * in[2] + m.m[r][3] * in[3];
+                }
+                return;
+            }
+            CBcast mb[4][4];
+            for (int r = 0; r < 4; ++r)
+                for (int col = 0; col < 4; ++col) mb[r][col] = bcast(m.m[r][col]);
+            QBIN_OMP_FOR
+            for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(quarter); k += 2) {
+                const size_t base = insert_zero(insert_zero(size_t(k), lo), hi);
+                const size_t idx[4] = { base, base | b0, base | b1, base | b0 | b1 };
+                const __m256d in[4] = { load2(a + idx[0]), load2(a + idx[1]), load2(a + idx[2]), load2(a + idx[3]) };
+                for (int r = 0; r < 4; ++r) {
+                    __m256d acc = cmul(in[0], mb[r][0]);
+                    acc = cmadd(in[1], mb[r][1], acc);
+                    acc = cmadd(in[2], mb[r][2], acc);
+                    acc = cmadd(in[3], mb[r][3], acc);
+                    store2(a + idx[r], acc);
+                }
+            }
+        }
+
+    } // namespace detail
+} // namespace qbin_runner
@@ -0,0 +1,142 @@
+// main.cpp - qbin-run: simulate a QBIN program and print measurement counts
+
+#include "qbin_decompiler/section_reader.hpp"
+#include "qbin_runner/executor.hpp"
+#include "qbin_runner/statevector.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <string>
+#include <vector>
+
+#if defined(QBIN_RUNNER_OPENMP)
+#include <omp.h>
+#endif
+
+static void print_usage(const char* argv0) {
+    std::cerr
+        << "Usage:\n"
+        << "  " << argv0 << " <input.qbin> [--shots N] [--seed S] [--qubits N] [--threads N]\n"
+        << "         [--scalar] [--verbose]\n"
+        << "\n"
+        << "Simulates the program on a state vector and prints one line per observed\n"
+        << "classical register value (c[n-1]..c[0]) with its count, sorted by value.\n"
+        << "\n"
+        << "Options:\n"
+        << "  --shots N    number of shots (default 1024)\n"
+        << "  --seed S     RNG seed; equal seeds give equal counts (default 1)\n"
+        << "  --qubits N   register size (default: highest qubit operand + 1)\n"
+        << "  --threads N  OpenMP threads for the gate kernels (default: runtime)\n"
+        << "  --scalar     use the scalar kernels even if AVX2 is available\n"
+        << "  --verbose    report kernels, simulation mode and gate throughput\n";
+}
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool parse_u64(const char* s, uint64_t& v) {
+    char* end = nullptr;
+    v = std::strtoull(s, &end, 10);
+    return end && *end == '\0' && end != s;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { print_usage(argv[0]); return 1; }
+
+    std::string in_path;
+    qbin_runner::RunOptions opts;
+    bool verbose = false;
+    uint64_t threads = 0;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        uint64_t v = 0;
+        if ((a == "--shots" || a == "--seed" || a == "--qubits" || a == "--threads") && i + 1 < argc) {
+            if (!parse_u64(argv[++i], v)) {
+                std::cerr << "Invalid value for " << a << ": " << argv[i] << "\n";
+                return 1;
+            }
+            if (a == "--shots") opts.shots = v;
+            else if (a == "--seed") opts.seed = v;
+            else if (a == "--qubits") opts.num_qubits = unsigned(v);
+            else threads = v;
+        }
+        else if (a == "--scalar") opts.simd = false;
+        else if (a == "--verbose" || a == "-v") verbose = true;
+        else if (!a.empty() && a[0] == '-') {
+            std::cerr << "Unknown option: " << a << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+        else if (in_path.empty()) in_path = a;
+        else {
+            std::cerr << "Unexpected argument: " << a << "\n";
+            print_usage(argv[0]);
+            return 1;
+        }
+    }
+    if (in_path.empty()) { print_usage(argv[0]); return 1; }
+
+#if defined(QBIN_RUNNER_OPENMP)
+    if (threads) omp_set_num_threads(int(threads));
+#else
+    if (threads > 1 && verbose) std::cerr << "Note: built without OpenMP, --threads ignored\n";
+#endif
+
+    std::vector<uint8_t> buf;
+    if (!read_file(in_path, buf)) {
+        std::cerr << "Failed to read: " << in_path << "\n";
+        return 1;
+    }
+
+    std::string err;
+    qbin_decompiler::SectionReader sections;
+    qbin_decompiler::DecodedProgram prog;
+    if (!sections.open(buf.data(), buf.size(), err) || !sections.release_program(prog, err)) {
+        std::cerr << "Decode error: " << err << "\n";
+        return 1;
+    }
+
+    qbin_runner::RunResult res;
+    if (!qbin_runner::run_program(prog, opts, res, err)) {
+        std::cerr << "Run error: " << err;
+        // DEBG is only decoded here, on the error path
+        if (res.failed_instr != qbin_runner::RunResult::kNoInstr) {
+            std::cerr << " (instruction " << res.failed_instr;
+            const qbin_decompiler::DecodedDebug* dbg = nullptr;
+            qbin_decompiler::SourceLoc loc;
+            std::string derr;
+            if (sections.debug(dbg, derr) && dbg && dbg->locate(res.failed_instr, loc)) {
+                std::cerr << ", line " << loc.line << ":" << loc.column;
+            }
+            std::cerr << ")";
+        }
+        std::cerr << "\n";
+        return 1;
+    }
+
+    for (const auto& kv : res.counts) {
+        std::printf("%s %llu\n", kv.first.empty() ? "-" : kv.first.c_str(), static_cast<unsigned long long>(kv.second));
+    }
+
+    if (verbose) {
+        const bool simd = opts.simd && qbin_runner::have_avx2();
+        std::fprintf(stderr, "qubits %u, bits %u, shots %llu, seed %llu, kernels %s, %s\n",
+            res.num_qubits, res.num_bits,
+            static_cast<unsigned long long>(opts.shots), static_cast<unsigned long long>(opts.seed),
+            simd ? "avx2" : "scalar",
+            res.sampled_once ? "simulated once, sampled" : "simulated per shot");
+        if (res.gates_applied) {
+            std::fprintf(stderr, "%llu gates in %.3f ms (%.1f ns/gate/amplitude-pair)\n",
+                static_cast<unsigned long long>(res.gates_applied), res.gate_seconds * 1e3,
+                res.gate_seconds * 1e9 / (double(res.gates_applied) * double(size_t(1) << res.num_qubits) / 2));
+        }
+    }
+    return 0;
+}
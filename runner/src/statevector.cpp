@@ -0,0 +1,147 @@
+#include "qbin_runner/statevector.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <complex>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <utility>
+
+#if defined(QBIN_RUNNER_OPENMP)
+#define QBIN_OMP_FOR _Pragma("omp parallel for schedule(static) if(parallel)")
+#define QBIN_OMP_FOR_SUM _Pragma("omp parallel for schedule(static) reduction(+:sum) if(parallel)")
+#else
+#define QBIN_OMP_FOR
+#define QBIN_OMP_FOR_SUM
+#endif
+
+namespace qbin_runner {
+
+    using detail::insert_zero;
+    using detail::kParallelThreshold;
+
+    bool have_avx2() {
+#if defined(QBIN_RUNNER_HAVE_AVX2) && (defined(__GNUC__) || defined(__clang__))
+        static const bool ok = __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+        return ok;
+#else
+        return false;
+#endif
+    }
+
+    bool StateVector::init(unsigned num_qubits, std::string& err) {
+        if (num_qubits > kMaxQubits) {
+            err = "Too many qubits for a state vector: " + std::to_string(num_qubits) +
+                " (max " + std::to_string(kMaxQubits) + ")";
+            return false;
+        }
+        try {
+            std::vector<amp_t> v(size_t(1) << num_qubits);
+            amps_ = std::move(v);
+        }
+        catch (const std::bad_alloc&) {
+            err = "Cannot allocate a " + std::to_string(num_qubits) + "-qubit state vector";
+            return false;
+        }
+        n_ = num_qubits;
+        amps_[0] = 1.0;
+        return true;
+    }
+
+    void StateVector::reset_zero() {
+        std::fill(amps_.begin(), amps_.end(), amp_t(0.0));
+        if (!amps_.empty()) amps_[0] = 1.0;
+    }
+
+    void StateVector::apply_1q(unsigned t, const Mat2& m) {
+        if (simd_) { detail::apply_1q_avx2(amps_.data(), amps_.size(), t, m); return; }
+        amp_t* a = amps_.data();
+        const size_t half = amps_.size() >> 1;
+        const size_t bit = size_t(1) << t;
+        const bool parallel = half >= kParallelThreshold;
+        (void)parallel;
+        QBIN_OMP_FOR
+        for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(half); ++k) {
+            const size_t i0 = insert_zero(size_t(k), t), i1 = i0 | bit;
+            const amp_t a0 = a[i0], a1 = a[i1];
+            a[i0] = m.m00 * a0 + m.m01 * a1;
+            a[i1] = m.m10 * a0 + m.m11 * a1;
+        }
+    }
+
+    void StateVector::apply_c1q(unsigned c, unsigned t, const Mat2& m) {
+        if (simd_) { detail::apply_c1q_avx2(amps_.data(), amps_.size(), c, t, m); return; }
+        amp_t* a = amps_.data();
+        const size_t quarter = amps_.size() >> 2;
+        const unsigned lo = std::min(c, t), hi = std::max(c, t);
+        const size_t cbit = size_t(1) << c, tbit = size_t(1) << t;
+        const bool parallel = quarter >= kParallelThreshold;
+        (void)parallel;
+        QBIN_OMP_FOR
+        for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(quarter); ++k) {
+            const size_t i0 = insert_zero(insert_zero(size_t(k), lo), hi) | cbit, i1 = i0 | tbit;
+            const amp_t a0 = a[i0], a1 = a[i1];
+            a[i0] = m.m00 * a0 + m.m01 * a1;
+            a[i1] = m.m10 * a0 + m.m11 * a1;
+        }
+    }
+
+    void StateVector::apply_2q(unsigned q0, unsigned q1, const Mat4& m) {
+        if (simd_) { detail::apply_2q_avx2(amps_.data(), amps_.size(), q0, q1, m); return; }
+        amp_t* a = amps_.data();
+        const size_t quarter = amps_.size() >> 2;
+        const unsigned lo = std::min(q0, q1), hi = std::max(q0, q1);
+        const size_t b0 = size_t(1) << q0, b1 = size_t(1) << q1;
+        const bool parallel = quarter >= kParallelThreshold;
+        (void)parallel;
+        QBIN_OMP_FOR
+        for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(quarter); ++k) {
+            const size_t base = insert_zero(insert_zero(size_t(k), lo), hi);
+            const size_t idx[4] = { base, base | b0, base | b1, base | b0 | b1 };
+            const amp_t in[4] = { a[idx[0]], a[idx[1]], a[idx[2]], a[idx[3]] };
+            for (int r = 0; r < 4; ++r) {
+                a[idx[r]] = m.m[r][0] * in[0] + m.m[r][1] * in[1] + m.m[r][2] * in[2] + m.m[r][3] * in[3];
+            }
+        }
+    }
+
+    double StateVector::prob_one(unsigned q) const {
+        const amp_t* a = amps_.data();
+        const size_t half = amps_.size() >> 1;
+        const size_t bit = size_t(1) << q;
+        const bool parallel = half >= kParallelThreshold;
+        (void)parallel;
+        double sum = 0.0;
+        QBIN_OMP_FOR_SUM
+        for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(half); ++k) {
+            sum += std::norm(a[insert_zero(size_t(k), q) | bit]);
+        }
+        return sum;
+    }
+
+    void StateVector::collapse(unsigned q, int bit, double p) {
+        amp_t* a = amps_.data();
+        const size_t half = amps_.size() >> 1;
+        const size_t qbit = size_t(1) << q;
+        const double scale = p > 0.0 ? 1.0 / std::sqrt(p) : 0.0;
+        const bool parallel = half >= kParallelThreshold;
+        (void)parallel;
+        QBIN_OMP_FOR
+        for (std::ptrdiff_t k = 0; k < std::ptrdiff_t(half); ++k) {
+            const size_t i0 = insert_zero(size_t(k), q), i1 = i0 | qbit;
+            if (bit) { a[i0] = 0.0; a[i1] *= scale; }
+            else { a[i0] *= scale; a[i1] = 0.0; }
+        }
+    }
+
+#if !defined(QBIN_RUNNER_HAVE_AVX2)
+    // Never reached: have_avx2() is false without the AVX2 translation unit.
+    namespace detail {
+        void apply_1q_avx2(amp_t*, size_t, unsigned, const Mat2&) {}
+        void apply_c1q_avx2(amp_t*, size_t, unsigned, unsigned, const Mat2&) {}
+        void apply_2q_avx2(amp_t*, size_t, unsigned, unsigned, const Mat4&) {}
+    } // namespace detail
+#endif
+
+} // namespace qbin_runner
@@ -0,0 +1,49 @@
+#ifndef QBIN_SERVER_CLIENT_HPP
+#define QBIN_SERVER_CLIENT_HPP
+
+#include "qbin_server/protocol.hpp"
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// ASCII-only header.
+// Blocking client for qbin-serve: one request in flight per Client. Use one
+// Client per thread for concurrent requests.
+
+namespace qbin_server {
+
+    class Client {
+    public:
+        Client() = default;
+        ~Client();
+        Client(const Client&) = delete;
+        Client& operator=(const Client&) = delete;
+
+        bool connect(const std::string& socket_path, std::string& err);
+        void close();
+        bool connected() const { return fd_ >= 0; }
+
+        // Compile options travel in the request header; see protocol.hpp.
+        bool compile(const std::string& qasm, const RequestHeader& opts,
+            std::vector<uint8_t>& qbin, std::string& err);
+        bool decompile(const uint8_t* qbin, size_t n, bool gate_defs,
+            std::string& qasm, std::string& err);
+        bool stats(std::string& report, std::string& err);
+        bool ping(std::string& err);
+        bool shutdown(std::string& err);
+
+        // One raw round trip: sends `h` + payload and returns the response
+        // payload; false on I/O errors or Status::Error (message in err).
+        bool call(const RequestHeader& h, const void* payload, size_t n,
+            std::vector<uint8_t>& reply, std::string& err);
+
+    private:
+        int fd_ = -1;
+        uint32_t next_id_ = 1;
+    };
+
+} // namespace qbin_server
+
+#endif // QBIN_SERVER_CLIENT_HPP
@@ -0,0 +1,75 @@
+#ifndef QBIN_SERVER_HISTOGRAM_HPP
+#define QBIN_SERVER_HISTOGRAM_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// ASCII-only header.
+// Log-linear latency histogram: values below 16 ns are exact, larger ones
+// fall into 16 buckets per power of two (relative error < 6.25%). Fixed
+// size, no allocation; not thread-safe (record from one thread or merge()).
+
+namespace qbin_server {
+
+    class LatencyHistogram {
+    public:
+        static constexpr size_t kSub = 16;
+        static constexpr size_t kBuckets = kSub + 60 * kSub;
+
+        void record(uint64_t ns) {
+            ++counts_[bucket(ns)];
+            ++count_;
+            sum_ += ns;
+            if (ns > max_) max_ = ns;
+        }
+
+        void merge(const LatencyHistogram& o) {
+            for (size_t i = 0; i < kBuckets; ++i) counts_[i] += o.counts_[i];
+            count_ += o.count_;
+            sum_ += o.sum_;
+            if (o.max_ > max_) max_ = o.max_;
+        }
+
+        uint64_t count() const { return count_; }
+        uint64_t max() const { return max_; }
+        double mean() const { return count_ ? double(sum_) / double(count_) : 0.0; }
+
+        // Upper bound of the bucket holding quantile q (0 < q <= 1), in ns.
+        uint64_t percentile(double q) const {
+            if (count_ == 0) return 0;
+            uint64_t rank = uint64_t(q * double(count_) + 0.5);
+            if (rank == 0) rank = 1;
+            uint64_t seen = 0;
+            for (size_t i = 0; i < kBuckets; ++i) {
+                seen += counts_[i];
+                if (seen >= rank) {
+                    const uint64_t hi = upper(i);
+                    return hi < max_ ? hi : max_;
+                }
+            }
+            return max_;
+        }
+
+    private:
+        static size_t bucket(uint64_t v) {
+            if (v < kSub) return size_t(v);
+            int e = 63 - __builtin_clzll(v);          // >= 4
+            const uint64_t sub = (v >> (e - 4)) & (kSub - 1);
+            return kSub + size_t(e - 4) * kSub + size_t(sub);
+        }
+        static uint64_t upper(size_t i) {
+            if (i < kSub) return i;
+            const size_t e = (i - kSub) / kSub + 4;
+            const uint64_t sub = (i - kSub) % kSub;
+            return ((kSub + sub + 1) << (e - 4)) - 1;
+        }
+
+        uint64_t counts_[kBuckets] = {};
+        uint64_t count_ = 0;
+        uint64_t sum_ = 0;
+        uint64_t max_ = 0;
+    };
+
+} // namespace qbin_server
+
+#endif // QBIN_SERVER_HISTOGRAM_HPP
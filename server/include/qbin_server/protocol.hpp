@@ -0,0 +1,77 @@
+#ifndef QBIN_SERVER_PROTOCOL_HPP
+#define QBIN_SERVER_PROTOCOL_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+// ASCII-only header.
+// qbin-serve wire protocol over a Unix stream socket. Every message is a
+// 12-byte header followed by a payload; integers are little-endian.
+//
+//   request:  u32 len | u8 op | u8 flags | u8 opt_level | u8 compress | u32 id | payload
+//   response: u32 len | u8 status | u8[3] 0 | u32 id | payload
+//
+// `len` counts the bytes after itself (8 + payload size). `id` is chosen by
+// the client and echoed in the response; a connection may pipeline requests,
+// and responses can come back in a different order than the requests.
+
+namespace qbin_server {
+
+    constexpr size_t kHeaderSize = 12;
+    constexpr uint32_t kMaxPayload = 64u << 20;   // larger frames close the connection
+
+    enum class Op : uint8_t {
+        Compile = 1,     // payload: QASM text       -> QBIN bytes
+        Decompile = 2,   // payload: QBIN bytes      -> QASM text
+        Stats = 3,       // no payload               -> text report (counters, latency percentiles)
+        Ping = 4,        // no payload               -> empty
+        Shutdown = 5,    // no payload               -> empty; the server exits after replying
+    };
+
+    // Request flags
+    constexpr uint8_t kFlagInternAngles = 1u << 0;   // Compile
+    constexpr uint8_t kFlagDedupGates = 1u << 1;     // Compile
+    constexpr uint8_t kFlagDeltaOperands = 1u << 2;  // Compile
+    constexpr uint8_t kFlagDebugInfo = 1u << 3;      // Compile: DEBG source map
+    constexpr uint8_t kFlagFuse1q = 1u << 4;         // Compile: single-qubit runs into U
+    constexpr uint8_t kFlagGateDefs = 1u << 0;       // Decompile
+
+    enum class Status : uint8_t {
+        Ok = 0,
+        Error = 1,       // payload: message
+    };
+
+    struct RequestHeader {
+        Op op = Op::Ping;
+        uint8_t flags = 0;
+        uint8_t opt_level = 0;   // Compile: 0..2
+        uint8_t compress = 0;    // Compile: zstd level, 0 = off
+        uint32_t id = 0;
+    };
+
+    inline void put_u32(uint8_t* p, uint32_t v) {
+        p[0] = uint8_t(v); p[1] = uint8_t(v >> 8); p[2] = uint8_t(v >> 16); p[3] = uint8_t(v >> 24);
+    }
+    inline uint32_t get_u32(const uint8_t* p) {
+        return uint32_t(p[0]) | (uint32_t(p[1]) << 8) | (uint32_t(p[2]) << 16) | (uint32_t(p[3]) << 24);
+    }
+
+    inline void encode_request_header(const RequestHeader& h, size_t payload, uint8_t out[kHeaderSize]) {
+        put_u32(out, uint32_t(8 + payload));
+        out[4] = uint8_t(h.op);
+        out[5] = h.flags;
+        out[6] = h.opt_level;
+        out[7] = h.compress;
+        put_u32(out + 8, h.id);
+    }
+
+    inline void encode_response_header(Status st, uint32_t id, size_t payload, uint8_t out[kHeaderSize]) {
+        put_u32(out, uint32_t(8 + payload));
+        out[4] = uint8_t(st);
+        out[5] = out[6] = out[7] = 0;
+        put_u32(out + 8, id);
+    }
+
+} // namespace qbin_server
+
+#endif // QBIN_SERVER_PROTOCOL_HPP
@@ -0,0 +1,142 @@
+#ifndef QBIN_SERVER_SERVER_HPP
+#define QBIN_SERVER_SERVER_HPP
+
+#include "qbin_server/histogram.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <unordered_map>
+#include <vector>
+
+// ASCII-only header.
+// qbin-serve: the compiler and decompiler kept resident behind a Unix domain
+// socket (protocol.hpp), so that short requests cost a round trip instead of
+// a process start.
+//
+//  - One I/O thread runs a poll() loop over the listening socket and all
+//    connections. A request payload is received into its own buffer, which
+//    is moved to a worker; the result buffer is moved back and sent with
+//    its header in one sendmsg(). Payloads are not copied between threads.
+//  - Workers take requests in batches (everything queued, up to batch_max,
+//    optionally waiting batch_window for more). Identical compile requests
+//    within a batch are compiled once, and a batch posts all its responses
+//    with a single wakeup of the I/O thread.
+//  - Latency from "request received" to "response handed to the kernel" is
+//    recorded per operation in a LatencyHistogram; Op::Stats reports it.
+
+namespace qbin_server {
+
+    struct ServerOptions {
+        std::string socket_path;
+        unsigned workers = 0;                       // 0 = hardware threads
+        size_t batch_max = 32;                      // requests per worker batch
+        std::chrono::microseconds batch_window{0};  // wait for a batch to fill (0 = take what is queued)
+        bool verbose = false;
+    };
+
+    struct ServerStats {
+        uint64_t connections = 0;
+        uint64_t requests = 0;
+        uint64_t errors = 0;            // responses with Status::Error
+        uint64_t batches = 0;
+        uint64_t batched_requests = 0;  // requests handled by workers
+        uint64_t max_batch = 0;
+        uint64_t dedup_hits = 0;        // compile requests served by an identical one in the same batch
+        LatencyHistogram compile;
+        LatencyHistogram decompile;
+    };
+
+    class Server {
+    public:
+        explicit Server(ServerOptions opts);
+        ~Server();
+        Server(const Server&) = delete;
+        Server& operator=(const Server&) = delete;
+
+        // Binds and listens (socket mode 0600) and starts the workers. Fails if
+        // another server answers on the path; a stale socket file is replaced.
+        bool start(std::string& err);
+
+        // Serves until stop() or an Op::Shutdown request; returns 0 on a clean
+        // exit. The socket file is removed on return.
+        int run();
+
+        // Thread- and async-signal-safe.
+        void stop();
+
+        // Counters and histograms; thread-safe.
+        ServerStats stats() const;
+        std::string stats_report() const;
+
+    private:
+        using Clock = std::chrono::steady_clock;
+
+        struct Request {
+            uint64_t conn = 0;
+            uint32_t id = 0;
+            uint8_t op = 0, flags = 0, opt_level = 0, compress = 0;
+            std::string payload;
+            Clock::time_point received;
+        };
+        struct Response {
+            uint64_t conn = 0;
+            uint32_t id = 0;
+            uint8_t op = 0;
+            uint8_t status = 0;
+            std::vector<uint8_t> bytes;   // QBIN (compile)
+            std::string text;             // QASM, report or error message
+            bool is_text = false;
+            Clock::time_point received;
+        };
+        struct Conn {
+            int fd = -1;
+            uint8_t hdr[12];
+            size_t hdr_got = 0;
+            bool in_payload = false;
+            Request req;
+            size_t payload_got = 0;
+            std::deque<Response> out;
+            size_t out_off = 0;           // bytes of out.front() already written (header + payload)
+            bool closing = false;
+        };
+
+        void worker_loop();
+        void process_batch(std::vector<Request>& batch, std::vector<Response>& out);
+        bool accept_all();
+        bool read_conn(Conn& c, std::vector<Request>& ready);
+        bool write_conn(Conn& c);
+        void queue_response(Response r);
+        void close_conn(uint64_t id);
+
+        ServerOptions opts_;
+        int listen_fd_ = -1;
+        int wake_rd_ = -1, wake_wr_ = -1;
+        std::atomic<bool> stopping_{ false };
+        std::atomic<bool> wake_pending_{ false };
+
+        std::unordered_map<uint64_t, Conn> conns_;
+        uint64_t next_conn_ = 1;
+
+        std::mutex queue_mu_;
+        std::condition_variable queue_cv_;
+        std::deque<Request> queue_;
+        bool workers_stop_ = false;
+        std::vector<std::thread> workers_;
+
+        std::mutex done_mu_;
+        std::vector<Response> done_;
+
+        mutable std::mutex stats_mu_;
+        ServerStats stats_;
+    };
+
+} // namespace qbin_server
+
+#endif // QBIN_SERVER_SERVER_HPP
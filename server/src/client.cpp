@@ -0,0 +1,144 @@
+#include "qbin_server/client.hpp"
+
+#include <cerrno>
+#include <cstring>
+
+#include <sys/socket.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace qbin_server {
+
+    static bool write_all(int fd, iovec* iov, int n, std::string& err) {
+        while (n > 0) {
+            const ssize_t w = ::writev(fd, iov, n);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                err = std::string("write: ") + std::strerror(errno);
+                return false;
+            }
+            size_t left = size_t(w);
+            while (n > 0 && left >= iov->iov_len) { left -= iov->iov_len; ++iov; --n; }
+            if (n > 0) {
+                iov->iov_base = static_cast<uint8_t*>(iov->iov_base) + left;
+                iov->iov_len -= left;
+            }
+        }
+        return true;
+    }
+
+    static bool read_all(int fd, uint8_t* p, size_t n, std::string& err) {
+        while (n > 0) {
+            const ssize_t r = ::read(fd, p, n);
+            if (r == 0) { err = "server closed the connection"; return false; }
+            if (r < 0) {
+                if (errno == EINTR) continue;
+                err = std::string("read: ") + std::strerror(errno);
+                return false;
+            }
+            p += r;
+            n -= size_t(r);
+        }
+        return true;
+    }
+
+    Client::~Client() { close(); }
+
+    bool Client::connect(const std::string& socket_path, std::string& err) {
+        close();
+        sockaddr_un addr;
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (socket_path.empty() || socket_path.size() >= sizeof(addr.sun_path)) {
+            err = "bad socket path: " + socket_path;
+            return false;
+        }
+        std::memcpy(addr.sun_path, socket_path.c_str(), socket_path.size() + 1);
+        fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (fd_ < 0) { err = std::string("socket: ") + std::strerror(errno); return false; }
+        if (::connect(fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) != 0) {
+            err = "connect " + socket_path + ": " + std::strerror(errno);
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    void Client::close() {
+        if (fd_ >= 0) ::close(fd_);
+        fd_ = -1;
+    }
+
+    bool Client::call(const RequestHeader& h0, const void* payload, size_t n,
+        std::vector<uint8_t>& reply, std::string& err) {
+        if (fd_ < 0) { err = "not connected"; return false; }
+        if (n > kMaxPayload) { err = "request payload too large"; return false; }
+        RequestHeader h = h0;
+        h.id = next_id_++;
+        uint8_t hdr[kHeaderSize];
+        encode_request_header(h, n, hdr);
+        iovec iov[2];
+        iov[0].iov_base = hdr;
+        iov[0].iov_len = kHeaderSize;
+        iov[1].iov_base = const_cast<void*>(payload);
+        iov[1].iov_len = n;
+        if (!write_all(fd_, iov, n ? 2 : 1, err)) { close(); return false; }
+
+        uint8_t rh[kHeaderSize];
+        if (!read_all(fd_, rh, kHeaderSize, err)) { close(); return false; }
+        const uint32_t len = get_u32(rh);
+        if (len < 8 || get_u32(rh + 8) != h.id) {
+            err = "malformed response";
+            close();
+            return false;
+        }
+        reply.resize(len - 8);
+        if (!reply.empty() && !read_all(fd_, reply.data(), reply.size(), err)) { close(); return false; }
+        if (rh[4] != uint8_t(Status::Ok)) {
+            err.assign(reply.begin(), reply.end());
+            return false;
+        }
+        return true;
+    }
+
+    bool Client::compile(const std::string& qasm, const RequestHeader& opts,
+        std::vector<uint8_t>& qbin, std::string& err) {
+        RequestHeader h = opts;
+        h.op = Op::Compile;
+        return call(h, qasm.data(), qasm.size(), qbin, err);
+    }
+
+    bool Client::decompile(const uint8_t* qbin, size_t n, bool gate_defs,
+        std::string& qasm, std::string& err) {
+        RequestHeader h;
+        h.op = Op::Decompile;
+        h.flags = gate_defs ? kFlagGateDefs : 0;
+        std::vector<uint8_t> reply;
+        if (!call(h, qbin, n, reply, err)) return false;
+        qasm.assign(reply.begin(), reply.end());
+        return true;
+    }
+
+    bool Client::stats(std::string& report, std::string& err) {
+        RequestHeader h;
+        h.op = Op::Stats;
+        std::vector<uint8_t> reply;
+        if (!call(h, nullptr, 0, reply, err)) return false;
+        report.assign(reply.begin(), reply.end());
+        return true;
+    }
+
+    bool Client::ping(std::string& err) {
+        std::vector<uint8_t> reply;
+        return call(RequestHeader{}, nullptr, 0, reply, err);
+    }
+
+    bool Client::shutdown(std::string& err) {
+        RequestHeader h;
+        h.op = Op::Shutdown;
+        std::vector<uint8_t> reply;
+        return call(h, nullptr, 0, reply, err);
+    }
+
+} // namespace qbin_server
@@ -0,0 +1,170 @@
+// main.cpp - qbin-serve: resident compiler/decompiler on a Unix socket, and its client
+
+#include "qbin_server/client.hpp"
+#include "qbin_server/server.hpp"
+
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+static void print_usage(const char* argv0) {
+    std::cerr
+        << "Usage:\n"
+        << "  " << argv0 << " [--socket <path>] [--workers N] [--batch-max N] [--batch-window-us N] [--verbose]\n"
+        << "  " << argv0 << " [--socket <path>] --client compile <in.qasm> -o <out.qbin> [-O0|-O1|-O2]\n"
+        << "         [--fuse-1q] [--intern-angles] [--dedup-gates] [--delta-operands] [--compress]\n"
+        << "         [--compress-level <n>] [-g]\n"
+        << "  " << argv0 << " [--socket <path>] --client decompile <in.qbin> [-o <out.qasm>] [--gate-defs]\n"
+        << "  " << argv0 << " [--socket <path>] --client stats|ping|shutdown\n"
+        << "\n"
+        << "Serves compile and decompile requests until SIGINT/SIGTERM or a shutdown\n"
+        << "request. The socket defaults to $QBIN_SERVE_SOCKET.\n"
+        << "\n"
+        << "Options:\n"
+        << "  --workers N         worker threads (default: hardware threads)\n"
+        << "  --batch-max N       requests a worker takes at once (default 32)\n"
+        << "  --batch-window-us N wait up to N us for a batch to fill (default 0)\n"
+        << "  --verbose           log startup and print stats on exit\n"
+        << "  --client <op>       send one request to a running server; outputs match\n"
+        << "                      qbin-compile / qbin-decompile\n";
+}
+
+static bool read_file(const std::string& path, std::string& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+static bool write_file(const std::string& path, const void* data, size_t n) {
+    std::ofstream f(path, std::ios::binary);
+    if (!f) return false;
+    f.write(static_cast<const char*>(data), static_cast<std::streamsize>(n));
+    return bool(f);
+}
+
+static bool parse_uint(const char* s, unsigned long long max, unsigned long long& v) {
+    char* end = nullptr;
+    v = std::strtoull(s, &end, 10);
+    return end && *end == '\0' && end != s && v <= max;
+}
+
+static qbin_server::Server* g_server = nullptr;
+
+static void on_signal(int) {
+    if (g_server) g_server->stop();
+}
+
+static int run_client(const std::string& socket_path, const std::string& op, const std::string& in_path,
+    const std::string& out_path, const qbin_server::RequestHeader& copts, bool gate_defs) {
+    qbin_server::Client client;
+    std::string err;
+    if (!client.connect(socket_path, err)) { std::cerr << err << "\n"; return 1; }
+
+    if (op == "compile" || op == "decompile") {
+        std::string in;
+        if (in_path.empty()) { std::cerr << "--client " << op << " needs an input file\n"; return 1; }
+        if (!read_file(in_path, in)) { std::cerr << "Cannot open input: " << in_path << "\n"; return 1; }
+        if (op == "compile") {
+            if (out_path.empty()) { std::cerr << "--client compile needs -o <out.qbin>\n"; return 1; }
+            std::vector<uint8_t> qbin;
+            if (!client.compile(in, copts, qbin, err)) { std::cerr << "compile: " << err << "\n"; return 1; }
+            if (!write_file(out_path, qbin.data(), qbin.size())) { std::cerr << "Write failed: " << out_path << "\n"; return 1; }
+            return 0;
+        }
+        std::string qasm;
+        if (!client.decompile(reinterpret_cast<const uint8_t*>(in.data()), in.size(), gate_defs, qasm, err)) {
+            std::cerr << "decompile: " << err << "\n";
+            return 1;
+        }
+        // Same trailing-newline normalization as qbin-decompile
+        while (!qasm.empty() && qasm.back() == '\n') qasm.pop_back();
+        qasm.append("\n\n");
+        if (out_path.empty()) std::cout << qasm;
+        else if (!write_file(out_path, qasm.data(), qasm.size())) { std::cerr << "Write failed: " << out_path << "\n"; return 1; }
+        return 0;
+    }
+    if (op == "stats") {
+        std::string report;
+        if (!client.stats(report, err)) { std::cerr << err << "\n"; return 1; }
+        std::cout << report;
+        return 0;
+    }
+    if (op == "ping") {
+        if (!client.ping(err)) { std::cerr << err << "\n"; return 1; }
+        return 0;
+    }
+    if (op == "shutdown") {
+        if (!client.shutdown(err)) { std::cerr << err << "\n"; return 1; }
+        return 0;
+    }
+    std::cerr << "Unknown client op: " << op << "\n";
+    return 1;
+}
+
+int main(int argc, char** argv) {
+    qbin_server::ServerOptions opts;
+    if (const char* env = std::getenv("QBIN_SERVE_SOCKET")) opts.socket_path = env;
+
+    std::string client_op, in_path, out_path;
+    qbin_server::RequestHeader copts;
+    bool gate_defs = false;
+    for (int i = 1; i < argc; ++i) {
+        std::string a = argv[i];
+        unsigned long long v = 0;
+        if (a == "--socket" && i + 1 < argc) opts.socket_path = argv[++i];
+        else if (a == "--workers" && i + 1 < argc) {
+            if (!parse_uint(argv[++i], 1024, v)) { std::cerr << "Bad --workers value\n"; return 1; }
+            opts.workers = unsigned(v);
+        }
+        else if (a == "--batch-max" && i + 1 < argc) {
+            if (!parse_uint(argv[++i], 1u << 16, v) || v == 0) { std::cerr << "Bad --batch-max value\n"; return 1; }
+            opts.batch_max = size_t(v);
+        }
+        else if (a == "--batch-window-us" && i + 1 < argc) {
+            if (!parse_uint(argv[++i], 1000000, v)) { std::cerr << "Bad --batch-window-us value\n"; return 1; }
+            opts.batch_window = std::chrono::microseconds(v);
+        }
+        else if (a == "--verbose") opts.verbose = true;
+        else if (a == "--client" && i + 1 < argc) client_op = argv[++i];
+        else if (a == "-o" && i + 1 < argc) out_path = argv[++i];
+        else if (a == "-O0" || a == "-O1" || a == "-O2") copts.opt_level = uint8_t(a[2] - '0');
+        else if (a == "--fuse-1q") copts.flags |= qbin_server::kFlagFuse1q;
+        else if (a == "--intern-angles") copts.flags |= qbin_server::kFlagInternAngles;
+        else if (a == "--dedup-gates") copts.flags |= qbin_server::kFlagDedupGates;
+        else if (a == "--delta-operands") copts.flags |= qbin_server::kFlagDeltaOperands;
+        else if (a == "-g" || a == "--debug-info") copts.flags |= qbin_server::kFlagDebugInfo;
+        else if (a == "--compress") { if (copts.compress == 0) copts.compress = 19; }
+        else if (a == "--compress-level" && i + 1 < argc) {
+            if (!parse_uint(argv[++i], 22, v) || v == 0) { std::cerr << "Bad --compress-level value\n"; return 1; }
+            copts.compress = uint8_t(v);
+        }
+        else if (a == "--gate-defs") gate_defs = true;
+        else if (a == "-h" || a == "--help") { print_usage(argv[0]); return 0; }
+        else if (!client_op.empty() && in_path.empty() && a[0] != '-') in_path = a;
+        else { std::cerr << "Unknown arg: " << a << "\n"; print_usage(argv[0]); return 1; }
+    }
+    if (opts.socket_path.empty()) {
+        std::cerr << "No socket: pass --socket <path> or set QBIN_SERVE_SOCKET\n";
+        return 1;
+    }
+
+    if (!client_op.empty()) return run_client(opts.socket_path, client_op, in_path, out_path, copts, gate_defs);
+
+    qbin_server::Server server(opts);
+    std::string err;
+    if (!server.start(err)) { std::cerr << "qbin-serve: " << err << "\n"; return 1; }
+    g_server = &server;
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    std::signal(SIGPIPE, SIG_IGN);
+    const int rc = server.run();
+    g_server = nullptr;
+    return rc;
+}
@@ -0,0 +1,510 @@
+#include "qbin_server/server.hpp"
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_compiler/compress.hpp"
+#include "qbin_compiler/hash.hpp"
+#include "qbin_decompiler/decompiler.hpp"
+#include "qbin_server/protocol.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <exception>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/uio.h>
+#include <sys/un.h>
+#include <unistd.h>
+
+namespace qbin_server {
+
+    static bool make_addr(const std::string& path, sockaddr_un& addr, std::string& err) {
+        std::memset(&addr, 0, sizeof(addr));
+        addr.sun_family = AF_UNIX;
+        if (path.empty() || path.size() >= sizeof(addr.sun_path)) {
+            err = "socket path empty or longer than " + std::to_string(sizeof(addr.sun_path) - 1) + " bytes";
+            return false;
+        }
+        std::memcpy(addr.sun_path, path.c_str(), path.size() + 1);
+        return true;
+    }
+
+    static bool set_nonblocking(int fd) {
+        const int fl = fcntl(fd, F_GETFL, 0);
+        return fl >= 0 && fcntl(fd, F_SETFL, fl | O_NONBLOCK) == 0;
+    }
+
+    Server::Server(ServerOptions opts) : opts_(std::move(opts)) {
+        if (opts_.workers == 0) opts_.workers = std::max(1u, std::thread::hardware_concurrency());
+        if (opts_.batch_max == 0) opts_.batch_max = 1;
+    }
+
+    Server::~Server() {
+        {
+            std::lock_guard<std::mutex> lk(queue_mu_);
+            workers_stop_ = true;
+        }
+        queue_cv_.notify_all();
+        for (auto& t : workers_) t.join();
+        for (auto& kv : conns_) ::close(kv.second.fd);
+        if (listen_fd_ >= 0) ::close(listen_fd_);
+        if (wake_rd_ >= 0) ::close(wake_rd_);
+        if (wake_wr_ >= 0) ::close(wake_wr_);
+    }
+
+    bool Server::start(std::string& err) {
+        sockaddr_un addr;
+        if (!make_addr(opts_.socket_path, addr, err)) return false;
+
+        // A live server keeps its socket; a stale file from a crashed one is replaced
+        struct stat st;
+        if (::stat(opts_.socket_path.c_str(), &st) == 0) {
+            if (!S_ISSOCK(st.st_mode)) { err = opts_.socket_path + " exists and is not a socket"; return false; }
+            const int probe = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+            const bool live = probe >= 0 && ::connect(probe, reinterpret_cast<sockaddr*>(&addr), sizeof(addr)) == 0;
+            if (probe >= 0) ::close(probe);
+            if (live) { err = "another server is listening on " + opts_.socket_path; return false; }
+            ::unlink(opts_.socket_path.c_str());
+        }
+
+        listen_fd_ = ::socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+        if (listen_fd_ < 0) { err = std::string("socket: ") + std::strerror(errno); return false; }
+        const mode_t old_mask = ::umask(077);   // socket file mode 0600
+        const int rc = ::bind(listen_fd_, reinterpret_cast<sockaddr*>(&addr), sizeof(addr));
+        ::umask(old_mask);
+        if (rc != 0) { err = "bind " + opts_.socket_path + ": " + std::strerror(errno); return false; }
+        if (::listen(listen_fd_, 128) != 0 || !set_nonblocking(listen_fd_)) {
+            err = std::string("listen: ") + std::strerror(errno);
+            return false;
+        }
+
+        int p[2];
+        if (::pipe(p) != 0 || !set_nonblocking(p[0]) || !set_nonblocking(p[1])) {
+            err = std::string("pipe: ") + std::strerror(errno);
+            return false;
+        }
+        wake_rd_ = p[0];
+        wake_wr_ = p[1];
+        fcntl(wake_rd_, F_SETFD, FD_CLOEXEC);
+        fcntl(wake_wr_, F_SETFD, FD_CLOEXEC);
+
+        for (unsigned k = 0; k < opts_.workers; ++k) workers_.emplace_back([this] { worker_loop(); });
+        if (opts_.verbose) {
+            std::fprintf(stderr, "qbin-serve: listening on %s (%u workers, batch <= %zu)\n",
+                opts_.socket_path.c_str(), opts_.workers, opts_.batch_max);
+        }
+        return true;
+    }
+
+    void Server::stop() {
+        stopping_.store(true);
+        if (wake_wr_ >= 0) {
+            const char c = 's';
+            ssize_t r = ::write(wake_wr_, &c, 1);
+            (void)r;
+        }
+    }
+
+    // ---- Workers ----
+
+    void Server::worker_loop() {
+        std::vector<Request> batch;
+        std::vector<Response> out;
+        for (;;) {
+            {
+                std::unique_lock<std::mutex> lk(queue_mu_);
+                queue_cv_.wait(lk, [&] { return workers_stop_ || !queue_.empty(); });
+                if (workers_stop_) return;
+                if (opts_.batch_window.count() > 0 && queue_.size() < opts_.batch_max) {
+                    queue_cv_.wait_for(lk, opts_.batch_window,
+                        [&] { return workers_stop_ || queue_.size() >= opts_.batch_max; });
+                    if (workers_stop_) return;
+                }
+                const size_t n = std::min(queue_.size(), opts_.batch_max);
+                for (size_t k = 0; k < n; ++k) {
+                    batch.push_back(std::move(queue_.front()));
+                    queue_.pop_front();
+                }
+                if (!queue_.empty()) queue_cv_.notify_one();
+            }
+            if (batch.empty()) continue;
+
+            process_batch(batch, out);
+            {
+                std::lock_guard<std::mutex> lk(stats_mu_);
+                ++stats_.batches;
+                stats_.batched_requests += batch.size();
+                stats_.max_batch = std::max<uint64_t>(stats_.max_batch, batch.size());
+            }
+            {
+                std::lock_guard<std::mutex> lk(done_mu_);
+                for (auto& r : out) done_.push_back(std::move(r));
+            }
+            if (!wake_pending_.exchange(true)) {
+                const char c = 'w';
+                ssize_t r = ::write(wake_wr_, &c, 1);
+                (void)r;
+            }
+            batch.clear();
+            out.clear();
+        }
+    }
+
+    void Server::process_batch(std::vector<Request>& batch, std::vector<Response>& out) {
+        // Compile requests already handled in this batch, by payload hash
+        std::vector<std::pair<uint64_t, size_t>> seen;
+        uint64_t dedup = 0;
+        out.reserve(batch.size());
+        for (size_t k = 0; k < batch.size(); ++k) {
+            Request& rq = batch[k];
+            Response rs;
+            rs.conn = rq.conn;
+            rs.id = rq.id;
+            rs.op = rq.op;
+            rs.received = rq.received;
+            try {
+                if (rq.op == uint8_t(Op::Compile)) {
+                    const uint64_t h = qbin_compiler::xxh3_64(rq.payload.data(), rq.payload.size());
+                    const Response* same = nullptr;
+                    for (const auto& s : seen) {
+                        const Request& o = batch[s.second];
+                        if (s.first == h && o.flags == rq.flags && o.opt_level == rq.opt_level &&
+                            o.compress == rq.compress && o.payload == rq.payload) {
+                            same = &out[s.second];
+                            break;
+                        }
+                    }
+                    if (same) {
+                        rs.status = same->status;
+                        rs.bytes = same->bytes;
+                        rs.text = same->text;
+                        rs.is_text = same->is_text;
+                        ++dedup;
+                    }
+                    else if (rq.compress > 0 && !qbin_compiler::enc::zstd_available()) {
+                        rs.status = uint8_t(Status::Error);
+                        rs.text = "server built without zstd; compression unavailable";
+                        rs.is_text = true;
+                    }
+                    else {
+                        qbin_compiler::CompileOptions o;
+                        o.opt_level = std::min<int>(rq.opt_level, 2);
+                        o.fuse_1q = (rq.flags & kFlagFuse1q) != 0;
+                        o.intern_angles = (rq.flags & kFlagInternAngles) != 0;
+                        o.dedup_gates = (rq.flags & kFlagDedupGates) != 0;
+                        o.delta_operands = (rq.flags & kFlagDeltaOperands) != 0;
+                        o.debug_info = (rq.flags & kFlagDebugInfo) != 0;
+                        o.compress_level = rq.compress;
+                        rs.bytes = qbin_compiler::compile_qasm_to_qbin(rq.payload, o);
+                    }
+                    seen.emplace_back(h, k);
+                }
+                else if (rq.op == uint8_t(Op::Decompile)) {
+                    qbin_decompiler::DecompileOptions o;
+                    o.gate_defs = (rq.flags & kFlagGateDefs) != 0;
+                    std::string err;
+                    rs.is_text = true;
+                    if (!qbin_decompiler::decode_qbin_to_qasm(reinterpret_cast<const uint8_t*>(rq.payload.data()),
+                            rq.payload.size(), rs.text, err, o)) {
+                        rs.status = uint8_t(Status::Error);
+                        rs.text = std::move(err);
+                    }
+                }
+                else {
+                    rs.status = uint8_t(Status::Error);
+                    rs.text = "unknown op " + std::to_string(rq.op);
+                    rs.is_text = true;
+                }
+            }
+            catch (const std::exception& e) {
+                // A bad request must not take the server down
+                rs.status = uint8_t(Status::Error);
+                rs.bytes.clear();
+                rs.text = e.what();
+                rs.is_text = true;
+            }
+            // The payload is no longer needed; free it on the worker
+            std::string().swap(rq.payload);
+            out.push_back(std::move(rs));
+        }
+        if (dedup) {
+            std::lock_guard<std::mutex> lk(stats_mu_);
+            stats_.dedup_hits += dedup;
+        }
+    }
+
+    // ---- I/O thread ----
+
+    bool Server::accept_all() {
+        for (;;) {
+            const int fd = ::accept(listen_fd_, nullptr, nullptr);
+            if (fd < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            if (!set_nonblocking(fd)) { ::close(fd); continue; }
+            fcntl(fd, F_SETFD, FD_CLOEXEC);
+            Conn c;
+            c.fd = fd;
+            conns_.emplace(next_conn_++, std::move(c));
+            std::lock_guard<std::mutex> lk(stats_mu_);
+            ++stats_.connections;
+        }
+    }
+
+    // Reads as many complete requests as are available. The 12-byte header
+    // is read first, then the payload straight into the request's buffer.
+    bool Server::read_conn(Conn& c, std::vector<Request>& ready) {
+        for (;;) {
+            uint8_t* dst;
+            size_t want;
+            if (!c.in_payload) { dst = c.hdr + c.hdr_got; want = kHeaderSize - c.hdr_got; }
+            else { dst = reinterpret_cast<uint8_t*>(&c.req.payload[0]) + c.payload_got; want = c.req.payload.size() - c.payload_got; }
+            if (want > 0) {
+                const ssize_t r = ::read(c.fd, dst, want);
+                if (r == 0) return false;
+                if (r < 0) {
+                    if (errno == EINTR) continue;
+                    return errno == EAGAIN || errno == EWOULDBLOCK;
+                }
+                if (!c.in_payload) c.hdr_got += size_t(r);
+                else c.payload_got += size_t(r);
+                if (size_t(r) < want) continue;
+            }
+            if (!c.in_payload) {
+                const uint32_t len = get_u32(c.hdr);
+                if (len < 8 || len - 8 > kMaxPayload) return false;
+                c.req = Request{};
+                c.req.op = c.hdr[4];
+                c.req.flags = c.hdr[5];
+                c.req.opt_level = c.hdr[6];
+                c.req.compress = c.hdr[7];
+                c.req.id = get_u32(c.hdr + 8);
+                c.req.payload.resize(len - 8);
+                c.payload_got = 0;
+                c.in_payload = true;
+                if (len > 8) continue;
+            }
+            c.req.received = Clock::now();
+            ready.push_back(std::move(c.req));
+            c.in_payload = false;
+            c.hdr_got = 0;
+        }
+    }
+
+    bool Server::write_conn(Conn& c) {
+        while (!c.out.empty()) {
+            Response& r = c.out.front();
+            const uint8_t* data = r.is_text ? reinterpret_cast<const uint8_t*>(r.text.data()) : r.bytes.data();
+            const size_t size = r.is_text ? r.text.size() : r.bytes.size();
+            uint8_t hdr[kHeaderSize];
+            encode_response_header(Status(r.status), r.id, size, hdr);
+
+            iovec iov[2];
+            int n = 0;
+            if (c.out_off < kHeaderSize) {
+                iov[n].iov_base = hdr + c.out_off;
+                iov[n].iov_len = kHeaderSize - c.out_off;
+                ++n;
+            }
+            const size_t poff = c.out_off > kHeaderSize ? c.out_off - kHeaderSize : 0;
+            if (size > poff) {
+                iov[n].iov_base = const_cast<uint8_t*>(data + poff);
+                iov[n].iov_len = size - poff;
+                ++n;
+            }
+            msghdr msg;
+            std::memset(&msg, 0, sizeof(msg));
+            msg.msg_iov = iov;
+            msg.msg_iovlen = n;
+            const ssize_t w = ::sendmsg(c.fd, &msg, MSG_NOSIGNAL);
+            if (w < 0) {
+                if (errno == EINTR) continue;
+                return errno == EAGAIN || errno == EWOULDBLOCK;
+            }
+            c.out_off += size_t(w);
+            if (c.out_off < kHeaderSize + size) continue;
+
+            const uint64_t ns = uint64_t(std::chrono::duration_cast<std::chrono::nanoseconds>(Clock::now() - r.received).count());
+            {
+                std::lock_guard<std::mutex> lk(stats_mu_);
+                if (r.op == uint8_t(Op::Compile)) stats_.compile.record(ns);
+                else if (r.op == uint8_t(Op::Decompile)) stats_.decompile.record(ns);
+            }
+            c.out.pop_front();
+            c.out_off = 0;
+        }
+        return true;
+    }
+
+    void Server::queue_response(Response r) {
+        auto it = conns_.find(r.conn);
+        if (it == conns_.end()) return;   // client went away
+        if (r.status != uint8_t(Status::Ok)) {
+            std::lock_guard<std::mutex> lk(stats_mu_);
+            ++stats_.errors;
+        }
+        Conn& c = it->second;
+        c.out.push_back(std::move(r));
+        if (c.out.size() == 1 && !write_conn(c)) c.closing = true;
+    }
+
+    void Server::close_conn(uint64_t id) {
+        auto it = conns_.find(id);
+        if (it == conns_.end()) return;
+        ::close(it->second.fd);
+        conns_.erase(it);
+    }
+
+    int Server::run() {
+        std::vector<pollfd> pfds;
+        std::vector<uint64_t> ids;
+        std::vector<Request> ready;
+        std::vector<Response> done;
+        std::vector<uint64_t> dead;
+        while (!stopping_.load()) {
+            pfds.clear();
+            ids.clear();
+            pfds.push_back({ listen_fd_, POLLIN, 0 });
+            pfds.push_back({ wake_rd_, POLLIN, 0 });
+            for (const auto& kv : conns_) {
+                short ev = POLLIN;
+                if (!kv.second.out.empty()) ev |= POLLOUT;
+                pfds.push_back({ kv.second.fd, ev, 0 });
+                ids.push_back(kv.first);
+            }
+            if (::poll(pfds.data(), pfds.size(), -1) < 0) {
+                if (errno == EINTR) continue;
+                std::perror("qbin-serve: poll");
+                return 1;
+            }
+
+            // Finished batches
+            if (pfds[1].revents & POLLIN) {
+                char buf[64];
+                while (::read(wake_rd_, buf, sizeof(buf)) > 0) {}
+                wake_pending_.store(false);
+                {
+                    std::lock_guard<std::mutex> lk(done_mu_);
+                    done.swap(done_);
+                }
+                for (auto& r : done) queue_response(std::move(r));
+                done.clear();
+            }
+
+            if ((pfds[0].revents & POLLIN) && !accept_all()) {
+                std::perror("qbin-serve: accept");
+            }
+
+            // Requests; Stats/Ping/Shutdown are answered here, the rest go to the workers
+            ready.clear();
+            bool shutdown = false;
+            for (size_t k = 0; k < ids.size(); ++k) {
+                const short re = pfds[k + 2].revents;
+                if (!re) continue;
+                auto it = conns_.find(ids[k]);
+                if (it == conns_.end()) continue;
+                Conn& c = it->second;
+                const size_t first = ready.size();
+                if ((re & (POLLIN | POLLHUP | POLLERR)) && !read_conn(c, ready)) c.closing = true;
+                for (size_t j = first; j < ready.size(); ++j) ready[j].conn = ids[k];
+                if ((re & POLLOUT) && !write_conn(c)) c.closing = true;
+            }
+            size_t to_workers = 0;
+            for (size_t k = 0; k < ready.size(); ++k) {
+                Request& rq = ready[k];
+                const Op op = Op(rq.op);
+                if (op == Op::Compile || op == Op::Decompile) {
+                    if (k != to_workers) ready[to_workers] = std::move(rq);
+                    ++to_workers;
+                    continue;
+                }
+                Response rs;
+                rs.conn = rq.conn;
+                rs.id = rq.id;
+                rs.op = rq.op;
+                rs.received = rq.received;
+                rs.is_text = true;
+                if (op == Op::Stats) rs.text = stats_report();
+                else if (op == Op::Shutdown) shutdown = true;
+                else if (op != Op::Ping) { rs.status = uint8_t(Status::Error); rs.text = "unknown op " + std::to_string(rq.op); }
+                queue_response(std::move(rs));
+            }
+            ready.resize(to_workers);
+            {
+                std::lock_guard<std::mutex> lk(stats_mu_);
+                stats_.requests += ready.size();
+            }
+            if (!ready.empty()) {
+                {
+                    std::lock_guard<std::mutex> lk(queue_mu_);
+                    for (auto& rq : ready) queue_.push_back(std::move(rq));
+                }
+                if (ready.size() > 1) queue_cv_.notify_all();
+                else queue_cv_.notify_one();
+            }
+
+            dead.clear();
+            for (const auto& kv : conns_) {
+                if (kv.second.closing) dead.push_back(kv.first);
+            }
+            for (uint64_t id : dead) close_conn(id);
+            if (shutdown) stopping_.store(true);
+        }
+
+        {
+            std::lock_guard<std::mutex> lk(queue_mu_);
+            workers_stop_ = true;
+        }
+        queue_cv_.notify_all();
+        for (auto& t : workers_) t.join();
+        workers_.clear();
+        ::unlink(opts_.socket_path.c_str());
+        if (opts_.verbose) std::fputs(stats_report().c_str(), stderr);
+        return 0;
+    }
+
+    // ---- Stats ----
+
+    ServerStats Server::stats() const {
+        std::lock_guard<std::mutex> lk(stats_mu_);
+        return stats_;
+    }
+
+    static void latency_line(std::string& s, const char* name, const LatencyHistogram& h) {
+        char buf[192];
+        std::snprintf(buf, sizeof(buf),
+            "%-10s %8llu requests, latency us: p50 %.1f  p90 %.1f  p99 %.1f  p99.9 %.1f  max %.1f  mean %.1f\n",
+            name, static_cast<unsigned long long>(h.count()),
+            h.percentile(0.50) / 1e3, h.percentile(0.90) / 1e3, h.percentile(0.99) / 1e3,
+            h.percentile(0.999) / 1e3, h.max() / 1e3, h.mean() / 1e3);
+        s += buf;
+    }
+
+    std::string Server::stats_report() const {
+        const ServerStats st = stats();
+        std::string s;
+        char buf[192];
+        std::snprintf(buf, sizeof(buf), "connections: %llu\nrequests:    %llu (%llu errors)\n",
+            static_cast<unsigned long long>(st.connections), static_cast<unsigned long long>(st.requests),
+            static_cast<unsigned long long>(st.errors));
+        s += buf;
+        std::snprintf(buf, sizeof(buf), "batches:     %llu (avg %.2f, max %llu requests; %llu compiles deduplicated)\n",
+            static_cast<unsigned long long>(st.batches),
+            st.batches ? double(st.batched_requests) / double(st.batches) : 0.0,
+            static_cast<unsigned long long>(st.max_batch), static_cast<unsigned long long>(st.dedup_hits));
+        s += buf;
+        latency_line(s, "compile", st.compile);
+        latency_line(s, "decompile", st.decompile);
+        return s;
+    }
+
+} // namespace qbin_server
@@ -0,0 +1,134 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shutil, glob, math, time
+from concurrent.futures import ThreadPoolExecutor
+
+def run(cmd, cwd=None):
+  p = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+  return p.returncode, p.stdout, p.stderr
+
+def read(path):
+  with open(path, "rb") as f:
+    return f.read()
+
+def columns(prog):
+  # NaN != NaN; compare angles by bit pattern
+  return (list(prog.opcode), list(prog.a), list(prog.b), list(prog.c),
+          [repr(x) for x in prog.angle], [repr(x) for x in prog.angle1], [repr(x) for x in prog.angle2],
+          list(prog.aux))
+
+def main():
+  ap = argparse.ArgumentParser(description="Python bindings tester (qbin module must match qbin-compile/qbin-decompile)")
+  ap.add_argument("--library", required=True, help="path to libqbin")
+  ap.add_argument("--module-dir", required=True, help="directory containing qbin.py")
+  ap.add_argument("--compiler", required=True, help="path to qbin-compile")
+  ap.add_argument("--decompiler", required=True, help="path to qbin-decompile")
+  ap.add_argument("--vectors", required=True, help="directory of .qasm files")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  args = ap.parse_args()
+
+  os.environ["QBIN_LIBRARY"] = os.path.abspath(args.library)
+  sys.path.insert(0, os.path.abspath(args.module_dir))
+  import qbin
+
+  work = os.path.abspath(args.workdir)
+  shutil.rmtree(work, ignore_errors=True)
+  os.makedirs(work)
+  qasm_files = sorted(glob.glob(os.path.join(args.vectors, "*.qasm")))
+  if not qasm_files:
+    sys.stderr.write("No .qasm files in {}\n".format(args.vectors))
+    return 1
+
+  variants = [([], {}), (["-O2"], {"opt_level": 2}), (["--dedup-gates"], {"dedup_gates": True}),
+              (["--fuse-1q"], {"fuse_1q": True}),
+              (["--delta-operands", "-g"], {"delta_operands": True, "debug_info": True})]
+  sources = []
+  spawn_secs = 0.0
+  for path in qasm_files:
+    src = read(path)
+    sources.append(src)
+    plain = None
+    for flags, kwargs in variants:
+      ref = os.path.join(work, "ref.qbin")
+      t0 = time.perf_counter()
+      rc, so, se = run([args.compiler, path, "-o", ref, "--no-cache"] + flags)
+      spawn_secs += time.perf_counter() - t0
+      if rc != 0:
+        sys.stderr.write("qbin-compile failed on {} (rc={}):\n{}\n".format(path, rc, se.decode()))
+        return 1
+      blob = qbin.compile(src, **kwargs)
+      if not isinstance(blob, memoryview) or not blob.readonly or bytes(blob) != read(ref):
+        sys.stderr.write("qbin.compile differs from qbin-compile: {} {}\n".format(path, flags))
+        return 2
+      if not flags and bytes(qbin.compile(src.decode("utf-8"))) != bytes(blob):
+        sys.stderr.write("qbin.compile(str) differs from qbin.compile(bytes): {}\n".format(path))
+        return 2
+
+      for gate_defs in (False, True):
+        extra = ["--gate-defs"] if gate_defs else []
+        rc, so, se = run([args.decompiler, ref] + extra)
+        if rc != 0:
+          sys.stderr.write("qbin-decompile failed on {}:\n{}\n".format(path, se.decode()))
+          return 1
+        # The compile output is passed back in place (no bytes() copy)
+        if qbin.decompile(blob, gate_defs=gate_defs) != so.decode():
+          sys.stderr.write("qbin.decompile differs from qbin-decompile: {} {} {}\n".format(path, flags, extra))
+          return 2
+
+      # decode(): same columns from any buffer type; CALLG bodies inlined
+      prog = qbin.decode(blob)
+      cols = columns(prog)
+      if columns(qbin.decode(bytearray(blob))) != cols or columns(qbin.decode(read(ref))) != cols:
+        sys.stderr.write("qbin.decode depends on the buffer type: {} {}\n".format(path, flags))
+        return 2
+      if len(prog) != len(cols[0]) or any(len(c) != len(prog) for c in cols):
+        sys.stderr.write("qbin.decode columns differ in length: {}\n".format(path))
+        return 2
+      if not flags:
+        plain = cols
+      elif flags == ["--dedup-gates"] and cols != plain:
+        sys.stderr.write("qbin.decode of --dedup-gates differs from the plain program: {}\n".format(path))
+        return 2
+
+  # Known stream: Bell pair with a measurement
+  bell = qbin.decode(qbin.compile("OPENQASM 3.0;\nqubit[2] q;\nbit[2] c;\nh q[0];\ncx q[0], q[1];\nrz(0.5) q[1];\nc[1] = measure q[1];\n"))
+  got = list(bell)
+  if [g[0] for g in got][:3] != [0x04, 0x10, 0x0D] or got[1][1:3] != (0, 1) or got[0][2] != -1 \
+      or not math.isnan(got[0][4]) or got[2][4] != 0.5 or got[3][7] != 1:
+    sys.stderr.write("unexpected decode of the Bell program: {}\n".format(got))
+    return 2
+
+  # U carries theta, phi, lambda in angle, angle1, angle2
+  u = list(qbin.decode(qbin.compile("OPENQASM 3.0;\nqubit[1] q;\nu(0.5, -1.25, 2.75) q[0];\nx q[0];\n")))
+  if u[0][:1] + u[0][4:7] != (0x0F, 0.5, -1.25, 2.75) or not math.isnan(u[1][5]):
+    sys.stderr.write("unexpected decode of the U program: {}\n".format(u))
+    return 2
+
+  try:
+    qbin.decompile(b"not a qbin file")
+    sys.stderr.write("bad input did not raise\n")
+    return 2
+  except qbin.QbinError as e:
+    if not str(e):
+      sys.stderr.write("empty error message\n")
+      return 2
+
+  # Threads: the library runs without the GIL; results must match serial calls
+  serial = [bytes(qbin.compile(s, opt_level=1)) for s in sources]
+  jobs = sources * 8
+  t0 = time.perf_counter()
+  with ThreadPoolExecutor(max_workers=4) as pool:
+    par = list(pool.map(lambda s: bytes(qbin.compile(s, opt_level=1)), jobs))
+    text = list(pool.map(lambda b: qbin.decompile(b), par))
+  lib_secs = time.perf_counter() - t0
+  if par != serial * 8 or text != [qbin.decompile(b) for b in serial] * 8:
+    sys.stderr.write("threaded calls differ from serial calls\n")
+    return 2
+
+  shutil.rmtree(work, ignore_errors=True)
+  print("OK - {} vectors, libqbin {}".format(len(qasm_files), qbin.version()))
+  print("qbin-compile process: {:8.1f} us/circuit".format(spawn_secs * 1e6 / (len(qasm_files) * len(variants))))
+  print("qbin.compile+decompile: {:6.1f} us/circuit".format(lib_secs * 1e6 / len(jobs)))
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
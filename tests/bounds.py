@@ -0,0 +1,149 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shutil, struct
+
+def run(cmd):
+  p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+  return p.returncode, p.stdout, p.stderr
+
+def sections(blob):
+  count, table_off = struct.unpack_from("<II", blob, 8)
+  for k in range(count):
+    sid, off, size, flags = struct.unpack_from("<4sIII", blob, table_off + 16 * k)
+    yield sid.decode("ascii", "replace"), off, size
+
+def uleb(n):
+  out = bytearray()
+  while True:
+    b = n & 0x7F
+    n >>= 7
+    if n:
+      out.append(b | 0x80)
+    else:
+      out.append(b)
+      return bytes(out)
+
+def qbin_file(sections):
+  # Header (no CRC check on read), table at 24, payloads 8-aligned
+  pos = 24 + 16 * len(sections)
+  table, body = b"", b""
+  for tag, payload in sections:
+    pad = (-pos) % 8
+    body += b"\0" * pad
+    pos += pad
+    table += struct.pack("<4sIII", tag, pos, len(payload), 0)
+    body += payload
+    pos += len(payload)
+  return (b"QBIN" + bytes([1, 0, 0, 24]) + struct.pack("<III", len(sections), 24, 16 * len(sections)) +
+          b"\0" * 4 + table + body)
+
+def inst(records):
+  return b"INST" + uleb(len(records)) + b"".join(records)
+
+def inst_only(records):
+  return qbin_file([(b"INST", inst(records))])
+
+def main():
+  ap = argparse.ArgumentParser(description="QUBS/BITS bounds tester: out-of-range operands must fail to compile, "
+                               "shrinking a declared size must make decoding fail")
+  ap.add_argument("--compiler", required=True, help="path to qbin-compile")
+  ap.add_argument("--decompiler", required=True, help="path to qbin-decompile")
+  ap.add_argument("--qasm", required=True, help="input .qasm declaring one unnamed qubit and bit register, both fully used")
+  ap.add_argument("--runner", help="path to qbin-run (optional): bit indices beyond the bit space must fail cleanly")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  args = ap.parse_args()
+
+  work = os.path.abspath(args.workdir)
+  os.makedirs(work, exist_ok=True)
+  qbin = os.path.join(work, "out.qbin")
+
+  # An operand outside its declared register is a compile error, never a
+  # silently dropped statement
+  head = "OPENQASM 3.0;\nqubit[2] q;\nbit[2] c;\nh q[0];\n"
+  for stmt, want in (("x q[5];", "line 5: qubit q[5] OOB: q declares 2"),
+                     ("cx q[0], q[3];", "line 5: qubit q[3] OOB: q declares 2"),
+                     ("c[7] = measure q[1];", "line 5: bit c[7] OOB: c declares 2"),
+                     ("if (c[2] == 1) { x q[0]; }", "line 5: bit c[2] OOB: c declares 2"),
+                     ("u(0.5, 0, 0) q[2];", "line 5: qubit q[2] OOB: q declares 2")):
+    src = os.path.join(work, "oob.qasm")
+    with open(src, "w") as f:
+      f.write(head + stmt + "\n")
+    if os.path.exists(qbin):
+      os.remove(qbin)
+    rc, so, se = run([args.compiler, src, "-o", qbin, "--no-cache"])
+    if rc == 0 or want not in se or os.path.exists(qbin):
+      sys.stderr.write("'{}': expected a compile error with '{}' and no output, got rc={}:\n{}\n".format(stmt, want, rc, se))
+      return 2
+
+  rc, so, se = run([args.compiler, args.qasm, "-o", qbin, "--no-cache"])
+  if rc != 0:
+    sys.stderr.write("Compiler failed (rc={}):\n{}\n".format(rc, se))
+    return 1
+  with open(qbin, "rb") as f:
+    blob = f.read()
+  found = {sid: off for sid, off, size in sections(blob)}
+  for tag in ("QUBS", "BITS"):
+    if tag not in found:
+      sys.stderr.write("{} section missing\n".format(tag))
+      return 2
+    # magic, then the count varint; every vector declares fewer than 128
+    off = found[tag] + 4
+    count = blob[off]
+    if count == 0 or count & 0x80:
+      sys.stderr.write("{} count {} not usable for this test\n".format(tag, count))
+      return 2
+    bad = bytearray(blob)
+    bad[off] = count - 1
+    path = os.path.join(work, "{}.qbin".format(tag.lower()))
+    with open(path, "wb") as f:
+      f.write(bad)
+    rc, so, se = run([args.decompiler, path])
+    want = "OOB: {} declares {}".format(tag, count - 1)
+    if rc == 0 or want not in se:
+      sys.stderr.write("{} shrunk to {}: expected a decode error with '{}', got rc={}:\n{}\n".format(tag, count - 1, want, rc, se))
+      return 2
+
+  # Operands >= 2^31 must not wrap to negative indices and slip past
+  # ERR_QUBIT_OOB; a missing BITS section is reported as such
+  qubs = b"QUBS" + uleb(2) + bytes([0, 0])
+  for name, records, want in (("h_top", [bytes([0x04, 0x01]) + uleb(0xFFFFFFFF)], "bad a"),
+                              ("cx_2g", [bytes([0x10, 0x03, 0x00]) + uleb(1 << 31)], "bad b"),
+                              ("measure_nobits", [bytes([0x30, 0x81, 0x00]) + struct.pack("<I", 0xFFFFFFFF)],
+                               "bit 4294967295 OOB: no BITS section")):
+    path = os.path.join(work, name + ".qbin")
+    with open(path, "wb") as f:
+      f.write(qbin_file([(b"QUBS", qubs), (b"INST", inst(records))]))
+    rc, so, se = run([args.decompiler, path])
+    if rc == 0 or want not in se:
+      sys.stderr.write("{}: expected a decode error with '{}', got rc={}:\n{}{}\n".format(name, want, rc, so, se))
+      return 2
+
+  # Without BITS, qbin-run sizes the bit space from the operands: huge
+  # indices must be refused, not indexed or allocated
+  if args.runner:
+    h = bytes([0x04, 0x01, 0x00])
+    measure = lambda bit: bytes([0x30, 0x81, 0x00]) + struct.pack("<I", bit)
+    if_eq = lambda bit: bytes([0x81, 0x80]) + struct.pack("<I", bit) + bytes([1])
+    endif = bytes([0x8F, 0x00])
+    cases = (("measure_top", [h, measure(0xFFFFFFFE)], "classical bits"),
+             ("measure_2g", [h, measure(0x7FFFFFF0)], "classical bits"),
+             ("if_top", [h, measure(0), if_eq(0xFFFFFFF0), h, endif], "classical bits"),
+             ("measure_no_qubit", [h, bytes([0x30, 0x80]) + struct.pack("<I", 0)], "Qubit operand out of range"))
+    for name, records, want in cases:
+      path = os.path.join(work, name + ".qbin")
+      with open(path, "wb") as f:
+        f.write(inst_only(records))
+      rc, so, se = run([args.decompiler, path])
+      if rc != 0:
+        sys.stderr.write("{}: decoder rejected the file (rc={}):\n{}\n".format(name, rc, se))
+        return 2
+      rc, so, se = run([args.runner, path, "--shots", "4"])
+      if rc != 1 or want not in se:
+        sys.stderr.write("{}: expected qbin-run to fail with '{}', got rc={}:\n{}\n".format(name, want, rc, se))
+        return 2
+
+  shutil.rmtree(work, ignore_errors=True)
+  print("OK -", os.path.basename(args.qasm))
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,125 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shutil, glob, struct
+
+def run(cmd, cwd=None):
+  p = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+  return p.returncode, p.stdout, p.stderr
+
+def read(path):
+  with open(path, "rb") as f:
+    return f.read()
+
+def main():
+  ap = argparse.ArgumentParser(description="qbin-bundle tester (pack -> list/unpack/get/verify must return the packed bytes)")
+  ap.add_argument("--bundle-tool", required=True, help="path to qbin-bundle")
+  ap.add_argument("--compiler", required=True, help="path to qbin-compile")
+  ap.add_argument("--decompiler", required=True, help="path to qbin-decompile")
+  ap.add_argument("--vectors", required=True, help="directory of .qasm files")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  args = ap.parse_args()
+
+  work = os.path.abspath(args.workdir)
+  shutil.rmtree(work, ignore_errors=True)
+  src_dir = os.path.join(work, "in")
+  qasm_files = sorted(glob.glob(os.path.join(args.vectors, "*.qasm")))
+  if not qasm_files:
+    sys.stderr.write("No .qasm files in {}\n".format(args.vectors))
+    return 1
+
+  # name -> bytes; one image twice under different names (stored once)
+  expected = {}
+  for sub, flags in (("plain", []), ("delta", ["--delta-operands", "-g"])):
+    os.makedirs(os.path.join(src_dir, sub))
+    for path in qasm_files:
+      name = "{}/{}.qbin".format(sub, os.path.splitext(os.path.basename(path))[0])
+      out = os.path.join(src_dir, name)
+      rc, so, se = run([args.compiler, path, "-o", out, "--no-cache"] + flags)
+      if rc != 0:
+        sys.stderr.write("qbin-compile failed on {} (rc={}):\n{}\n".format(path, rc, se.decode()))
+        return 1
+      expected[name] = read(out)
+  first = sorted(expected)[0]
+  shutil.copyfile(os.path.join(src_dir, first), os.path.join(src_dir, "copy.qbin"))
+  expected["copy.qbin"] = expected[first]
+
+  bundle = os.path.join(work, "all.qbnd")
+  rc, so, se = run([args.bundle_tool, "pack", "-o", bundle, src_dir, "--verbose"])
+  if rc != 0:
+    sys.stderr.write("pack failed (rc={}):\n{}\n".format(rc, se.decode()))
+    return 1
+  stored = len(set(expected.values()))
+  if "images:  {} ({} stored)".format(len(expected), stored) not in se.decode():
+    sys.stderr.write("unexpected pack stats (want {} images, {} stored):\n{}\n".format(len(expected), stored, se.decode()))
+    return 2
+
+  rc, so, se = run([args.bundle_tool, "list", bundle])
+  listed = {}
+  for line in so.decode().splitlines():
+    size, chash, name = line.split(None, 2)
+    listed[name] = int(size)
+  if rc != 0 or listed != {n: len(b) for n, b in expected.items()}:
+    sys.stderr.write("list does not match the packed files (rc={}):\n{}{}\n".format(rc, so.decode(), se.decode()))
+    return 2
+
+  unpacked = os.path.join(work, "out")
+  rc, so, se = run([args.bundle_tool, "unpack", bundle, "-o", unpacked])
+  if rc != 0:
+    sys.stderr.write("unpack failed (rc={}):\n{}\n".format(rc, se.decode()))
+    return 1
+  for name, data in sorted(expected.items()):
+    if read(os.path.join(unpacked, name)) != data:
+      sys.stderr.write("unpacked {} differs from the packed file\n".format(name))
+      return 2
+    got = os.path.join(work, "get.qbin")
+    rc, so, se = run([args.bundle_tool, "get", bundle, name, "-o", got])
+    if rc != 0 or read(got) != data:
+      sys.stderr.write("get {} failed or differs (rc={}):\n{}\n".format(name, rc, se.decode()))
+      return 2
+
+  # get to stdout feeds the decompiler like the original file
+  rc, so, se = run([args.bundle_tool, "get", bundle, first])
+  if rc != 0 or so != expected[first]:
+    sys.stderr.write("get {} to stdout differs (rc={}):\n{}\n".format(first, rc, se.decode()))
+    return 2
+  rc, so, se = run([args.bundle_tool, "get", bundle, "plain/missing.qbin"])
+  if rc == 0 or b"not found" not in se:
+    sys.stderr.write("get of a missing name did not fail:\n{}\n".format(se.decode()))
+    return 2
+
+  rc, so, se = run([args.bundle_tool, "verify", bundle])
+  if rc != 0 or "{} images OK".format(len(expected)) not in so.decode():
+    sys.stderr.write("verify failed (rc={}):\n{}{}\n".format(rc, so.decode(), se.decode()))
+    return 1
+
+  # Single files are stored under their file name
+  single = os.path.join(work, "single.qbnd")
+  rc, so, se = run([args.bundle_tool, "pack", "-o", single, os.path.join(src_dir, first), os.path.join(src_dir, "copy.qbin")])
+  rc2, so2, se2 = run([args.bundle_tool, "get", single, os.path.basename(first), "-o", os.path.join(work, "single.qbin")])
+  if rc != 0 or rc2 != 0 or read(os.path.join(work, "single.qbin")) != expected[first]:
+    sys.stderr.write("single-file pack failed (rc={}, {}):\n{}{}\n".format(rc, rc2, se.decode(), se2.decode()))
+    return 2
+  rc, so, se = run([args.bundle_tool, "pack", "-o", single, os.path.join(src_dir, first), os.path.join(src_dir, "plain", os.path.basename(first))])
+  if rc == 0 or b"duplicate image name" not in se:
+    sys.stderr.write("duplicate names were not rejected:\n{}\n".format(se.decode()))
+    return 2
+
+  # Damage: header (CRC) and the first stored image (content hash)
+  data = bytearray(read(bundle))
+  images_off = struct.unpack_from("<I", data, 0x14)[0]
+  for off, what, msg in ((0x08, "header", b"CRC"), (images_off, "image", b"content hash")):
+    bad = bytearray(data)
+    bad[off] ^= 0x01
+    bad_path = os.path.join(work, "bad.qbnd")
+    with open(bad_path, "wb") as f:
+      f.write(bad)
+    rc, so, se = run([args.bundle_tool, "verify", bad_path])
+    if rc == 0 or msg not in se:
+      sys.stderr.write("damaged {} was not reported (rc={}):\n{}\n".format(what, rc, se.decode()))
+      return 2
+
+  shutil.rmtree(work, ignore_errors=True)
+  print("OK - {} images ({} stored)".format(len(expected), stored))
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,46 @@
+OPENQASM 3.0;
+qubit[4] q;
+bit[4] c;
+
+ry(0.5) q[0];
+rz(0.5) q[0];
+ry(-1.25) q[1];
+rz(0.125) q[1];
+ry(0.125) q[2];
+rz(-1.25) q[2];
+ry(0.5) q[3];
+rz(0.5) q[3];
+cx q[0], q[1];
+cx q[1], q[2];
+cx q[2], q[3];
+rx(2.75) q[0];
+ry(-1.25) q[0];
+rz(-1.25) q[0];
+ry(0.125) q[1];
+rz(0.5) q[1];
+ry(0.5) q[2];
+rz(0.125) q[2];
+ry(-1.25) q[3];
+rz(-1.25) q[3];
+cx q[0], q[1];
+cx q[1], q[2];
+cx q[2], q[3];
+rx(2.75) q[1];
+ry(0.125) q[0];
+rz(0.125) q[0];
+ry(0.5) q[1];
+rz(-1.25) q[1];
+ry(-1.25) q[2];
+rz(0.5) q[2];
+ry(0.125) q[3];
+rz(0.125) q[3];
+cx q[0], q[1];
+cx q[1], q[2];
+cx q[2], q[3];
+rx(2.75) q[2];
+c[0] = measure q[0];
+c[1] = measure q[1];
+c[2] = measure q[2];
+c[3] = measure q[3];
+if (c[0] == 1) { rz(0.5) q[1]; }
+
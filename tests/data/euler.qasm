@@ -0,0 +1,16 @@
+OPENQASM 3.0;
+qubit[3] q;
+bit[3] c;
+
+u(0.5, -1.25, 2.75) q[0];
+u(1.5, 0, -3) q[1];
+h q[2];
+cu(0.75, 0.125, -0.5) q[0], q[1];
+cx q[1], q[2];
+u(-2.25, 3, 0.25) q[2];
+cu(-3.125, -1.5, 1.75) q[2], q[0];
+c[0] = measure q[0];
+if (c[0] == 1) { u(3.125, 0, 3.125) q[1]; }
+c[1] = measure q[1];
+c[2] = measure q[2];
+
@@ -0,0 +1,65 @@
+OPENQASM 3.0;
+qubit[6] q;
+bit[6] c;
+
+h q[0];
+h q[1];
+h q[2];
+h q[3];
+h q[4];
+h q[5];
+cx q[0], q[1];
+rz(0.75) q[1];
+cx q[0], q[1];
+cx q[1], q[2];
+rz(0.75) q[2];
+cx q[1], q[2];
+cx q[2], q[3];
+rz(0.75) q[3];
+cx q[2], q[3];
+cx q[3], q[4];
+rz(0.75) q[4];
+cx q[3], q[4];
+cx q[4], q[5];
+rz(0.75) q[5];
+cx q[4], q[5];
+cx q[5], q[0];
+rz(0.75) q[0];
+cx q[5], q[0];
+rx(0.375) q[0];
+rx(0.375) q[1];
+rx(0.375) q[2];
+rx(0.375) q[3];
+rx(0.375) q[4];
+rx(0.375) q[5];
+cx q[0], q[1];
+rz(1.5) q[1];
+cx q[0], q[1];
+cx q[1], q[2];
+rz(1.5) q[2];
+cx q[1], q[2];
+cx q[2], q[3];
+rz(1.5) q[3];
+cx q[2], q[3];
+cx q[3], q[4];
+rz(1.5) q[4];
+cx q[3], q[4];
+cx q[4], q[5];
+rz(1.5) q[5];
+cx q[4], q[5];
+cx q[5], q[0];
+rz(1.5) q[0];
+cx q[5], q[0];
+rx(-0.625) q[0];
+rx(-0.625) q[1];
+rx(-0.625) q[2];
+rx(-0.625) q[3];
+rx(-0.625) q[4];
+rx(-0.625) q[5];
+c[0] = measure q[0];
+c[1] = measure q[1];
+c[2] = measure q[2];
+c[3] = measure q[3];
+c[4] = measure q[4];
+c[5] = measure q[5];
+
@@ -0,0 +1,21 @@
+OPENQASM 3.0;
+qubit[2] anc;
+qubit[3] data;
+bit[3] syn;
+bit[2] out;
+
+h data[0];
+cx data[0], data[1];
+cx data[1], data[2];
+cx data[0], anc[0];
+cx data[1], anc[0];
+cx data[1], anc[1];
+cx data[2], anc[1];
+rz(0.25) data[2];
+syn[0] = measure anc[0];
+syn[1] = measure anc[1];
+if (syn[0] == 1) { x data[0]; }
+if (syn[1] != 0) { x data[2]; }
+out[0] = measure data[0];
+out[1] = measure data[2];
+
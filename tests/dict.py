@@ -0,0 +1,68 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shutil, difflib, pathlib
+
+def run(cmd, cwd=None):
+  p = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+  return p.returncode, p.stdout, p.stderr
+
+def main():
+  ap = argparse.ArgumentParser(description="QBIN dictionary tester (corpus -> qbin-dict -> compile --dict -> QASM)")
+  ap.add_argument("--compiler", required=True, help="path to qbin-compile")
+  ap.add_argument("--decompiler", required=True, help="path to qbin-decompile")
+  ap.add_argument("--dict-tool", required=True, help="path to qbin-dict")
+  ap.add_argument("--corpus", action="append", required=True, help="directory of .qasm files to train on (repeatable)")
+  ap.add_argument("--vectors", required=True, help="directory of .qasm files that must round-trip exactly")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  ap.add_argument("--compiler-arg", action="append", default=[], help="extra argument for the compiler (repeatable, use --compiler-arg=-O1)")
+  args = ap.parse_args()
+
+  work = os.path.abspath(args.workdir)
+  shutil.rmtree(work, ignore_errors=True)
+  os.makedirs(os.path.join(work, "corpus"))
+  training = [src for d in args.corpus for src in sorted(pathlib.Path(d).glob("*.qasm"))]
+  sources = sorted(pathlib.Path(args.vectors).glob("*.qasm"))
+  if not sources or not training:
+    sys.stderr.write("No .qasm files in {} / {}\n".format(args.vectors, ", ".join(args.corpus)))
+    return 1
+
+  # Training corpus: every file compiled with the flags under test
+  for k, src in enumerate(training):
+    qbin = os.path.join(work, "corpus", "{}_{}.qbin".format(k, src.stem))
+    rc, so, se = run([args.compiler, str(src), "-o", qbin] + args.compiler_arg, cwd=work)
+    if rc != 0:
+      sys.stderr.write("Compiler failed on {} (rc={}):\n{}\n{}\n".format(src.name, rc, so, se))
+      return 1
+  dict_path = os.path.join(work, "corpus.dict")
+  rc, so, se = run([args.dict_tool, "train", "-o", dict_path, "--size", "2048", os.path.join(work, "corpus")], cwd=work)
+  if rc != 0:
+    sys.stderr.write("qbin-dict failed (rc={}):\n{}\n{}\n".format(rc, so, se))
+    return 1
+  train_log = so
+
+  # Each source through the shared and the embedded dictionary
+  for src in sources:
+    for mode, extra in (("shared", []), ("embedded", ["--embed-dict"])):
+      qbin = os.path.join(work, "{}.{}.qbin".format(src.stem, mode))
+      qasm_out = os.path.join(work, "{}.{}.qasm".format(src.stem, mode))
+      rc, so, se = run([args.compiler, str(src), "-o", qbin, "--dict", dict_path] + extra + args.compiler_arg, cwd=work)
+      if rc != 0:
+        sys.stderr.write("Compiler failed on {} ({}, rc={}):\n{}\n{}\n".format(src.name, mode, rc, so, se))
+        return 1
+      rc, so, se = run([args.decompiler, qbin, "-o", qasm_out, "--dict", dict_path], cwd=work)
+      if rc != 0:
+        sys.stderr.write("Decompiler failed on {} ({}, rc={}):\n{}\n{}\n".format(src.name, mode, rc, so, se))
+        return 1
+      expected = src.read_text(encoding="utf-8")
+      got = pathlib.Path(qasm_out).read_text(encoding="utf-8")
+      if got != expected:
+        diff = "\n".join(difflib.unified_diff(expected.splitlines(), got.splitlines(), fromfile="input", tofile="decompiled", lineterm=""))
+        sys.stderr.write("Mismatch on {} ({}):\n{}\n".format(src.name, mode, diff))
+        return 2
+      print("OK - {} ({}, {} bytes)".format(src.name, mode, os.path.getsize(qbin)))
+
+  print(train_log, end="")
+  shutil.rmtree(work, ignore_errors=True)
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
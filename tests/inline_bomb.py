@@ -0,0 +1,89 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shutil, struct
+
+def run(cmd):
+  try:
+    p = subprocess.run(cmd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True, timeout=60)
+  except subprocess.TimeoutExpired:
+    return None, "", "timed out"
+  return p.returncode, p.stdout, p.stderr
+
+def uleb(n):
+  out = bytearray()
+  while True:
+    b = n & 0x7F
+    n >>= 7
+    if n:
+      out.append(b | 0x80)
+    else:
+      out.append(b)
+      return bytes(out)
+
+def inst(records):
+  return b"INST" + uleb(len(records)) + b"".join(records)
+
+def callg(gate, qubit=0):
+  # opcode CALLG, mask a | param_ref
+  return bytes([0x40, 0x41]) + uleb(qubit) + uleb(gate)
+
+def qbin_file(sections):
+  # Header (no CRC check on read), table at 24, payloads 8-aligned
+  count = len(sections)
+  pos = 24 + 16 * count
+  table, body = b"", b""
+  for tag, payload in sections:
+    pad = (-pos) % 8
+    body += b"\0" * pad
+    pos += pad
+    table += struct.pack("<4sIII", tag, pos, len(payload), 0)
+    body += payload
+    pos += len(payload)
+  header = b"QBIN" + bytes([1, 0, 0, 24]) + struct.pack("<III", count, 24, 16 * count) + b"\0" * 4
+  return header + table + body
+
+def main():
+  ap = argparse.ArgumentParser(description="CALLG inlining bomb: a small file whose nested GATE bodies expand "
+                               "to ~fanout^depth instructions must be rejected, not expanded")
+  ap.add_argument("--decompiler", required=True, help="path to qbin-decompile")
+  ap.add_argument("--runner", help="path to qbin-run (optional)")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  ap.add_argument("--fanout", type=int, default=200)
+  args = ap.parse_args()
+
+  work = os.path.abspath(args.workdir)
+  shutil.rmtree(work, ignore_errors=True)
+  os.makedirs(work)
+
+  # gate 0 = x; gate k = fanout calls of gate k-1 (nesting depth 8, the limit)
+  gates = [inst([bytes([0x01, 0x01, 0x00])])]
+  for k in range(1, 9):
+    gates.append(inst([callg(k - 1)] * args.fanout))
+  gate = b"GATE" + uleb(len(gates))
+  for body in gates:
+    gate += uleb(0) + uleb(1) + uleb(0) + bytes([2]) + uleb(len(body)) + body
+  path = os.path.join(work, "bomb.qbin")
+  with open(path, "wb") as f:
+    f.write(qbin_file([(b"GATE", gate), (b"INST", inst([callg(len(gates) - 1)]))]))
+  size = os.path.getsize(path)
+
+  # The gate table itself is valid: printed as definitions it decompiles
+  rc, so, se = run([args.decompiler, path, "--gate-defs"])
+  if rc != 0:
+    sys.stderr.write("--gate-defs failed on the bomb file (rc={}):\n{}\n".format(rc, se))
+    return 1
+
+  tools = [("qbin-decompile", [args.decompiler, path])]
+  if args.runner:
+    tools.append(("qbin-run", [args.runner, path, "--shots", "1"]))
+  for name, cmd in tools:
+    rc, so, se = run(cmd)
+    if rc in (None, 0) or "CALLG expansion exceeds" not in se:
+      sys.stderr.write("{}: expected the expansion to be rejected, got rc={}:\n{}\n".format(name, rc, se[-2000:]))
+      return 2
+
+  shutil.rmtree(work, ignore_errors=True)
+  print("OK - {} byte file, {}^8 instructions rejected".format(size, args.fanout))
+  return 0
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,74 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shlex, shutil, difflib, pathlib, struct
+
+def run(cmd, cwd=None):
+  p = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+  return p.returncode, p.stdout, p.stderr
+
+def section_tags(path):
+  data = pathlib.Path(path).read_bytes()
+  count, table_off = struct.unpack_from("<II", data, 8)
+  return [data[table_off + 16 * k:table_off + 16 * k + 4] for k in range(count)]
+
+def main():
+  ap = argparse.ArgumentParser(description="QBIN link tester (QASM parts -> QBIN -> qbin-link -> QASM)")
+  ap.add_argument("--compiler", required=True, help="path to qbin-compile")
+  ap.add_argument("--linker", required=True, help="path to qbin-link")
+  ap.add_argument("--decompiler", required=True, help="path to qbin-decompile")
+  ap.add_argument("--link", required=True, help=".link file: one '<part.qasm> [qbin-link options]' per line")
+  ap.add_argument("--expected", required=True, help="expected decompiled .qasm of the linked program")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  ap.add_argument("--compiler-arg", action="append", default=[], help="extra argument for the compiler (repeatable, use --compiler-arg=-O1)")
+  ap.add_argument("--linker-arg", action="append", default=[], help="extra argument for qbin-link (repeatable)")
+  args = ap.parse_args()
+
+  work = os.path.abspath(args.workdir)
+  os.makedirs(work, exist_ok=True)
+  base = os.path.dirname(os.path.abspath(args.link))
+  link_cmd = [args.linker, "-o", os.path.join(work, "linked.qbin")] + args.linker_arg
+  compiled = {}
+  for line in pathlib.Path(args.link).read_text(encoding="utf-8").splitlines():
+    fields = shlex.split(line, comments=True)
+    if not fields:
+      continue
+    part = fields[0]
+    if part not in compiled:
+      qbin = os.path.join(work, "part{}.qbin".format(len(compiled)))
+      rc, so, se = run([args.compiler, os.path.join(base, part), "-o", qbin] + args.compiler_arg, cwd=work)
+      if rc != 0:
+        sys.stderr.write("Compiler failed on {} (rc={}):\n{}\n{}\n".format(part, rc, so, se))
+        return 1
+      compiled[part] = qbin
+    link_cmd += fields[1:] + [compiled[part]]
+
+  rc, so, se = run(link_cmd + ["--verbose"], cwd=work)
+  if rc != 0:
+    sys.stderr.write("Linker failed (rc={}):\n{}\n{}\n".format(rc, so, se))
+    return 1
+  link_log = se
+
+  # The compiler names no PARS/GATE entries and the linker drops register
+  # aliases, so no string is referenced and STRS must be left out
+  if b"STRS" in section_tags(os.path.join(work, "linked.qbin")):
+    sys.stderr.write("Linked output carries an unreferenced STRS section:\n{}".format(link_log))
+    return 3
+
+  qasm_out = os.path.join(work, "linked.qasm")
+  rc, so, se = run([args.decompiler, os.path.join(work, "linked.qbin"), "-o", qasm_out], cwd=work)
+  if rc != 0:
+    sys.stderr.write("Decompiler failed on the linked output (rc={}):\n{}\n{}\n".format(rc, so, se))
+    return 1
+
+  expected = pathlib.Path(args.expected).read_text(encoding="utf-8")
+  got = pathlib.Path(qasm_out).read_text(encoding="utf-8")
+  if got == expected:
+    shutil.rmtree(work, ignore_errors=True)
+    print("OK -", os.path.basename(args.link))
+    print(link_log, end="")
+    return 0
+  diff = "\n".join(difflib.unified_diff(expected.splitlines(), got.splitlines(), fromfile="expected", tofile="linked", lineterm=""))
+  sys.stderr.write("Linked program differs:\n{}\n{}".format(diff, link_log))
+  return 2
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,24 @@
+OPENQASM 3.0;
+qubit[2] q;
+bit[2] c;
+
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
@@ -0,0 +1,23 @@
+OPENQASM 3.0;
+qubit[2] q;
+bit[2] c;
+
+rx(0.5) q[0];
+ry(0.5) q[1];
+rz(0.5) q[0];
+rz(0.5) q[0];
+ry(0.5) q[1];
+rz(0.5) q[0];
+rx(0.5) q[1];
+rz(0.5) q[1];
+ry(0.5) q[0];
+rx(0.5) q[0];
+rz(0.5) q[1];
+rz(0.5) q[0];
+rz(0.5) q[0];
+rx(0.5) q[0];
+ry(0.5) q[0];
+ry(0.5) q[1];
+c[0] = measure q[0];
+if (c[0] == 1) { x q[1]; }
+c[1] = measure q[1];
@@ -0,0 +1,83 @@
+OPENQASM 3.0;
+qubit[4] q;
+bit[4] c;
+
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
+h q[0];
+ry(0.25) q[1];
+cx q[0], q[1];
+rz(0.5) q[1];
+cx q[0], q[1];
+h q[2];
+ry(0.25) q[3];
+cx q[2], q[3];
+rz(0.5) q[3];
+cx q[2], q[3];
+h q[2];
+ry(0.25) q[3];
+cx q[2], q[3];
+rz(0.5) q[3];
+cx q[2], q[3];
+h q[2];
+ry(0.25) q[3];
+cx q[2], q[3];
+rz(0.5) q[3];
+cx q[2], q[3];
+h q[2];
+ry(0.25) q[3];
+cx q[2], q[3];
+rz(0.5) q[3];
+cx q[2], q[3];
+rx(0.5) q[0];
+ry(0.5) q[1];
+rz(0.5) q[0];
+rz(0.5) q[0];
+ry(0.5) q[1];
+rz(0.5) q[0];
+rx(0.5) q[1];
+rz(0.5) q[1];
+ry(0.5) q[0];
+rx(0.5) q[0];
+rz(0.5) q[1];
+rz(0.5) q[0];
+rz(0.5) q[0];
+rx(0.5) q[0];
+ry(0.5) q[0];
+ry(0.5) q[1];
+c[0] = measure q[0];
+if (c[0] == 1) { x q[1]; }
+c[1] = measure q[1];
+rx(0.5) q[2];
+ry(0.5) q[3];
+rz(0.5) q[2];
+rz(0.5) q[2];
+ry(0.5) q[3];
+rz(0.5) q[2];
+rx(0.5) q[3];
+rz(0.5) q[3];
+ry(0.5) q[2];
+rx(0.5) q[2];
+rz(0.5) q[3];
+rz(0.5) q[2];
+rz(0.5) q[2];
+rx(0.5) q[2];
+ry(0.5) q[2];
+ry(0.5) q[3];
+c[2] = measure q[2];
+if (c[2] == 1) { x q[3]; }
+c[3] = measure q[3];
+
@@ -0,0 +1,33 @@
+OPENQASM 3.0;
+qubit[10] q;
+bit[10] c;
+
+h q[2];
+cx q[2], q[3];
+cx q[3], q[4];
+cx q[2], q[0];
+cx q[3], q[0];
+cx q[3], q[1];
+cx q[4], q[1];
+rz(0.25) q[4];
+c[0] = measure q[0];
+c[1] = measure q[1];
+if (c[0] == 1) { x q[2]; }
+if (c[1] != 0) { x q[4]; }
+c[3] = measure q[2];
+c[4] = measure q[4];
+h q[7];
+cx q[7], q[8];
+cx q[8], q[9];
+cx q[7], q[5];
+cx q[8], q[5];
+cx q[8], q[6];
+cx q[9], q[6];
+rz(0.25) q[9];
+c[5] = measure q[5];
+c[6] = measure q[6];
+if (c[5] == 1) { x q[7]; }
+if (c[6] != 0) { x q[9]; }
+c[8] = measure q[7];
+c[9] = measure q[9];
+
@@ -0,0 +1,15 @@
+OPENQASM 3.0;
+qubit[3] q;
+bit[2] c;
+
+x q[1];
+rz(0.875) q[0];
+t q[0];
+c[0] = measure q[0];
+h q[0];
+if (c[0] == 1) { x q[1]; }
+x q[1];
+z q[2];
+c[1] = measure q[2];
+z q[2];
+
@@ -0,0 +1,30 @@
+OPENQASM 3.0;
+qubit[3] q;
+bit[2] c;
+
+h q[0];
+h q[0];
+x q[1];
+cx q[0], q[1];
+cx q[0], q[1];
+rz(0.25) q[0];
+t q[0];
+rz(0.5) q[0];
+cx q[0], q[2];
+rz(0.125) q[0];
+cx q[0], q[2];
+s q[2];
+sdg q[2];
+rx(0) q[1];
+ry(0.5) q[1];
+ry(-0.5) q[1];
+swap q[1], q[2];
+swap q[2], q[1];
+c[0] = measure q[0];
+h q[0];
+if (c[0] == 1) { x q[1]; }
+x q[1];
+if (c[0] == 0) { rz(0) q[2]; }
+z q[2];
+c[1] = measure q[2];
+z q[2];
@@ -0,0 +1,20 @@
+OPENQASM 3.0;
+qubit[3] q;
+bit[3] c;
+
+u(1.57079637, 2.3561945, 3.1415925) q[0];
+u(1.32079637, 0, -1.57079637) q[1];
+cx q[0], q[1];
+phase(2.28539824) q[2];
+u(1.00146186, -0.570644617, 1.87427068) q[0];
+phase(-3.1415925) q[1];
+cu(0.5, 0.25, -0.75) q[2], q[1];
+rx(0.5) q[1];
+c[0] = measure q[0];
+h q[0];
+if (c[0] == 1) { x q[0]; }
+h q[0];
+c[1] = measure q[1];
+rz(0.5) q[2];
+c[2] = measure q[2];
+
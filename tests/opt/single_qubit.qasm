@@ -0,0 +1,30 @@
+OPENQASM 3.0;
+qubit[3] q;
+bit[3] c;
+
+h q[0];
+t q[0];
+h q[1];
+s q[0];
+rz(0.25) q[1];
+sx q[1];
+cx q[0], q[1];
+x q[2];
+y q[2];
+z q[2];
+u(0.5, -1.25, 2.75) q[0];
+ry(0.75) q[0];
+h q[1];
+x q[1];
+h q[1];
+t q[2];
+rz(1.5) q[2];
+cu(0.5, 0.25, -0.75) q[2], q[1];
+rx(0.5) q[1];
+c[0] = measure q[0];
+h q[0];
+if (c[0] == 1) { x q[0]; }
+h q[0];
+c[1] = measure q[1];
+rz(0.5) q[2];
+c[2] = measure q[2];
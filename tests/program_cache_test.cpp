@@ -0,0 +1,167 @@
+// program_cache_test.cpp - ProgramCache: hits, stale files, eviction and
+// single-flight decoding under concurrent misses
+//
+// Usage: program_cache_test <workdir>
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_decompiler/program_cache.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace fs = std::filesystem;
+using qbin_decompiler::ProgramCache;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); ++failures; } } while (0)
+
+// `layers` layers of H + CX ladder on `qubits` qubits
+static std::vector<uint8_t> make_program(int qubits, int layers) {
+    std::ostringstream q;
+    q << "OPENQASM 3.0;\nqubit[" << qubits << "] q;\n\n";
+    for (int l = 0; l < layers; ++l) {
+        for (int i = 0; i < qubits; ++i) q << "h q[" << i << "];\n";
+        for (int i = 0; i + 1 < qubits; ++i) q << "cx q[" << i << "], q[" << i + 1 << "];\n";
+    }
+    return qbin_compiler::compile_qasm_to_qbin(q.str(), qbin_compiler::CompileOptions{});
+}
+
+static size_t instr_count(int qubits, int layers) {
+    return size_t(layers) * size_t(2 * qubits - 1);
+}
+
+static void write_file(const fs::path& path, const std::vector<uint8_t>& bytes) {
+    std::ofstream ofs(path, std::ios::binary | std::ios::trunc);
+    ofs.write(reinterpret_cast<const char*>(bytes.data()), std::streamsize(bytes.size()));
+}
+
+static void test_hit(const fs::path& dir) {
+    const std::string path = (dir / "hit.qbin").string();
+    write_file(path, make_program(4, 3));
+    ProgramCache cache;
+    std::string err;
+    ProgramCache::Handle a = cache.get_file(path, err);
+    ProgramCache::Handle b = cache.get_file(path, err);
+    CHECK(a && b);
+    CHECK(a == b);
+    CHECK(a && a->instrs.size() == instr_count(4, 3));
+    const auto st = cache.stats();
+    CHECK(st.misses == 1);
+    CHECK(st.hits == 1);
+    CHECK(st.entries == 1);
+
+    CHECK(!cache.get_file((dir / "missing.qbin").string(), err));
+    CHECK(!err.empty());
+}
+
+static void test_stale(const fs::path& dir) {
+    const fs::path path = dir / "stale.qbin";
+    write_file(path, make_program(4, 3));
+    ProgramCache cache;
+    std::string err;
+    ProgramCache::Handle old = cache.get_file(path.string(), err);
+    CHECK(old && old->instrs.size() == instr_count(4, 3));
+
+    // New content, new size and a later mtime (coarse clocks may not tick)
+    const auto mtime = fs::last_write_time(path);
+    write_file(path, make_program(5, 4));
+    fs::last_write_time(path, mtime + std::chrono::seconds(2));
+    ProgramCache::Handle fresh = cache.get_file(path.string(), err);
+    CHECK(fresh && fresh != old);
+    CHECK(fresh && fresh->instrs.size() == instr_count(5, 4));
+    // The replaced handle stays usable
+    CHECK(old->instrs.size() == instr_count(4, 3));
+    const auto st = cache.stats();
+    CHECK(st.misses == 2);
+    CHECK(st.hits == 0);
+    CHECK(st.entries == 1);
+    CHECK(cache.get_file(path.string(), err) == fresh);
+}
+
+static void test_eviction() {
+    const std::vector<uint8_t> prog = make_program(6, 10);
+    qbin_decompiler::DecodedProgram decoded;
+    std::string err;
+    CHECK(qbin_decompiler::decode_program(prog.data(), prog.size(), decoded, err));
+    decoded.instrs.shrink_to_fit();
+    const size_t one = ProgramCache::footprint(decoded) + 8;
+
+    // One shard holding two programs but not three
+    ProgramCache cache(one * 2 + one / 2, 1);
+    ProgramCache::Handle first = cache.get_buffer("prog-0", 1, prog.data(), prog.size(), err);
+    CHECK(first);
+    for (int k = 1; k < 4; ++k) {
+        CHECK(cache.get_buffer("prog-" + std::to_string(k), 1, prog.data(), prog.size(), err));
+    }
+    auto st = cache.stats();
+    CHECK(st.misses == 4);
+    CHECK(st.evictions == 2);
+    CHECK(st.entries == 2);
+    CHECK(st.bytes <= one * 2 + one / 2);
+
+    // prog-0 was least recently used: evicted, decoded again; its old
+    // handle is still valid
+    CHECK(cache.get_buffer("prog-0", 1, prog.data(), prog.size(), err) != first);
+    CHECK(first->instrs.size() == instr_count(6, 10));
+    st = cache.stats();
+    CHECK(st.misses == 5);
+    CHECK(st.hits == 0);
+    // prog-3 is among the two most recent entries and still cached
+    CHECK(cache.get_buffer("prog-3", 1, prog.data(), prog.size(), err));
+    CHECK(cache.stats().hits == 1);
+}
+
+static void test_single_flight(const fs::path& dir) {
+    const std::string path = (dir / "cold.qbin").string();
+    write_file(path, make_program(16, 400));
+    const int threads = 8;
+    ProgramCache cache;
+    std::atomic<int> ready{ 0 };
+    std::vector<ProgramCache::Handle> got(threads);
+    std::vector<std::thread> pool;
+    for (int t = 0; t < threads; ++t) {
+        pool.emplace_back([&, t] {
+            ++ready;
+            while (ready.load() < threads) std::this_thread::yield();
+            std::string err;
+            got[t] = cache.get_file(path, err);
+        });
+    }
+    for (auto& th : pool) th.join();
+    for (int t = 0; t < threads; ++t) {
+        CHECK(got[t] && got[t] == got[0]);
+    }
+    CHECK(got[0] && got[0]->instrs.size() == instr_count(16, 400));
+    const auto st = cache.stats();
+    CHECK(st.misses == 1);
+    CHECK(st.hits == uint64_t(threads - 1));
+    CHECK(st.failures == 0);
+    CHECK(st.entries == 1);
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { std::fprintf(stderr, "usage: %s <workdir>\n", argv[0]); return 1; }
+    const fs::path dir = argv[1];
+    fs::remove_all(dir);
+    fs::create_directories(dir);
+
+    test_hit(dir);
+    test_stale(dir);
+    test_eviction();
+    test_single_flight(dir);
+
+    if (failures) { std::fprintf(stderr, "%d check(s) failed\n", failures); return 1; }
+    fs::remove_all(dir);
+    std::printf("OK - program cache\n");
+    return 0;
+}
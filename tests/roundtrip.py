@@ -21,6 +21,9 @@ def main():
   ap.add_argument("--workdir", required=True, help="work directory for artifacts")
   ap.add_argument("--exact", action="store_true", help="require byte-for-byte equality")
   ap.add_argument("--keep", action="store_true", help="keep workdir on success")
+  ap.add_argument("--compiler-arg", action="append", default=[], help="extra argument for the compiler (repeatable, use --compiler-arg=-O1)")
+  ap.add_argument("--expected", help="expected decompiled .qasm (default: the input itself)")
+  ap.add_argument("--cache", action="store_true", help="compile twice through a fresh compile cache; the second run must hit and reproduce the first output")
   args = ap.parse_args()
 
   qasm_in = os.path.abspath(args.qasm)
@@ -30,11 +33,33 @@ def main():
   qasm_out = os.path.join(work, "out.qasm")
 
   # Compile
-  rc, so, se = run([args.compiler, qasm_in, "-o", qbin], cwd=work)
+  compile_cmd = [args.compiler, qasm_in, "-o", qbin] + args.compiler_arg
+  if args.cache:
+    cache_dir = os.path.join(work, "cache")
+    shutil.rmtree(cache_dir, ignore_errors=True)
+    compile_cmd += ["--cache-dir", cache_dir, "--verbose"]
+  rc, so, se = run(compile_cmd, cwd=work)
   if rc != 0:
     sys.stderr.write("Compiler failed (rc={}):\n{}\n{}\n".format(rc, so, se))
     return 1
 
+  if args.cache:
+    if "Cache miss" not in se:
+      sys.stderr.write("Expected a cache miss on the first compile:\n{}\n".format(se))
+      return 4
+    first = read_bytes(qbin)
+    os.remove(qbin)
+    rc, so, se = run(compile_cmd, cwd=work)
+    if rc != 0:
+      sys.stderr.write("Cached compile failed (rc={}):\n{}\n{}\n".format(rc, so, se))
+      return 1
+    if "Cache hit" not in se:
+      sys.stderr.write("Expected a cache hit on the second compile:\n{}\n".format(se))
+      return 4
+    if read_bytes(qbin) != first:
+      sys.stderr.write("Cached output differs from the compiled output\n")
+      return 4
+
   # Decompile
   rc, so, se = run([args.decompiler, qbin, "-o", qasm_out], cwd=work)
   if rc != 0:
@@ -42,6 +67,8 @@ def main():
     return 1
 
   # Compare
+  if args.expected:
+    qasm_in = os.path.abspath(args.expected)
   in_bytes = read_bytes(qasm_in)
   out_bytes = read_bytes(qasm_out)
 
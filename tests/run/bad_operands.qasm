@@ -0,0 +1,9 @@
+OPENQASM 3.0;
+qubit[2] q;
+bit[2] c;
+
+h q[0];
+  if (c[0] == 1) { x q[1]; }
+cx q[0], q[1];
+cx q[1], q[1];
+c[0] = measure q[0];
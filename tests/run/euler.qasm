@@ -0,0 +1,16 @@
+OPENQASM 3.0;
+qubit[4] q;
+bit[4] c;
+
+u(1.57079633, 0, 3.14159265) q[0];
+cu(3.14159265, 0, 3.14159265) q[0], q[1];
+u(3.14159265, 0, 3.14159265) q[2];
+h q[3];
+t q[3];
+h q[3];
+s q[1];
+sdg q[1];
+c[0] = measure q[0];
+c[1] = measure q[1];
+c[2] = measure q[2];
+c[3] = measure q[3];
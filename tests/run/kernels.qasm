@@ -0,0 +1,21 @@
+OPENQASM 3.0;
+qubit[4] q;
+bit[4] c;
+
+x q[0];
+cx q[0], q[3];
+x q[0];
+ry(3.14159274) q[2];
+swap q[2], q[0];
+h q[1];
+rz(3.14159274) q[1];
+h q[1];
+cz q[1], q[3];
+sx q[1];
+sx q[1];
+t q[3];
+tdg q[3];
+c[0] = measure q[0];
+c[1] = measure q[1];
+c[2] = measure q[2];
+c[3] = measure q[3];
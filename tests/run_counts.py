@@ -0,0 +1,56 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shutil, difflib, pathlib
+
+def run(cmd, cwd=None):
+  p = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE, text=True)
+  return p.returncode, p.stdout, p.stderr
+
+def main():
+  ap = argparse.ArgumentParser(description="QBIN execution tester (QASM -> QBIN -> qbin-run counts)")
+  ap.add_argument("--compiler", required=True, help="path to qbin-compile")
+  ap.add_argument("--runner", required=True, help="path to qbin-run")
+  ap.add_argument("--qasm", required=True, help="input .qasm file")
+  ap.add_argument("--expected", help="expected qbin-run output (<bits> <count> lines)")
+  ap.add_argument("--expected-error", help="file with the expected qbin-run error line (the run must fail)")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  ap.add_argument("--shots", default="1000")
+  ap.add_argument("--seed", default="7")
+  ap.add_argument("--runner-arg", action="append", default=[], help="extra argument for qbin-run (repeatable, use --runner-arg=--scalar)")
+  ap.add_argument("--compiler-arg", action="append", default=[], help="extra argument for the compiler (repeatable, use --compiler-arg=-g)")
+  args = ap.parse_args()
+  if bool(args.expected) == bool(args.expected_error):
+    ap.error("exactly one of --expected and --expected-error is required")
+
+  work = os.path.abspath(args.workdir)
+  os.makedirs(work, exist_ok=True)
+  qbin = os.path.join(work, "out.qbin")
+
+  rc, so, se = run([args.compiler, os.path.abspath(args.qasm), "-o", qbin] + args.compiler_arg, cwd=work)
+  if rc != 0:
+    sys.stderr.write("Compiler failed (rc={}):\n{}\n{}\n".format(rc, so, se))
+    return 1
+
+  rc, so, se = run([args.runner, qbin, "--shots", args.shots, "--seed", args.seed] + args.runner_arg, cwd=work)
+  if args.expected_error:
+    expected = pathlib.Path(args.expected_error).read_text(encoding="utf-8")
+    if rc != 0 and se == expected:
+      shutil.rmtree(work, ignore_errors=True)
+      print("OK -", os.path.basename(args.qasm), "-", se.strip())
+      return 0
+    sys.stderr.write("Expected qbin-run to fail with:\n{}got (rc={}):\n{}{}".format(expected, rc, so, se))
+    return 2
+  if rc != 0:
+    sys.stderr.write("Runner failed (rc={}):\n{}\n{}\n".format(rc, so, se))
+    return 1
+
+  expected = pathlib.Path(args.expected).read_text(encoding="utf-8")
+  if so == expected:
+    shutil.rmtree(work, ignore_errors=True)
+    print("OK -", os.path.basename(args.qasm))
+    return 0
+  diff = "\n".join(difflib.unified_diff(expected.splitlines(), so.splitlines(), fromfile="expected", tofile="qbin-run", lineterm=""))
+  sys.stderr.write("Counts differ:\n{}\n".format(diff))
+  return 2
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,159 @@
+#!/usr/bin/env python3
+import argparse, subprocess, sys, os, shutil, socket, struct, tempfile, time, glob
+
+def run(cmd, cwd=None):
+  p = subprocess.run(cmd, cwd=cwd, stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+  return p.returncode, p.stdout, p.stderr
+
+def read(path):
+  with open(path, "rb") as f:
+    return f.read()
+
+OP_COMPILE, OP_DECOMPILE, OP_STATS, OP_PING = 1, 2, 3, 4
+
+def request(op, rid, payload=b"", flags=0, opt_level=0):
+  return struct.pack("<IBBBBI", 8 + len(payload), op, flags, opt_level, 0, rid) + payload
+
+def recv_exact(s, n):
+  buf = b""
+  while len(buf) < n:
+    chunk = s.recv(n - len(buf))
+    if not chunk:
+      raise EOFError("server closed the connection")
+    buf += chunk
+  return buf
+
+def recv_response(s):
+  length, status, rid = struct.unpack("<IB3xI", recv_exact(s, 12))
+  return rid, status, recv_exact(s, length - 8)
+
+def main():
+  ap = argparse.ArgumentParser(description="qbin-serve tester (client outputs must match qbin-compile/qbin-decompile)")
+  ap.add_argument("--server", required=True, help="path to qbin-serve")
+  ap.add_argument("--compiler", required=True, help="path to qbin-compile")
+  ap.add_argument("--decompiler", required=True, help="path to qbin-decompile")
+  ap.add_argument("--vectors", required=True, help="directory of .qasm files")
+  ap.add_argument("--workdir", required=True, help="work directory for artifacts")
+  args = ap.parse_args()
+
+  work = os.path.abspath(args.workdir)
+  os.makedirs(work, exist_ok=True)
+  # sun_path is limited to ~108 bytes; build trees can be deeper than that
+  sockdir = tempfile.mkdtemp(prefix="qbin-serve-")
+  sock = os.path.join(sockdir, "s")
+  srv = subprocess.Popen([args.server, "--socket", sock, "--workers", "2"], stdout=subprocess.PIPE, stderr=subprocess.PIPE)
+  try:
+    client = [args.server, "--socket", sock, "--client"]
+    for _ in range(200):
+      if run(client + ["ping"])[0] == 0:
+        break
+      if srv.poll() is not None:
+        sys.stderr.write("qbin-serve exited early:\n{}\n".format(srv.stderr.read().decode()))
+        return 1
+      time.sleep(0.05)
+    else:
+      sys.stderr.write("qbin-serve did not answer ping\n")
+      return 1
+
+    qasm_files = sorted(glob.glob(os.path.join(args.vectors, "*.qasm")))
+    variants = [[], ["-O2"], ["--delta-operands", "-g"]]
+    for path in qasm_files:
+      name = os.path.splitext(os.path.basename(path))[0]
+      for k, flags in enumerate(variants):
+        ref = os.path.join(work, "{}.{}.ref.qbin".format(name, k))
+        got = os.path.join(work, "{}.{}.srv.qbin".format(name, k))
+        rc, so, se = run([args.compiler, path, "-o", ref, "--no-cache"] + flags)
+        if rc != 0:
+          sys.stderr.write("qbin-compile failed on {} (rc={}):\n{}\n".format(path, rc, se.decode()))
+          return 1
+        rc, so, se = run(client + ["compile", path, "-o", got] + flags)
+        if rc != 0:
+          sys.stderr.write("client compile failed on {} {} (rc={}):\n{}\n".format(path, flags, rc, se.decode()))
+          return 1
+        if read(ref) != read(got):
+          sys.stderr.write("server output differs from qbin-compile: {} {}\n".format(path, flags))
+          return 2
+        for extra in ([], ["--gate-defs"]):
+          ref_q = os.path.join(work, "{}.{}.ref.qasm".format(name, k))
+          got_q = os.path.join(work, "{}.{}.srv.qasm".format(name, k))
+          rc, so, se = run([args.decompiler, ref, "-o", ref_q] + extra)
+          if rc != 0:
+            sys.stderr.write("qbin-decompile failed on {}:\n{}\n".format(ref, se.decode()))
+            return 1
+          rc, so, se = run(client + ["decompile", got, "-o", got_q] + extra)
+          if rc != 0:
+            sys.stderr.write("client decompile failed on {} (rc={}):\n{}\n".format(got, rc, se.decode()))
+            return 1
+          if read(ref_q) != read(got_q):
+            sys.stderr.write("server decompile differs from qbin-decompile: {} {}\n".format(got, extra))
+            return 2
+
+    # Pipelining on one connection: all requests are sent before any response
+    # is read; responses may come back in any order and are matched by id.
+    s = socket.socket(socket.AF_UNIX, socket.SOCK_STREAM)
+    s.connect(sock)
+    sources = [read(p) for p in qasm_files] * 4
+    expected = {}
+    frames = []
+    for i, src in enumerate(sources):
+      rid = 100 + i
+      frames.append(request(OP_COMPILE, rid, src, opt_level=1))
+      ref = os.path.join(work, "pipe{}.qbin".format(i % len(qasm_files)))
+      if not os.path.exists(ref):
+        rc, so, se = run([args.compiler, qasm_files[i % len(qasm_files)], "-o", ref, "--no-cache", "-O1"])
+        if rc != 0:
+          sys.stderr.write("qbin-compile failed:\n{}\n".format(se.decode()))
+          return 1
+      expected[rid] = read(ref)
+    frames.append(request(OP_DECOMPILE, 1, b"not a qbin file"))
+    frames.append(request(OP_PING, 2))
+    s.sendall(b"".join(frames))
+    errors = 0
+    for _ in range(len(frames)):
+      rid, status, payload = recv_response(s)
+      if rid == 1:
+        if status != 1 or not payload:
+          sys.stderr.write("bad QBIN input did not produce an error response\n")
+          return 2
+        errors += 1
+      elif rid == 2:
+        if status != 0 or payload:
+          sys.stderr.write("bad ping response\n")
+          return 2
+      elif expected.pop(rid, None) != payload or status != 0:
+        sys.stderr.write("pipelined compile {} differs from qbin-compile\n".format(rid))
+        return 2
+    s.close()
+    if expected or errors != 1:
+      sys.stderr.write("missing responses: {}\n".format(sorted(expected)))
+      return 2
+
+    rc, so, se = run(client + ["stats"])
+    report = so.decode()
+    if rc != 0 or "compile" not in report or "p99" not in report:
+      sys.stderr.write("stats failed (rc={}):\n{}{}\n".format(rc, report, se.decode()))
+      return 1
+    rc, so, se = run(client + ["shutdown"])
+    if rc != 0:
+      sys.stderr.write("shutdown failed:\n{}\n".format(se.decode()))
+      return 1
+    try:
+      src = srv.wait(timeout=10)
+    except subprocess.TimeoutExpired:
+      sys.stderr.write("qbin-serve did not exit after shutdown\n")
+      return 1
+    if src != 0 or os.path.exists(sock):
+      sys.stderr.write("qbin-serve exit {} (socket left: {})\n".format(src, os.path.exists(sock)))
+      return 1
+    shutil.rmtree(work, ignore_errors=True)
+    print("OK - {} vectors".format(len(qasm_files)))
+    print(report, end="")
+    return 0
+  finally:
+    if srv.poll() is None:
+      srv.kill()
+      srv.wait()
+    shutil.rmtree(sockdir, ignore_errors=True)
+
+if __name__ == "__main__":
+  sys.exit(main())
@@ -0,0 +1,226 @@
+// writer_test.cpp - Writer output against compiling the equivalent QASM,
+// moved-from and reused Writers
+//
+// Usage: writer_test <workdir>
+
+#include "qbin_compiler/compiler.hpp"
+#include "qbin_compiler/writer.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <utility>
+#include <vector>
+
+using qbin_compiler::Writer;
+using qbin_compiler::frontend::Instr;
+using qbin_compiler::frontend::Opcode;
+
+static int failures = 0;
+
+#define CHECK(cond) \
+    do { if (!(cond)) { std::fprintf(stderr, "%s:%d: CHECK failed: %s\n", __FILE__, __LINE__, #cond); ++failures; } } while (0)
+
+// A program written twice: through the Writer and as QASM statements
+struct Both {
+    Writer w;
+    std::ostringstream q;
+    Both() { q.precision(9); }
+
+    // qasm_to_qbin of the statements after the declarations the Writer
+    // derives from its operands
+    std::vector<uint8_t> compiled() const {
+        std::ostringstream text;
+        text << "OPENQASM 3.0;\n";
+        if (w.num_qubits()) text << "qubit[" << w.num_qubits() << "] q;\n";
+        if (w.num_bits()) text << "bit[" << w.num_bits() << "] c;\n";
+        text << "\n" << q.str();
+        return qbin_compiler::compile_qasm_to_qbin_min(text.str(), false);
+    }
+};
+
+static bool decodes(const std::vector<uint8_t>& file, size_t instrs) {
+    qbin_decompiler::DecodedProgram prog;
+    std::string err;
+    if (!qbin_decompiler::decode_program(file.data(), file.size(), prog, err)) {
+        std::fprintf(stderr, "decode failed: %s\n", err.c_str());
+        return false;
+    }
+    return prog.instrs.size() == instrs;
+}
+
+// Every call that has QASM syntax in the frontend subset, `layers` times
+static void emit_layers(Both& p, int layers) {
+    for (int l = 0; l < layers; ++l) {
+        const uint32_t a = uint32_t(l % 5), b = uint32_t((l + 1) % 5);
+        const float th = 0.25f * float(l % 9) - 1.0f;
+        auto& q = p.q;
+        p.w.x(a).y(a).z(a).h(a).s(a).sdg(a).t(a).tdg(a).sx(a).sxdg(a);
+        q << "x q[" << a << "];\ny q[" << a << "];\nz q[" << a << "];\nh q[" << a << "];\n"
+          << "s q[" << a << "];\nsdg q[" << a << "];\nt q[" << a << "];\ntdg q[" << a << "];\n"
+          << "sx q[" << a << "];\nsxdg q[" << a << "];\n";
+        p.w.rx(th, a).ry(-th, b).rz(th * 2, a).phase(0.5f, b);
+        q << "rx(" << th << ") q[" << a << "];\nry(" << -th << ") q[" << b << "];\n"
+          << "rz(" << th * 2 << ") q[" << a << "];\nphase(0.5) q[" << b << "];\n";
+        p.w.u(th, 0.5f, -1.5f, b).cu(-0.75f, th, 2.0f, a, b);
+        q << "u(" << th << ", 0.5, -1.5) q[" << b << "];\ncu(-0.75, " << th << ", 2) q[" << a << "], q[" << b << "];\n";
+        p.w.cx(a, b).cz(b, a).swap(a, b);
+        q << "cx q[" << a << "], q[" << b << "];\ncz q[" << b << "], q[" << a << "];\nswap q[" << a << "], q[" << b << "];\n";
+
+        Instr I{};
+        I.op = Opcode::RZ;
+        I.a = int(b);
+        I.has_angle0 = true;
+        I.angle0 = th;
+        p.w.append(I);
+        q << "rz(" << th << ") q[" << b << "];\n";
+
+        const uint32_t bit = uint32_t(l % 3);
+        p.w.measure(a, bit);
+        q << "c[" << bit << "] = measure q[" << a << "];\n";
+        p.w.if_eq(bit, l % 2 != 0, [&](Writer& w) { w.x(b); });
+        q << "if (c[" << bit << "] == " << (l % 2) << ") { x q[" << b << "]; }\n";
+        p.w.if_neq(bit, true, [&](Writer& w) { w.cx(b, a); });
+        q << "if (c[" << bit << "] != 1) { cx q[" << b << "], q[" << a << "]; }\n";
+    }
+}
+
+static void test_qasm_identity() {
+    // 1 layer: one-byte instr_count; 8 layers: two bytes; 700: three bytes.
+    // The longer varints exercise the memmove in finish().
+    for (int layers : { 1, 8, 700 }) {
+        Both p;
+        emit_layers(p, layers);
+        const size_t count = p.w.instr_count();
+        const std::vector<uint8_t> expected = p.compiled();
+        const std::vector<uint8_t> got = p.w.finish();
+        CHECK(got == expected);
+        CHECK(decodes(got, count));
+        if (got != expected) std::fprintf(stderr, "  %d layers: %zu vs %zu bytes\n", layers, got.size(), expected.size());
+    }
+    CHECK(Writer().finish() == qbin_compiler::compile_qasm_to_qbin_min("OPENQASM 3.0;\n", false));
+}
+
+// Calls without QASM syntax in the frontend subset (ECR, CSX, CR*, R**,
+// RESET, BARRIER): the typed call must encode like append(), which uses the
+// compiler's encode_instr
+static void test_typed_matches_append() {
+    Writer typed, generic;
+    auto instr = [](Opcode op, int a, int b = -1, bool angle = false, float th = 0.0f) {
+        Instr I{};
+        I.op = op;
+        I.a = a;
+        I.b = b;
+        I.has_angle0 = angle;
+        I.angle0 = th;
+        return I;
+    };
+    for (int l = 0; l < 40; ++l) {
+        const uint32_t a = uint32_t(l % 4), b = uint32_t((l + 3) % 4 + 200);
+        const float th = 0.125f * float(l) - 2.0f;
+        typed.ecr(a, b).csx(b, a).crx(th, a, b).cry(-th, b, a).crz(th, a, b)
+            .rxx(th, a, b).ryy(th, b, a).rzz(-th, a, b).reset(b).barrier();
+        generic.append(instr(Opcode::ECR, int(a), int(b)))
+            .append(instr(Opcode::CSX, int(b), int(a)))
+            .append(instr(Opcode::CRX, int(a), int(b), true, th))
+            .append(instr(Opcode::CRY, int(b), int(a), true, -th))
+            .append(instr(Opcode::CRZ, int(a), int(b), true, th))
+            .append(instr(Opcode::RXX, int(a), int(b), true, th))
+            .append(instr(Opcode::RYY, int(b), int(a), true, th))
+            .append(instr(Opcode::RZZ, int(a), int(b), true, -th))
+            .append(instr(Opcode::RESET, int(b)))
+            .append(instr(Opcode::BARRIER, -1));
+    }
+    CHECK(typed.num_qubits() == 204);
+    CHECK(typed.num_qubits() == generic.num_qubits());
+    const size_t count = typed.instr_count();
+    const std::vector<uint8_t> t = typed.finish();
+    CHECK(t == generic.finish());
+    CHECK(decodes(t, count));
+}
+
+static void test_move_and_reuse() {
+    Both ref;
+    ref.w.h(0).cx(0, 1).measure(1, 0);
+    ref.q << "h q[0];\ncx q[0], q[1];\nc[0] = measure q[1];\n";
+    const std::vector<uint8_t> expected = ref.compiled();
+
+    // Move construction and assignment carry the program; the source is
+    // left empty and usable
+    Writer a;
+    a.h(0).cx(0, 1).measure(1, 0);
+    Writer b(std::move(a));
+    CHECK(a.instr_count() == 0 && a.num_qubits() == 0 && a.num_bits() == 0);
+    a.x(2);
+    Writer c;
+    c.z(7);
+    c = std::move(b);
+    CHECK(c.finish() == expected);
+    const std::vector<uint8_t> from_moved = a.finish();
+    CHECK(decodes(from_moved, 1));
+    CHECK(from_moved == qbin_compiler::compile_qasm_to_qbin_min("OPENQASM 3.0;\nqubit[3] q;\n\nx q[2];\n", false));
+    CHECK(decodes(b.finish(), 0));
+
+    // Reuse after finish(): nothing of the first program leaks into the second
+    Writer w;
+    for (int k = 0; k < 300; ++k) w.h(uint32_t(k % 9)).measure(uint32_t(k % 9), 5);
+    CHECK(decodes(w.finish(), 600));
+    CHECK(w.instr_count() == 0);
+    w.h(0).cx(0, 1).measure(1, 0);
+    const std::vector<uint8_t> second = w.finish();
+    CHECK(second == expected);
+    CHECK(decodes(second, 3));
+}
+
+// Indices above INT32_MAX throw and leave the Writer as it was
+static void test_index_range() {
+    auto throws = [](auto&& call) {
+        Writer w;
+        w.h(1);
+        bool thrown = false;
+        try { call(w); }
+        catch (const std::runtime_error&) { thrown = true; }
+        CHECK(thrown);
+        CHECK(w.instr_count() == 1 && w.num_qubits() == 2 && w.num_bits() == 0);
+        CHECK(w.finish() == qbin_compiler::compile_qasm_to_qbin_min("OPENQASM 3.0;\nqubit[2] q;\n\nh q[1];\n", false));
+    };
+    const uint32_t big = uint32_t(INT32_MAX) + 1u;
+    throws([](Writer& w) { w.x(UINT32_MAX); });
+    throws([&](Writer& w) { w.rz(0.5f, big); });
+    throws([&](Writer& w) { w.u(0.5f, 0.0f, 0.0f, big); });
+    throws([&](Writer& w) { w.cx(0, big); });
+    throws([&](Writer& w) { w.crz(0.5f, big, 0); });
+    throws([&](Writer& w) { w.cu(0.5f, 0.0f, 0.0f, 0, UINT32_MAX); });
+    throws([&](Writer& w) { w.reset(big); });
+    throws([&](Writer& w) { w.measure(big, 0); });
+    throws([](Writer& w) { w.measure(0, UINT32_MAX); });
+    throws([](Writer& w) { w.if_eq(UINT32_MAX, true, [](Writer&) {}); });
+    throws([&](Writer& w) { w.if_neq(big, false, [](Writer&) {}); });
+    throws([](Writer& w) {
+        Instr I{};
+        I.op = Opcode::MEASURE;
+        I.a = 0;
+        I.has_aux = true;
+        I.aux_u32 = UINT32_MAX;
+        w.append(I);
+    });
+
+    // INT32_MAX itself is accepted
+    Writer w;
+    w.x(uint32_t(INT32_MAX));
+    CHECK(w.num_qubits() == uint32_t(INT32_MAX) + 1u);
+}
+
+int main(int, char**) {
+    test_qasm_identity();
+    test_typed_matches_append();
+    test_move_and_reuse();
+    test_index_range();
+
+    if (failures) { std::fprintf(stderr, "%d check(s) failed\n", failures); return 1; }
+    std::printf("OK - writer\n");
+    return 0;
+}
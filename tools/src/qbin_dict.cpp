@@ -0,0 +1,170 @@
+// qbin_dict.cpp - qbin-dict: train zstd dictionaries for CPRS from a QBIN corpus
+
+#include "qbin_compiler/compress.hpp"
+#include "qbin_decompiler/compression.hpp"
+#include "qbin_decompiler/reader.hpp"
+
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+namespace fs = std::filesystem;
+
+static const size_t kDefaultDictSize = 16 * 1024;
+
+static void print_usage(const char* argv0) {
+    std::cerr
+        << "Usage:\n"
+        << "  " << argv0 << " train -o <out.dict> [--size <bytes>] [--verbose] <file.qbin|dir>...\n"
+        << "  " << argv0 << " info <file.dict>\n"
+        << "\n"
+        << "train  builds a zstd dictionary from the PARS/GATE/INST payloads of the\n"
+        << "       corpus (directories are searched for *.qbin). Compile the corpus with\n"
+        << "       the flags the dictionary will be used with (e.g. --delta-operands),\n"
+        << "       then pass it to qbin-compile --dict and qbin-decompile --dict.\n"
+        << "info   prints the dictionary id and size.\n"
+        << "\n"
+        << "Options:\n"
+        << "  --size <bytes>  maximum dictionary size (default 16384)\n"
+        << "  --verbose       list the files and samples used\n";
+}
+
+static bool read_file(const std::string& path, std::vector<uint8_t>& out) {
+    std::ifstream f(path, std::ios::binary);
+    if (!f) return false;
+    out.assign(std::istreambuf_iterator<char>(f), std::istreambuf_iterator<char>());
+    return true;
+}
+
+// Stored (uncompressed) payloads of the sections the compiler compresses.
+static bool collect_samples(const std::string& path, std::vector<std::vector<uint8_t>>& samples,
+    std::string& err) {
+    std::vector<uint8_t> buf;
+    if (!read_file(path, buf)) { err = "cannot read " + path; return false; }
+    uint8_t major = 0, minor = 0;
+    uint32_t table_off = 0, table_size = 0;
+    std::vector<qbin_decompiler::SectionEntry> table;
+    if (!qbin_decompiler::decode_header_and_table(buf.data(), buf.size(), major, minor, table_off, table_size, table, err)) {
+        err = path + ": " + err;
+        return false;
+    }
+    for (const auto& e : table) {
+        if (e.id != qbin_decompiler::section_id("PARS") && e.id != qbin_decompiler::section_id("GATE") &&
+            e.id != qbin_decompiler::section_id("INST")) {
+            continue;
+        }
+        if (e.flags & qbin_decompiler::kSectionCompressed) {
+            // Only dictionary-less frames can be inflated here
+            std::vector<uint8_t> raw;
+            std::string derr;
+            if (qbin_decompiler::find_section(table, qbin_decompiler::section_id("CPRS")) ||
+                !qbin_decompiler::decompress_section(buf.data(), buf.size(), e.offset, e.size, nullptr, nullptr, raw, derr)) {
+                continue;
+            }
+            samples.push_back(std::move(raw));
+        }
+        else {
+            samples.emplace_back(buf.begin() + e.offset, buf.begin() + e.offset + e.size);
+        }
+    }
+    return true;
+}
+
+static int cmd_train(int argc, char** argv) {
+    std::string out_path;
+    size_t capacity = kDefaultDictSize;
+    bool verbose = false;
+    std::vector<std::string> inputs;
+    for (int i = 2; i < argc; ++i) {
+        std::string a = argv[i];
+        if (a == "-o" && i + 1 < argc) out_path = argv[++i];
+        else if (a == "--size" && i + 1 < argc) {
+            char* end = nullptr;
+            const unsigned long long v = std::strtoull(argv[++i], &end, 10);
+            if (!end || *end != '\0' || v < 256 || v > (64u << 20)) {
+                std::cerr << "Invalid dictionary size: " << argv[i] << " (256..67108864)\n";
+                return 1;
+            }
+            capacity = size_t(v);
+        }
+        else if (a == "--verbose" || a == "-v") verbose = true;
+        else if (!a.empty() && a[0] == '-') { std::cerr << "Unknown option: " << a << "\n"; return 1; }
+        else inputs.push_back(a);
+    }
+    if (out_path.empty() || inputs.empty()) { print_usage(argv[0]); return 1; }
+
+    std::vector<std::string> files;
+    for (const auto& in : inputs) {
+        std::error_code ec;
+        if (fs::is_directory(in, ec)) {
+            for (auto it = fs::recursive_directory_iterator(in, ec); !ec && it != fs::recursive_directory_iterator(); it.increment(ec)) {
+                if (it->is_regular_file(ec) && it->path().extension() == ".qbin") files.push_back(it->path().string());
+            }
+        }
+        else {
+            files.push_back(in);
+        }
+    }
+
+    std::vector<std::vector<uint8_t>> samples;
+    size_t skipped = 0;
+    for (const auto& f : files) {
+        std::string err;
+        const size_t before = samples.size();
+        if (!collect_samples(f, samples, err)) {
+            std::cerr << "Warning: " << err << " (skipped)\n";
+            ++skipped;
+            continue;
+        }
+        if (verbose) std::fprintf(stderr, "  %s: %zu samples\n", f.c_str(), samples.size() - before);
+    }
+    size_t sample_bytes = 0;
+    for (const auto& s : samples) sample_bytes += s.size();
+
+    std::vector<uint8_t> dict;
+    std::string err;
+    if (!qbin_compiler::enc::train_dictionary(samples, capacity, dict, err)) {
+        std::cerr << "Error: " << err << " (" << samples.size() << " samples, " << sample_bytes << " bytes)\n";
+        return 1;
+    }
+    std::ofstream ofs(out_path, std::ios::binary);
+    ofs.write(reinterpret_cast<const char*>(dict.data()), static_cast<std::streamsize>(dict.size()));
+    if (!ofs) { std::cerr << "Error: cannot write " << out_path << "\n"; return 1; }
+
+    std::printf("files:      %zu (%zu skipped)\n", files.size() - skipped, skipped);
+    std::printf("samples:    %zu (%zu bytes)\n", samples.size(), sample_bytes);
+    std::printf("dictionary: %s, %zu bytes, id %u\n", out_path.c_str(), dict.size(),
+        qbin_compiler::enc::dict_id(dict.data(), dict.size()));
+    return 0;
+}
+
+static int cmd_info(int argc, char** argv) {
+    if (argc != 3) { print_usage(argv[0]); return 1; }
+    std::vector<uint8_t> dict;
+    if (!read_file(argv[2], dict)) { std::cerr << "Error: cannot read " << argv[2] << "\n"; return 1; }
+    const uint32_t id = qbin_decompiler::zstd_dict_id(dict.data(), dict.size());
+    if (id == 0) { std::cerr << "Error: " << argv[2] << " is not a zstd dictionary\n"; return 1; }
+    std::printf("dictionary: %s\nsize:       %zu bytes\nid:         %u\n", argv[2], dict.size(), id);
+    return 0;
+}
+
+int main(int argc, char** argv) {
+    if (argc < 2) { print_usage(argv[0]); return 1; }
+    const std::string cmd = argv[1];
+    if (cmd == "train") {
+        if (!qbin_compiler::enc::zstd_available()) {
+            std::cerr << "Error: this qbin-dict was built without zstd.\n";
+            return 1;
+        }
+        return cmd_train(argc, argv);
+    }
+    if (cmd == "info") return cmd_info(argc, argv);
+    print_usage(argv[0]);
+    return 1;
+}